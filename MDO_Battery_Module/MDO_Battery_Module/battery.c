@@ -0,0 +1,170 @@
+/*
+ * battery.c
+ *
+ * Created: 10/19/2026 8:29:25 AM
+ */ 
+
+#include "battery.h"
+
+INSTANCE_LOCAL Bat_config_t bat_config = {
+	#ifdef I2C_DEBUG
+		true,
+	#else
+		false,
+	#endif
+	BAT_HIB_SCHEDULE,
+};
+
+
+#ifdef I2C_TARGET
+// refresh host visible register file
+static void bat_updateTarget(void) {
+	max_readFuelGauge();
+	#ifdef SBS_EMULATION
+		max_sbsUpdate();
+	#else
+		max_targetUpdate();
+	#endif
+}
+#endif
+
+
+// Power on reset has occured, reload configuration
+// Level triggered, max_loadConfig() clears POR when done
+static void bat_onGaugePOR(uint16_t bits, uint16_t status) {
+	(void)bits;
+	(void)status;
+	max_loadConfig();
+}
+
+
+/***********************************************************
+ *
+ * Power, bus and clock bring up. All peripherals gated,
+ * TWI only powered for gauge access. Startup is bus
+ * limited so it runs at the reduced clock.
+ *
+ * Select the cell profile next, then call bat_start()
+ *
+ * @param fscl : SCL frequency for gauge bus
+ *
+ ***********************************************************/
+void bat_init(uint32_t fscl) {
+	pwr_init();
+	pwr_twiEnable();
+	i2c_init(F_CPU, fscl);
+	tb_init(F_CPU);
+	tb_start();
+	clk_set(CLK_DIV_I2C);
+}
+
+
+/***********************************************************
+ *
+ * Load configuration into the gauge and register the POR
+ * handler, then hand the bus to target mode when built
+ * with I2C_TARGET. TWI is gated on return.
+ *
+ ***********************************************************/
+void bat_start(void) {
+	
+	#ifdef I2C_DEBUG
+		if (bat_config.debug)
+			max_debugWrite(DEBUG_ADDR, DEBUG_STARTUP_CODE);
+	#endif
+	
+	max_loadConfig();
+	max_statusOn(POR, MAX_STATUS_LEVEL, bat_onGaugePOR);
+	
+	#ifdef I2C_DEBUG
+		if (bat_config.debug)
+			max_debugWrite(DEBUG_ADDR, DEBUG_DONE_STARTUP_CODE);
+	#endif
+	
+	#ifdef CLK_BENCHMARK
+		clk_benchmark(bat_process, DEBUG_ADDR);
+	#endif
+	
+	#ifdef I2C_TARGET
+		#ifdef I2C_TARGET_PEC
+			i2c_target_setPEC(true);
+		#endif
+		bat_updateTarget();
+		i2c_target_init(I2C_TARGET_ADDR, max_target_regs, MAX_TARGET_REGS);
+	#endif
+	
+	pwr_twiDisable();
+}
+
+
+/***********************************************************
+ *
+ * Gauge housekeeping, once per wake with TWI powered
+ *
+ ***********************************************************/
+void bat_process(void) {
+	
+	// cache lifetime follows gauge hibernate state
+	max_cacheSyncHibernate();
+	
+	// Status read once, handlers dispatched from here
+	max_statusPoll();
+	
+	// gauge hibernate profile follows load
+	if (bat_config.hib_profile == BAT_HIB_SCHEDULE)
+		max_hibSchedule();
+	else if (max_hibProfile() != bat_config.hib_profile)
+		max_selectHibProfile(bat_config.hib_profile);
+	
+	// Save learned parameters
+	// When bit 6 of Cycles Reg has toggled
+	if (max_checkCycles())
+		max_saveLearnedParameters();
+	
+	#ifdef I2C_TARGET
+		bat_updateTarget();
+	#endif
+	
+	#ifdef I2C_DEBUG
+		if (bat_config.debug) {
+			max_readFuelGauge();
+			max_debugDataStruct();
+			max_debugSnapshot();
+			max_debugEEPROM();
+			pwr_debugStats(DEBUG_ADDR);
+			i2c_stats_debug(DEBUG_ADDR);
+		}
+	#endif
+}
+
+
+/***********************************************************
+ *
+ * Processing wake. Bus limited, core clock dropped and
+ * TWI powered only around bat_process()
+ *
+ ***********************************************************/
+void bat_wake(void) {
+	clk_set(CLK_DIV_I2C);
+	tb_start();
+	pwr_twiEnable();
+	bat_process();
+	pwr_twiDisable();
+}
+
+
+/***********************************************************
+ *
+ * Ready for power down. Queued EEPROM writes finish in
+ * idle first, EE_READY cannot wake from power down.
+ * Target mode needs fcpu >= 16 * fscl to answer host.
+ *
+ ***********************************************************/
+void bat_idle(void) {
+	if (ee_busy()) {
+		clk_set(i2c_target_enabled() ? CLK_DIV_I2C : CLK_DIV_EEPROM);
+		ee_flush();
+	}
+	clk_set(clock_div_1);
+	tb_stop();
+}
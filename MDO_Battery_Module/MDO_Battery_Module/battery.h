@@ -0,0 +1,47 @@
+/*
+ * battery.h
+ *
+ * Created: 10/19/2026 8:29:25 AM
+ *
+ * Boot sequence and per wake processing shared by main()
+ * and the host simulator (host/sim), so both run the
+ * same code around the gauge driver.
+ */ 
+
+
+#ifndef BATTERY_H_
+#define BATTERY_H_
+
+#ifndef F_CPU
+#define F_CPU 8000000UL
+#endif
+
+#include "stdbool.h"
+
+#include "i2c.h"
+#include "max17263.h"
+#include "eeprom_queue.h"
+#include "power_mgmt.h"
+#include "timebase.h"
+#include "clock.h"
+#include "sbs.h"
+#include "i2c_stats.h"
+
+// bat_config.hib_profile, profile follows load
+#define BAT_HIB_SCHEDULE	0xFF
+
+// Run time settings, defaults match the build flags
+typedef struct bat_config_t{
+	bool debug;				// I2C_DEBUG frames each wake
+	uint8_t hib_profile;	// fixed MAX_HIB_*, BAT_HIB_SCHEDULE from load
+}Bat_config_t;
+
+extern INSTANCE_LOCAL Bat_config_t bat_config;
+
+void bat_init(uint32_t fscl);
+void bat_start(void);
+void bat_process(void);
+void bat_wake(void);
+void bat_idle(void);
+
+#endif /* BATTERY_H_ */
@@ -0,0 +1,25 @@
+/*
+ * cell_model.c
+ *
+ * Created: 10/19/2026 8:00:34 AM
+ */ 
+
+
+#include "avr/pgmspace.h"
+#include "max17263.h"
+
+
+// Characterised model for the pack cell, copied word for
+// word from the cell characterisation INI:
+//   table   : model data 0x80 - 0xAF
+//   RCOMP0, TempCo, QRTable00 - QRTable30
+// Empty (id 0) until the INI for our cell is in, the
+// loader then reports MAX_MODEL_ERR_EMPTY and EZ config
+// is used. Enable with MAX_CUSTOM_MODEL in max17263.h.
+const Max17263_model_t cell_model PROGMEM = {
+	.id		= 0x0000,
+	.table	= { 0 },
+	.RCOMP0	= 0x0000,
+	.TempCo	= 0x0000,
+	.QRTable = { 0x0000, 0x0000, 0x0000, 0x0000 },
+};
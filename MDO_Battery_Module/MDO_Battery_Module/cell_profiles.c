@@ -0,0 +1,70 @@
+/*
+ * cell_profiles.c
+ *
+ * Created: 10/19/2026 8:03:02 AM
+ */ 
+
+
+#include "stddef.h"
+#include "avr/pgmspace.h"
+#include "max17263.h"
+
+
+#ifdef MAX_CUSTOM_MODEL
+	#define CELL_MODEL	&cell_model
+#else
+	#define CELL_MODEL	NULL
+#endif
+
+// LED driver as set up for every SKU: 4 bars, charge
+// indicator, push button with 1.3s timer, full brightness
+#define CELL_LEDCFG1	MAX_LEDCFG1(4, 1, 1, LED_MODE_PUSH_BUTTON_TIMER, LED_ANI_MODE_OFF, 0, LED_TIME_1300MS)
+#define CELL_LEDCFG2	(LEDCfg2_DEFAULT | LED_MAX_BRIGHTNESS)
+
+
+// One entry per cell variant, selected at boot by the
+// index at EEPROM_Profile_ADDR. Entry 0 is the default
+// for unprogrammed boards.
+const Max17263_profile_t cell_profiles[] PROGMEM = {
+	
+	// 0: 1200mAh, 10mOhm sense, 100mA termination
+	{
+		.rsense		= 10,
+		.DesignCap	= MAX_DESIGNCAP(1200, 10),
+		.IChgTerm	= MAX_ICHGTERM(100, 10),
+		.VEmpty		= VEmpty_DEFAULT,
+		.ModelCfg	= ModelCfg_DEFAULT,
+		.LEDCfg1	= CELL_LEDCFG1,
+		.LEDCfg2	= CELL_LEDCFG2,
+		.LEDCfg3	= LEDCfg3_DEFAULT,
+		.model		= CELL_MODEL,
+	},
+	
+	// 1: 2500mAh, 10mOhm sense, 150mA termination
+	{
+		.rsense		= 10,
+		.DesignCap	= MAX_DESIGNCAP(2500, 10),
+		.IChgTerm	= MAX_ICHGTERM(150, 10),
+		.VEmpty		= VEmpty_DEFAULT,
+		.ModelCfg	= ModelCfg_DEFAULT,
+		.LEDCfg1	= CELL_LEDCFG1,
+		.LEDCfg2	= CELL_LEDCFG2,
+		.LEDCfg3	= LEDCfg3_DEFAULT,
+		.model		= NULL,
+	},
+	
+	// 2: 3400mAh, 5mOhm sense, 200mA termination
+	{
+		.rsense		= 5,
+		.DesignCap	= MAX_DESIGNCAP(3400, 5),
+		.IChgTerm	= MAX_ICHGTERM(200, 5),
+		.VEmpty		= VEmpty_DEFAULT,
+		.ModelCfg	= ModelCfg_DEFAULT,
+		.LEDCfg1	= CELL_LEDCFG1,
+		.LEDCfg2	= CELL_LEDCFG2,
+		.LEDCfg3	= LEDCfg3_DEFAULT,
+		.model		= NULL,
+	},
+};
+
+const uint8_t cell_profile_count = sizeof(cell_profiles) / sizeof(cell_profiles[0]);
@@ -0,0 +1,151 @@
+/*
+ * clock.c
+ *
+ * Created: 10/19/2026 7:16:56 AM
+ */ 
+
+#include "clock.h"
+
+
+/***********************************************************
+ *
+ * Change core clock prescaler (CLKPR timed sequence)
+ * TWI bit rate and Timer0 tick are recomputed for the
+ * new clock so bus speed and delays are unaffected.
+ * The prescaler is read back from CLKPR, no copy is
+ * kept that could disagree with the hardware.
+ *
+ * @param div : clock_div_1 ... clock_div_256
+ *
+ ***********************************************************/
+void clk_set(clock_div_t div) {
+	if (div == clock_prescale_get()) {
+		return;
+	}
+	clock_prescale_set(div);
+	i2c_setCPUClock(clk_getHz());
+	tb_init(clk_getHz());
+}
+
+
+/***********************************************************
+ *
+ * Current clock prescaler
+ *
+ ***********************************************************/
+clock_div_t clk_get(void) {
+	return clock_prescale_get();
+}
+
+
+/***********************************************************
+ *
+ * Current core clock in Hz
+ *
+ ***********************************************************/
+uint32_t clk_getHz(void) {
+	return (F_CPU >> clock_prescale_get());
+}
+
+
+#ifdef CLK_BENCHMARK
+
+// Typical active supply current (uA) @ 3.3V per divider,
+// ATmega32U4 datasheet active current vs frequency.
+// Replace with bench measurements for the target board.
+static const uint16_t clk_active_uA[] = {
+	3800,	// 8MHz
+	2100,	// 4MHz
+	1200,	// 2MHz
+	700,	// 1MHz
+};
+
+// Timer1 wraps every 65536 counts (524ms at 8MHz, clk/64)
+static volatile uint16_t clk_overflows;
+
+
+/***********************************************************
+ *
+ * Timer1 overflow, extends the benchmark count past
+ * 16 bits
+ *
+ ***********************************************************/
+ISR(TIMER1_OVF_vect) {
+	clk_overflows++;
+}
+
+
+/***********************************************************
+ *
+ * Runs fn at 8, 4, 2 and 1MHz, measuring elapsed time
+ * with Timer1 (clk/64) plus its overflow count. An
+ * overflow still pending once the timer is stopped was
+ * not counted (fn ran with interrupts off), that run is
+ * rejected and sent as CLK_BENCH_INVALID. Energy is
+ * not measured, it is
+ * elapsed time times the clk_active_uA[] table and only
+ * as good as that table. One frame per setting is sent
+ * to receiver:
+ * 1 -> code
+ * 2 -> clock divider
+ * 3 -> elapsed us (LSW, MSW), measured
+ * 4 -> estimated energy nJ (LSW, MSW)
+ *
+ * @param fn   : workload, normally bat_process()
+ * @param addr : i2c address for receiver
+ *
+ ***********************************************************/
+void clk_benchmark(void (*fn)(void), uint8_t addr) {
+	
+	clock_div_t restore = clk_get();
+	
+	for (uint8_t div = clock_div_1; div <= clock_div_8; div++) {
+		
+		clk_set((clock_div_t)div);
+		
+		power_timer1_enable();
+		TCCR1A = 0;
+		TCNT1  = 0;
+		clk_overflows = 0;
+		TIFR1  = _BV(TOV1);
+		TIMSK1 = _BV(TOIE1);
+		TCCR1B = _BV(CS11) | _BV(CS10);	// clk/64
+		
+		fn();
+		
+		TCCR1B = 0;		// stop first, count and flag can't move
+		TIMSK1 = 0;
+		uint32_t counts = ((uint32_t)clk_overflows << 16) | TCNT1;
+		bool lost = (TIFR1 & _BV(TOV1));
+		TIFR1 = _BV(TOV1);
+		power_timer1_disable();
+		
+		uint32_t us = CLK_BENCH_INVALID;
+		uint32_t nJ = CLK_BENCH_INVALID;
+		
+		if (!lost) {
+			// counts * 64 / fcpu, in us
+			us = (counts * 64UL) / (clk_getHz() / 1000000UL);
+			uint32_t uW = (uint32_t)clk_active_uA[div] * CLK_VCC_MV / 1000UL;
+			nJ = (uW / 10) * (us / 100);	// estimate, split to stay in 32 bits
+		}
+		
+		uint8_t buffer[12];
+		uint16_t data[] = {
+			DEBUG_CLOCK_BENCH_CODE, div,
+			(uint16_t)(us & 0xFFFF), (uint16_t)(us >> 16),
+			(uint16_t)(nJ & 0xFFFF), (uint16_t)(nJ >> 16)
+		};
+		
+		for(uint8_t i = 0; i < 12; i+=2) {
+			buffer[i] = (uint8_t)(data[i/2] & 0x00FF);
+			buffer[i+1] = (uint8_t)((data[i/2] >> 8) & 0x00FF);
+		}
+		
+		i2c_controller_transmit(addr, buffer, 12, I2C_NO_REPEAT);
+	}
+	
+	clk_set(restore);
+}
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ * clock.h
+ *
+ * Created: 10/19/2026 7:16:56 AM
+ */ 
+
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#ifndef F_CPU
+#define F_CPU 8000000UL
+#endif
+
+#include "avr/io.h"
+#include "avr/power.h"
+#include "avr/interrupt.h"
+
+#include "i2c.h"
+#include "timebase.h"
+
+// Benchmark bat_process() at each clock setting
+#define CLK_BENCHMARK
+#undef  CLK_BENCHMARK
+
+// Core clock while bus limited (2MHz, TWBR = 2 @ 100kHz)
+#define CLK_DIV_I2C			clock_div_4
+
+// Core clock while idling on EEPROM programming
+#define CLK_DIV_EEPROM		clock_div_64
+
+// Supply voltage for energy estimates
+#define CLK_VCC_MV			3300UL
+
+// Benchmark time/energy sent for a run whose Timer1
+// overflow could not be counted
+#define CLK_BENCH_INVALID	0xFFFFFFFFUL
+
+// Debug parsing code
+#define DEBUG_CLOCK_BENCH_CODE	0xEEFF
+
+void clk_set(clock_div_t div);
+clock_div_t clk_get(void);
+uint32_t clk_getHz(void);
+void clk_benchmark(void (*fn)(void), uint8_t addr);
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,169 @@
+/*
+ * eeprom_queue.c
+ *
+ * Created: 10/19/2026 7:14:18 AM
+ */ 
+
+#include "eeprom_queue.h"
+#include "i2c.h"
+
+
+// Queued byte write
+typedef struct {
+	uint16_t addr;
+	uint8_t  data;
+}ee_entry_t;
+
+static INSTANCE_LOCAL ee_entry_t ee_queue[EE_QUEUE_SIZE];
+static INSTANCE_LOCAL volatile uint8_t ee_head = 0;	// written by foreground only
+static INSTANCE_LOCAL volatile uint8_t ee_tail = 0;	// written by EE_READY ISR only
+
+
+/***********************************************************
+ *
+ * EEPROM ready interrupt, fires whenever EEPE is clear
+ * Pops queued bytes until one differs from the stored
+ * value, then starts its erase/write and returns. The
+ * interrupt disables itself once the queue is empty, so
+ * EERIE doubles as the busy flag.
+ *
+ ***********************************************************/
+ISR(EE_READY_vect) {
+	
+	while (ee_tail != ee_head) {
+		
+		ee_entry_t* entry = &ee_queue[ee_tail];
+		ee_tail = (ee_tail + 1) & EE_QUEUE_MASK;
+		
+		// read current value, skip write on match
+		EEAR = entry->addr;
+		EECR |= _BV(EERE);
+		if (EEDR == entry->data) {
+			continue;
+		}
+		
+		// atomic erase + write (EEPM = 0)
+		EEDR = entry->data;
+		EECR = _BV(EERIE) | _BV(EEMPE);
+		EECR |= _BV(EEPE);
+		return;
+	}
+	
+	// queue drained
+	EECR &= ~_BV(EERIE);
+}
+
+
+/***********************************************************
+ *
+ * Queue a single byte to be written to EEPROM
+ * Sleeps in idle mode while the queue is full
+ *
+ * @param addr : eeprom byte address
+ * @param data : byte to write
+ *
+ ***********************************************************/
+void ee_writeByte(uint16_t addr, uint8_t data) {
+	
+	uint8_t next = (ee_head + 1) & EE_QUEUE_MASK;
+	
+	// wait for ISR to free a slot
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	cli();
+	while (next == ee_tail) {
+		sleep_enable();
+		sei();
+		sleep_cpu();
+		sleep_disable();
+		cli();
+	}
+	
+	ee_queue[ee_head].addr = addr;
+	ee_queue[ee_head].data = data;
+	ee_head = next;
+	
+	// start servicing, EE_READY fires as soon as EEPE clears
+	EECR |= _BV(EERIE);
+	sei();
+}
+
+
+/***********************************************************
+ *
+ * Queue a word to be written to EEPROM
+ * Bytes only programmed if they differ from stored data,
+ * same behaviour as eeprom_update_word()
+ *
+ * @param addr : eeprom byte address of LSB
+ * @param data : word to write
+ *
+ ***********************************************************/
+void ee_writeWord(uint16_t addr, uint16_t data) {
+	ee_writeByte(addr, (uint8_t)(data & 0x00FF));
+	ee_writeByte(addr + 1, (uint8_t)((data >> 8) & 0x00FF));
+}
+
+
+/***********************************************************
+ *
+ * Read word from EEPROM
+ * Waits for queued writes first, the ISR owns EEAR/EEDR
+ * while the queue is active
+ *
+ * @param addr : eeprom byte address of LSB
+ *
+ * @returns    : stored word
+ *
+ ***********************************************************/
+uint16_t ee_readWord(uint16_t addr) {
+	ee_flush();
+	return eeprom_read_word((uint16_t *)(uintptr_t)addr);
+}
+
+
+/***********************************************************
+ *
+ * Drop queued writes, queue as after reset. A byte
+ * already being programmed is left to complete.
+ *
+ ***********************************************************/
+void ee_reset(void) {
+	uint8_t sreg = SREG;
+	cli();
+	ee_head = ee_tail;
+	EECR &= ~_BV(EERIE);
+	SREG = sreg;
+}
+
+
+/***********************************************************
+ *
+ * Check for pending or in progress EEPROM writes
+ *
+ * @returns : true while queue is being serviced
+ *
+ ***********************************************************/
+bool ee_busy(void) {
+	return (EECR & _BV(EERIE)) != 0;
+}
+
+
+/***********************************************************
+ *
+ * Sleep in idle mode until all queued writes complete
+ * EE_READY cannot wake from power down, call before
+ * entering SLEEP_MODE_PWR_DOWN
+ *
+ ***********************************************************/
+void ee_flush(void) {
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	cli();
+	while (EECR & _BV(EERIE)) {
+		sleep_enable();
+		sei();			// sleep_cpu executes before any pending ISR
+		sleep_cpu();
+		sleep_disable();
+		cli();
+	}
+	sei();
+}
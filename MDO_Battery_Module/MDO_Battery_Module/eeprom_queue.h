@@ -0,0 +1,28 @@
+/*
+ * eeprom_queue.h
+ *
+ * Created: 10/19/2026 7:14:18 AM
+ */ 
+
+
+#ifndef EEPROM_QUEUE_H_
+#define EEPROM_QUEUE_H_
+
+#include "stdbool.h"
+#include "avr/io.h"
+#include "avr/eeprom.h"
+#include "avr/sleep.h"
+#include "avr/interrupt.h"
+
+// Pending byte writes, must be power of 2
+#define EE_QUEUE_SIZE	16
+#define EE_QUEUE_MASK	(EE_QUEUE_SIZE - 1)
+
+void ee_writeByte(uint16_t addr, uint8_t data);
+void ee_writeWord(uint16_t addr, uint16_t data);
+uint16_t ee_readWord(uint16_t addr);
+void ee_reset(void);
+bool ee_busy(void);
+void ee_flush(void);
+
+#endif /* EEPROM_QUEUE_H_ */
@@ -6,33 +6,199 @@
  */ 
 
 #include "i2c.h"
+#include "i2c_stats.h"
+#include "timebase.h"
+
+// last settings passed to i2c_init()
+static INSTANCE_LOCAL uint32_t i2c_fcpu = 0;
+static INSTANCE_LOCAL uint32_t i2c_fscl = 0;
+
+// target mode register file
+static INSTANCE_LOCAL volatile uint16_t* i2c_target_regs = 0;
+static INSTANCE_LOCAL uint8_t i2c_target_count = 0;
+static INSTANCE_LOCAL volatile uint8_t i2c_target_cmd = 0;		// command byte (word index)
+static INSTANCE_LOCAL volatile uint8_t i2c_target_byte = 0;	// byte position in transfer
+static INSTANCE_LOCAL volatile uint16_t i2c_target_latch = 0;	// word being transmitted
+static INSTANCE_LOCAL volatile bool i2c_target_active = false;	// addressed, until STOP/NACK
+static INSTANCE_LOCAL volatile uint8_t i2c_target_crc = 0;		// running PEC of host transfer
+static INSTANCE_LOCAL volatile bool i2c_target_wrote = false;	// command written, PEC continues
+static INSTANCE_LOCAL bool i2c_target_pec = false;
+
+// retry policy for i2c_controller_transfer()
+static INSTANCE_LOCAL I2c_retry_t i2c_retry = {
+	I2C_RETRY_ATTEMPTS, I2C_RETRY_BACKOFF_MS, I2C_RETRY_BACKOFF_MAX_MS, I2C_RETRY_MASK
+};
+
+// transaction trace, 0 when not recording
+static INSTANCE_LOCAL I2c_trace_hook_t i2c_trace_hook = 0;
+
+// SMBus packet error checking
+static INSTANCE_LOCAL uint8_t i2c_pec_addrs[16];	// bitmap of targets using PEC
+static INSTANCE_LOCAL uint8_t i2c_crc = 0;			// running PEC of controller transaction
+
+static void i2c_reset(void);
+
+// CRC-8, x^8 + x^2 + x + 1 (SMBus PEC)
+static const uint8_t i2c_crc8_table[256] PROGMEM = {
+	0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+	0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65, 0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
+	0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+	0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
+	0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2, 0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
+	0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+	0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
+	0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42, 0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
+	0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+	0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
+	0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C, 0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
+	0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+	0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
+	0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B, 0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
+	0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+	0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3
+};
+
+
+/***********************************************************
+ *
+ * Update SMBus PEC with one byte
+ *
+ * @param crc  : running crc, 0 at start of transaction
+ * @param data : byte on the wire (address bytes included)
+ *
+ ***********************************************************/
+uint8_t i2c_crc8(uint8_t crc, uint8_t data) {
+	return pgm_read_byte(&i2c_crc8_table[crc ^ data]);
+}
+
+
+/***********************************************************
+ *
+ * TW_STATUS as error code, bus error (0x00) remapped so
+ * 0 always means success
+ *
+ ***********************************************************/
+static uint8_t i2c_status(void) {
+	uint8_t status = TW_STATUS;
+	return (status == TW_BUS_ERROR) ? I2C_ERR_BUS : status;
+}
+
+
+/***********************************************************
+ *
+ * Wait for TWINT with bounded spin, a held SCL (target
+ * stretching forever, stuck bus) no longer hangs the core
+ *
+ * @returns : 0 when TWINT set, I2C_ERR_TIMEOUT otherwise
+ *
+ ***********************************************************/
+static uint8_t i2c_wait(void) {
+	uint16_t loops = I2C_TIMEOUT_LOOPS;
+	while (!(TWCR & (1 << TWINT))) {
+		if (--loops == 0) {
+			return I2C_ERR_TIMEOUT;
+		}
+	}
+	return 0;
+}
 
 
 /***********************************************************
  *
  * Initiate I2C peripheral
  * fscl = fcpu / (16 + 2(TWBR) * 4^TWPS)
+ * Clamps to fcpu / 16 when fcpu is too slow for fscl
  *
  * @param fcpu : CPU clock speed
  * @param fscl : Desired I2C clock speed
  *
  ***********************************************************/
 void i2c_init(uint32_t fcpu, uint32_t fscl) {
+	i2c_fcpu = fcpu;
+	i2c_fscl = fscl;
 	TWSR = 0x00;
-	TWBR = (((fcpu/fscl) - 16) / 2);
+	if ((fcpu/fscl) <= 16) {
+		TWBR = 0;
+	}
+	else {
+		TWBR = (((fcpu/fscl) - 16) / 2);
+	}
+}
+
+
+/***********************************************************
+ *
+ * Reload bit rate after TWI has been power gated
+ * Does nothing before first call to i2c_init()
+ *
+ ***********************************************************/
+void i2c_resume(void) {
+	if (i2c_fscl != 0) {
+		i2c_init(i2c_fcpu, i2c_fscl);
+	}
+}
+
+
+/***********************************************************
+ *
+ * Recompute bit rate after CPU clock prescaler change
+ * Keeps last requested fscl
+ *
+ * @param fcpu : new CPU clock speed
+ *
+ ***********************************************************/
+void i2c_setCPUClock(uint32_t fcpu) {
+	i2c_fcpu = fcpu;
+	i2c_resume();
 }
 
 
 /***********************************************************
  *
  * Disable I2C peripheral
+ * Stays enabled while serving as target
  *
  ***********************************************************/
 void i2c_disable(void) {
+	if (i2c_target_regs != 0) {
+		return;
+	}
 	TWCR &= ~(1 << TWEN);
 }
 
 
+/***********************************************************
+ *
+ * Enable/disable SMBus PEC for transactions with a target
+ * Controller appends PEC to writes and verifies PEC
+ * after reads for these addresses
+ *
+ * @param addr : target device address
+ * @param en   : use PEC
+ *
+ ***********************************************************/
+void i2c_setPEC(uint8_t addr, bool en) {
+	addr &= 0x7F;
+	if (en) {
+		i2c_pec_addrs[addr >> 3] |= (1 << (addr & 0x07));
+	}
+	else {
+		i2c_pec_addrs[addr >> 3] &= ~(1 << (addr & 0x07));
+	}
+}
+
+
+/***********************************************************
+ *
+ * Check PEC setting for target
+ *
+ ***********************************************************/
+bool i2c_pecEnabled(uint8_t addr) {
+	addr &= 0x7F;
+	return (i2c_pec_addrs[addr >> 3] & (1 << (addr & 0x07))) != 0;
+}
+
+
 /***********************************************************
  *
  * Send start condition and address target for read/write
@@ -43,24 +209,54 @@ void i2c_disable(void) {
  ***********************************************************/
 uint8_t i2c_start(uint8_t addr, uint8_t dir) {
 	
+	// let a host read in progress finish first, START
+	// clears TWIE so the target ISR stays out until STOP.
+	// A host that never sends STOP/NACK is dropped, target
+	// state cleared and address recognition re-armed.
+	uint8_t sreg = SREG;
+	uint16_t loops = I2C_TIMEOUT_LOOPS;
+	do {
+		SREG = sreg;
+		while (i2c_target_active) {
+			if (--loops == 0) {
+				cli();
+				i2c_target_active = false;
+				i2c_target_wrote = false;
+				i2c_reset();
+				SREG = sreg;
+				return I2C_ERR_TIMEOUT;
+			}
+		}
+		cli();
+	} while (i2c_target_active);
+	
 	// send START condition, wait for complete
 	TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
-	while (!(TWCR & (1 << TWINT)));
+	SREG = sreg;
+	if (i2c_wait() != 0) {
+		return I2C_ERR_TIMEOUT;
+	}
   
-	// check status reg
-	if ((TW_STATUS != TW_START) && (TW_STATUS != TW_REP_START)) {
-		return TW_STATUS;
+	// check status reg, PEC spans repeated starts
+	if (TW_STATUS == TW_START) {
+		i2c_crc = 0;
+	}
+	else if (TW_STATUS != TW_REP_START) {
+		return i2c_status();
 	}
 
 	// load address + r/w, start transmission
 	TWDR = (addr << 1) | dir;
 	TWCR = (1 << TWINT) | (1 << TWEN);
-	while (!(TWCR & (1 << TWINT)));
+	if (i2c_wait() != 0) {
+		return I2C_ERR_TIMEOUT;
+	}
 	
 	// check status reg for ACK
 	if ((TW_STATUS != TW_MT_SLA_ACK) && (TW_STATUS != TW_MR_SLA_ACK)) {
-		return TW_STATUS;
+		return i2c_status();
 	}
+	i2c_crc = i2c_crc8(i2c_crc, (addr << 1) | dir);
 	return 0;
 }
 
@@ -77,12 +273,15 @@ uint8_t i2c_write (uint8_t data) {
 	// load data, start transmission
 	TWDR = data;
 	TWCR = (1 << TWINT)|(1 << TWEN);
-	while (!(TWCR & (1 << TWINT)));
+	if (i2c_wait() != 0) {
+		return I2C_ERR_TIMEOUT;
+	}
 		
 	// check status reg for ACK
 	if (TW_STATUS != TW_MT_DATA_ACK) {
-		return TW_STATUS;
+		return i2c_status();
 	}
+	i2c_crc = i2c_crc8(i2c_crc, data);
 	return 0; 	
 }
 
@@ -91,19 +290,26 @@ uint8_t i2c_write (uint8_t data) {
  *
  * Read target device with ACK
  *
+ * @param data : received byte, untouched on error
+ *
+ * @returns    : 0 on success, otherwise status code
+ *
  ***********************************************************/
-uint8_t i2c_readACK(void) {
+uint8_t i2c_readACK(uint8_t* data) {
 
 	// read with ACK
 	TWCR = (1 << TWEN) | (1 << TWINT) | (1 << TWEA);
-	while (!(TWCR & (1 << TWINT)));
+	if (i2c_wait() != 0) {
+		return I2C_ERR_TIMEOUT;
+	}
 		
 	// check if ACK sent
-	if (TW_STATUS!= TW_MR_DATA_ACK) {;
-		return TW_STATUS;
+	if (TW_STATUS != TW_MR_DATA_ACK) {
+		return i2c_status();
 	}
-	// return data on success
-	return TWDR;
+	*data = TWDR;
+	i2c_crc = i2c_crc8(i2c_crc, *data);
+	return 0;
 }
 
 
@@ -111,100 +317,486 @@ uint8_t i2c_readACK(void) {
  *
  * Read target device with NACK
  *
+ * @param data : received byte, untouched on error
+ *
+ * @returns    : 0 on success, otherwise status code
+ *
  ***********************************************************/
-uint8_t i2c_readNACK (void) {
+uint8_t i2c_readNACK (uint8_t* data) {
 
 	// enable send NACK to slave
 	TWCR = (1 << TWEN) | (1 << TWINT);
-	while (! (TWCR & (1 << TWINT)));
+	if (i2c_wait() != 0) {
+		return I2C_ERR_TIMEOUT;
+	}
 		
 	// check if NACK sent
 	if (TW_STATUS != TW_MR_DATA_NACK) {
-		return TW_STATUS;
+		return i2c_status();
 	}
-	// return data on success
-	return TWDR;
+	*data = TWDR;
+	i2c_crc = i2c_crc8(i2c_crc, *data);
+	return 0;
 }
 
 
 /***********************************************************
  *
  * End I2C transaction
+ * TWI is reset if STOP does not complete
+ * Re-arms address recognition when target mode enabled
  *
  ***********************************************************/
 void i2c_stop (void) {
 	TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);
-	while(TWCR & (1 << TWSTO));
+	uint16_t loops = I2C_TIMEOUT_LOOPS;
+	while (TWCR & (1 << TWSTO)) {
+		// STOP never went out, reset TWI to release the bus
+		if (--loops == 0) {
+			TWCR = 0;
+			break;
+		}
+	}
+	if (i2c_target_regs != 0) {
+		TWCR = (1 << TWEN) | (1 << TWEA) | (1 << TWIE);
+	}
+}
+
+
+/***********************************************************
+ *
+ * Install transaction trace hook, called for every
+ * controller transmit/receive including failed attempts
+ *
+ * @param hook : trace callback, 0 to stop tracing
+ *
+ ***********************************************************/
+void i2c_setTraceHook(I2c_trace_hook_t hook) {
+	i2c_trace_hook = hook;
+}
+
+
+/***********************************************************
+ *
+ * Hand finished transaction to trace hook
+ *
+ ***********************************************************/
+static void i2c_trace(uint8_t addr, uint8_t dir, const uint8_t* data, uint8_t len,
+	uint8_t done, uint8_t err, uint32_t t0) {
+	
+	if (i2c_trace_hook == 0) {
+		return;
+	}
+	I2c_trace_t txn = {
+		t0, tb_micros() - t0, addr, dir, len, done, err, data
+	};
+	i2c_trace_hook(&txn);
 }
 
 
 /***********************************************************
  *
  * Transmit data packet to I2C target
+ * PEC appended when enabled for target and the
+ * transaction ends here (not before a repeated start)
  *
  * @param addr	 : target device address
  * @param data	 : packet byte array 
  * @param len	 : packet length 
  * @param repeat : leave connection open?
  *
+ * @returns      : 0 on success, otherwise status code
+ *
  ***********************************************************/
 uint8_t i2c_controller_transmit(uint8_t addr, uint8_t* data, uint8_t len, bool repeat) {
 	
 	uint8_t err;
+	uint8_t done = 0;
+	uint32_t t0 = tb_micros();
 	
 	err = i2c_start(addr, TW_WRITE);
-	if (err != 0) {
-		return err;
-	}
 	
-	if (len > 1) {
-		for (uint8_t i = 0; i < len; i++) {
-			err = i2c_write(data[i]);
-		}
+	while ((done < len) && (err == 0)) {
+		err = i2c_write(data[done]);
+		done += (err == 0);
 	}
 	
-	else {
-		err = i2c_write(data[0]);
+	if ((err == 0) && !repeat && i2c_pecEnabled(addr)) {
+		err = i2c_write(i2c_crc);
 	}
 	
-	if (err != 0) {
-		return err;
-	}
-	
-	if (!repeat) {
+	if ((err != 0) || !repeat) {
 		i2c_stop();
-		return 0;
 	}
 	
-	return 0;
+	i2c_stats_record(I2C_TXN_TRANSMIT, len, err, tb_micros() - t0);
+	i2c_trace(addr, TW_WRITE, data, len, done, err, t0);
+	
+	return err;
 }
 
 
 /***********************************************************
  *
  * Read data packet from I2C target
+ * PEC byte read and verified when enabled for target,
+ * covering any write before the repeated start
  *
  * @param addr	 : target device address
  * @param data	 : packet buffer 
  * @param len	 : packet length 
  *
+ * @returns      : 0 on success, I2C_ERR_PEC on checksum
+ *                 mismatch, I2C_ERR_TIMEOUT on stuck bus,
+ *                 otherwise status code
+ *
  ***********************************************************/
-uint32_t i2c_controller_receive(uint8_t addr, uint8_t* data, uint8_t len) {
+uint8_t i2c_controller_receive(uint8_t addr, uint8_t* data, uint8_t len) {
 	
 	uint8_t err;
+	uint8_t done = 0;
+	bool pec = i2c_pecEnabled(addr);
+	uint32_t t0 = tb_micros();
 
 	err = i2c_start(addr, TW_READ);
-	if (err != 0) {
-		return err;
-	}
 	
-	for (uint8_t i = 0; i < len - 1; i++) {
-		data[i] = i2c_readACK();
+	// NACK last byte, PEC byte is last when enabled
+	while ((done < len) && (err == 0)) {
+		if ((done == len - 1) && !pec) {
+			err = i2c_readNACK(&data[done]);
+		}
+		else {
+			err = i2c_readACK(&data[done]);
+		}
+		done += (err == 0);
 	}
 	
-	data[len-1] = i2c_readNACK();
+	if ((err == 0) && pec) {
+		uint8_t expect = i2c_crc;
+		uint8_t rx;
+		err = i2c_readNACK(&rx);
+		if ((err == 0) && (rx != expect)) {
+			err = I2C_ERR_PEC;
+		}
+	}
 	
 	i2c_stop();
 	
-	return 0;
+	i2c_stats_record(I2C_TXN_RECEIVE, len, err, tb_micros() - t0);
+	i2c_trace(addr, TW_READ, data, len, done, err, t0);
+	
+	return err;
+}
+
+
+/***********************************************************
+ *
+ * Replace retry policy used by i2c_controller_transfer()
+ *
+ * @param policy : attempts, backoff and retried classes
+ *
+ ***********************************************************/
+void i2c_setRetryPolicy(const I2c_retry_t* policy) {
+	i2c_retry = *policy;
+	if (i2c_retry.attempts == 0) {
+		i2c_retry.attempts = 1;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Total attempts allowed by current policy
+ *
+ ***********************************************************/
+uint8_t i2c_retryAttempts(void) {
+	return i2c_retry.attempts;
+}
+
+
+/***********************************************************
+ *
+ * Wait before a retry, doubles from backoff_ms up to
+ * backoff_max_ms
+ *
+ * @param retry : retry number, 0 for first retry
+ *
+ * @returns     : milliseconds to wait
+ *
+ ***********************************************************/
+uint16_t i2c_retryBackoff(uint8_t retry) {
+	uint16_t ms = i2c_retry.backoff_ms;
+	while (retry-- && (ms < i2c_retry.backoff_max_ms)) {
+		ms <<= 1;
+	}
+	return (ms > i2c_retry.backoff_max_ms) ? i2c_retry.backoff_max_ms : ms;
+}
+
+
+/***********************************************************
+ *
+ * Map transport error to retry class
+ *
+ * @param err : error from controller transaction
+ *
+ * @returns   : I2C_RETRY_* class, 0 if never retried
+ *
+ ***********************************************************/
+uint8_t i2c_errorClass(uint8_t err) {
+	switch (err) {
+		case TW_MT_SLA_NACK:
+		case TW_MR_SLA_NACK:
+			return I2C_RETRY_ADDR_NACK;
+		case TW_MT_DATA_NACK:
+			return I2C_RETRY_DATA_NACK;
+		case TW_MT_ARB_LOST:
+			return I2C_RETRY_ARB;
+		case I2C_ERR_BUS:
+		case I2C_ERR_TIMEOUT:
+			return I2C_RETRY_BUS;
+		case I2C_ERR_PEC:
+			return I2C_RETRY_PEC;
+		default:
+			return 0;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Drop TWI state after bus error or timeout so the next
+ * START begins from idle, re-arms target mode
+ *
+ ***********************************************************/
+static void i2c_reset(void) {
+	TWCR = 0;
+	i2c_resume();
+	if (i2c_target_regs != 0) {
+		TWCR = (1 << TWEN) | (1 << TWEA) | (1 << TWIE);
+	}
+}
+
+
+/***********************************************************
+ *
+ * Write then read in one transaction (repeated start),
+ * or write only when rlen is 0. Whole transaction is
+ * retried under the current retry policy, backoff
+ * waits idle on the Timer0 tick.
+ *
+ * @param addr  : target device address
+ * @param wdata : bytes to write (command/register)
+ * @param wlen  : write length
+ * @param rdata : read buffer
+ * @param rlen  : read length, 0 for write only
+ *
+ * @returns     : 0 on success, otherwise error of the
+ *                last attempt
+ *
+ ***********************************************************/
+uint8_t i2c_controller_transfer(uint8_t addr, uint8_t* wdata, uint8_t wlen, uint8_t* rdata, uint8_t rlen) {
+	
+	uint8_t err;
+	uint8_t attempt = 0;
+	uint8_t cls;
+	
+	while (1) {
+		err = i2c_controller_transmit(addr, wdata, wlen, (rlen != 0));
+		if ((err == 0) && (rlen != 0)) {
+			err = i2c_controller_receive(addr, rdata, rlen);
+		}
+		
+		cls = i2c_errorClass(err);
+		if ((err == 0) || !(cls & i2c_retry.mask) || (++attempt >= i2c_retry.attempts)) {
+			return err;
+		}
+		
+		i2c_stats_retry();
+		if (cls & I2C_RETRY_BUS) {
+			i2c_reset();
+		}
+		if (cls & I2C_RETRY_BACKOFF) {
+			tb_sleepFor(i2c_retryBackoff(attempt - 1));
+		}
+	}
+}
+
+
+/***********************************************************
+ *
+ * Serve a register file as I2C target on addr
+ * Host writes a command byte then reads words LSB first,
+ * command auto-increments on longer reads. Writes beyond
+ * the command byte are ignored.
+ *
+ * TWI stays powered so address match can wake the core
+ * from power down. Controller transactions still work,
+ * target is re-armed after every STOP.
+ *
+ * @param addr  : 7 bit target address
+ * @param regs  : register file, indexed by command
+ * @param count : number of words in register file
+ *
+ ***********************************************************/
+void i2c_target_init(uint8_t addr, volatile uint16_t* regs, uint8_t count) {
+	i2c_target_regs = regs;
+	i2c_target_count = count;
+	TWAR = (addr << 1);
+	TWCR = (1 << TWEN) | (1 << TWEA) | (1 << TWIE);
+}
+
+
+/***********************************************************
+ *
+ * Enable/disable PEC on host reads
+ * Word reads become lo, hi, PEC (SMBus Read Word with
+ * PEC), no command auto-increment
+ *
+ * @param en : append PEC
+ *
+ ***********************************************************/
+void i2c_target_setPEC(bool en) {
+	i2c_target_pec = en;
+}
+
+
+/***********************************************************
+ *
+ * Check PEC setting for host reads
+ *
+ ***********************************************************/
+bool i2c_target_pecEnabled(void) {
+	return i2c_target_pec;
+}
+
+
+/***********************************************************
+ *
+ * Stop responding to target address
+ *
+ ***********************************************************/
+void i2c_target_disable(void) {
+	TWCR &= ~((1 << TWEA) | (1 << TWIE));
+	TWAR = 0;
+	i2c_target_regs = 0;
+	i2c_target_active = false;
+	i2c_target_wrote = false;
+}
+
+
+/***********************************************************
+ *
+ * Check target mode state
+ *
+ ***********************************************************/
+bool i2c_target_enabled(void) {
+	return (i2c_target_regs != 0);
+}
+
+
+/***********************************************************
+ *
+ * Register file word for command, 0xFFFF when out of range
+ *
+ ***********************************************************/
+static uint16_t i2c_target_word(uint8_t cmd) {
+	if (cmd >= i2c_target_count) {
+		return 0xFFFF;
+	}
+	return i2c_target_regs[cmd];
+}
+
+
+/***********************************************************
+ *
+ * TWI target state machine
+ * Word latched at first byte so a read is never torn by
+ * a register file update. PEC runs over every byte on
+ * the wire including both address bytes.
+ *
+ ***********************************************************/
+ISR(TWI_vect) {
+	
+	uint8_t twcr = (1 << TWINT) | (1 << TWEN) | (1 << TWEA) | (1 << TWIE);
+	
+	switch (TW_STATUS) {
+		
+		// addressed for write, next byte is command
+		case TW_SR_SLA_ACK:
+		case TW_SR_ARB_LOST_SLA_ACK:
+			i2c_target_active = true;
+			i2c_target_wrote = false;
+			i2c_target_byte = 0;
+			i2c_target_crc = i2c_crc8(0, TWAR & 0xFE);
+			break;
+		
+		case TW_SR_DATA_ACK:
+			if (i2c_target_byte == 0) {
+				i2c_target_cmd = TWDR;
+				i2c_target_crc = i2c_crc8(i2c_target_crc, i2c_target_cmd);
+				i2c_target_wrote = true;
+			}
+			i2c_target_byte++;
+			break;
+		
+		// addressed for read, send LSB of command word
+		// PEC restarts unless a command write preceded
+		case TW_ST_SLA_ACK:
+		case TW_ST_ARB_LOST_SLA_ACK:
+			if (!i2c_target_wrote) {
+				i2c_target_crc = 0;
+			}
+			i2c_target_wrote = false;
+			i2c_target_active = true;
+			i2c_target_crc = i2c_crc8(i2c_target_crc, TWAR | 0x01);
+			i2c_target_latch = i2c_target_word(i2c_target_cmd);
+			TWDR = (uint8_t)(i2c_target_latch & 0x00FF);
+			i2c_target_crc = i2c_crc8(i2c_target_crc, TWDR);
+			i2c_target_byte = 1;
+			break;
+		
+		// host wants more, MSB, then PEC or next word
+		case TW_ST_DATA_ACK:
+			if (i2c_target_byte & 0x01) {
+				TWDR = (uint8_t)((i2c_target_latch >> 8) & 0x00FF);
+				i2c_target_crc = i2c_crc8(i2c_target_crc, TWDR);
+			}
+			else if (i2c_target_pec) {
+				TWDR = (i2c_target_byte == 2) ? i2c_target_crc : 0xFF;
+			}
+			else {
+				i2c_target_cmd++;
+				i2c_target_latch = i2c_target_word(i2c_target_cmd);
+				TWDR = (uint8_t)(i2c_target_latch & 0x00FF);
+			}
+			i2c_target_byte++;
+			break;
+		
+		// release SDA/SCL after illegal START/STOP
+		case TW_BUS_ERROR:
+			twcr |= (1 << TWSTO);
+			i2c_target_active = false;
+			i2c_target_wrote = false;
+			i2c_target_crc = 0;
+			break;
+		
+		// STOP and repeated START report the same status. Only
+		// a lone command byte can be the write half of a read,
+		// any other write ended with STOP and the next read
+		// starts its own PEC
+		case TW_SR_STOP:
+			if (i2c_target_byte != 1) {
+				i2c_target_wrote = false;
+				i2c_target_crc = 0;
+			}
+			i2c_target_active = false;
+			break;
+		
+		// NACK from host or last byte
+		default:
+			i2c_target_active = false;
+			break;
+	}
+	
+	TWCR = twcr;
 }
\ No newline at end of file
@@ -11,6 +11,16 @@
 
 #include "stdbool.h"
 #include "util/twi.h"
+#include "avr/interrupt.h"
+#include "avr/pgmspace.h"
+
+// Driver state is per instance when built for the host
+// fleet simulator (host/sim), one simulated pack per thread
+#ifdef HOST_SIM
+#define INSTANCE_LOCAL	__thread
+#else
+#define INSTANCE_LOCAL
+#endif
 
 #define I2C_SCL_400KHZ	400000UL
 #define I2C_SCL_100KHZ	100000UL
@@ -18,14 +28,99 @@
 #define I2C_REPEAT		true
 #define I2C_NO_REPEAT	false
 
+// Error codes not covered by TW_STATUS (multiples of 8)
+#define I2C_OK			0x00
+#define I2C_ERR_PEC		0x01	// PEC mismatch on receive
+#define I2C_ERR_BUS		0x02	// TW_BUS_ERROR, illegal START/STOP
+#define I2C_ERR_TIMEOUT	0x03	// TWINT never set, SCL held
+#define I2C_ERR_LENGTH	0x04	// transfer longer than caller's buffer
+
+// TWINT/TWSTO spin limit, ~15ms @ 8MHz, ~60ms @ 2MHz
+#define I2C_TIMEOUT_LOOPS	20000U
+
+// Retry classes, errors in a class set in the policy mask
+// are retried. NACK and bus classes back off first (target
+// busy, bus recovering), arbitration and PEC retry at once.
+#define I2C_RETRY_ADDR_NACK	0x01	// SLA+W/SLA+R NACK, busy or waking
+#define I2C_RETRY_DATA_NACK	0x02	// data byte refused
+#define I2C_RETRY_ARB		0x04	// arbitration lost to another controller
+#define I2C_RETRY_BUS		0x08	// bus error or timeout, TWI reset first
+#define I2C_RETRY_PEC		0x10	// checksum mismatch on receive
+#define I2C_RETRY_BACKOFF	(I2C_RETRY_ADDR_NACK | I2C_RETRY_DATA_NACK | I2C_RETRY_BUS)
+
+// Default policy, 1, 2, 4ms between attempts
+#define I2C_RETRY_ATTEMPTS			4
+#define I2C_RETRY_BACKOFF_MS		1
+#define I2C_RETRY_BACKOFF_MAX_MS	8
+#define I2C_RETRY_MASK				(I2C_RETRY_ADDR_NACK | I2C_RETRY_DATA_NACK | I2C_RETRY_ARB | \
+									 I2C_RETRY_BUS | I2C_RETRY_PEC)
+
+typedef struct {
+	uint8_t attempts;			// total tries, 1 disables retry
+	uint8_t backoff_ms;			// wait before first retry
+	uint8_t backoff_max_ms;		// cap for doubled wait
+	uint8_t mask;				// I2C_RETRY_* classes to retry
+}I2c_retry_t;
+
+// Controller transaction handed to the trace hook after
+// STOP (or before a repeated start), bench capture or the
+// host recorder. PEC bytes are not included in data.
+typedef struct {
+	uint32_t t_us;				// tb_micros() at START
+	uint32_t dur_us;			// START to STOP
+	uint8_t addr;
+	uint8_t dir;				// TW_WRITE / TW_READ
+	uint8_t len;				// bytes requested
+	uint8_t done;				// bytes ACKed/received before err
+	uint8_t err;
+	const uint8_t* data;		// written or received bytes
+}I2c_trace_t;
+
+typedef void (*I2c_trace_hook_t)(const I2c_trace_t* txn);
+
+// Serve battery telemetry to a host as I2C target
+#define I2C_TARGET
+#undef  I2C_TARGET
+
+// Append SMBus PEC to host reads in target mode
+#define I2C_TARGET_PEC
+#undef  I2C_TARGET_PEC
+
+// Target address (SBS smart battery address)
+#define I2C_TARGET_ADDR	0x0B
+
 void i2c_init(uint32_t fcpu, uint32_t fscl);
+void i2c_resume(void);
+void i2c_setCPUClock(uint32_t fcpu);
 void i2c_disable(void);
 uint8_t i2c_start(uint8_t addr, uint8_t dir);
 uint8_t i2c_write (uint8_t data);
-uint8_t i2c_readACK(void);
-uint8_t i2c_readNACK(void);
+uint8_t i2c_readACK(uint8_t* data);
+uint8_t i2c_readNACK(uint8_t* data);
 void i2c_stop(void);
 uint8_t i2c_controller_transmit(uint8_t addr, uint8_t* data, uint8_t len, bool repeat);
-uint32_t i2c_controller_receive(uint8_t addr, uint8_t* data, uint8_t len);
+uint8_t i2c_controller_receive(uint8_t addr, uint8_t* data, uint8_t len);
+uint8_t i2c_controller_transfer(uint8_t addr, uint8_t* wdata, uint8_t wlen, uint8_t* rdata, uint8_t rlen);
+
+// retry policy
+void i2c_setRetryPolicy(const I2c_retry_t* policy);
+uint8_t i2c_retryAttempts(void);
+uint16_t i2c_retryBackoff(uint8_t retry);
+uint8_t i2c_errorClass(uint8_t err);
+
+// transaction trace
+void i2c_setTraceHook(I2c_trace_hook_t hook);
+
+// SMBus packet error checking
+uint8_t i2c_crc8(uint8_t crc, uint8_t data);
+void i2c_setPEC(uint8_t addr, bool en);
+bool i2c_pecEnabled(uint8_t addr);
+
+// target mode
+void i2c_target_init(uint8_t addr, volatile uint16_t* regs, uint8_t count);
+void i2c_target_setPEC(bool en);
+bool i2c_target_pecEnabled(void);
+void i2c_target_disable(void);
+bool i2c_target_enabled(void);
 
 #endif /* I2C_H_ */
\ No newline at end of file
@@ -0,0 +1,128 @@
+/*
+ * i2c_stats.c
+ *
+ * Created: 10/19/2026 7:25:27 AM
+ */ 
+
+#include "i2c.h"
+#include "i2c_stats.h"
+
+INSTANCE_LOCAL volatile I2c_stats_t i2c_stats;
+
+
+/***********************************************************
+ *
+ * Record a finished controller transaction
+ *
+ * @param type : I2C_TXN_TRANSMIT / I2C_TXN_RECEIVE
+ * @param len  : data bytes requested
+ * @param err  : transaction result
+ * @param us   : START to STOP duration
+ *
+ ***********************************************************/
+void i2c_stats_record(uint8_t type, uint8_t len, uint8_t err, uint32_t us) {
+	
+	i2c_stats.transactions[type]++;
+	
+	switch (err) {
+		case I2C_OK:
+			i2c_stats.bytes += len;
+			break;
+		case I2C_ERR_PEC:
+			i2c_stats.pec_errors++;
+			break;
+		case I2C_ERR_BUS:
+			i2c_stats.bus_errors++;
+			break;
+		case I2C_ERR_TIMEOUT:
+			i2c_stats.timeouts++;
+			break;
+		default:
+			i2c_stats.status[err >> 3]++;	// NACKs, arbitration lost
+			break;
+	}
+	
+	// log2 bucket
+	uint8_t bucket = 0;
+	us >>= I2C_LAT_MIN_LOG2;
+	while (us && (bucket < I2C_LAT_BUCKETS - 1)) {
+		us >>= 1;
+		bucket++;
+	}
+	i2c_stats.latency[type][bucket]++;
+}
+
+
+/***********************************************************
+ *
+ * Count a retried transaction
+ *
+ ***********************************************************/
+void i2c_stats_retry(void) {
+	i2c_stats.retries++;
+}
+
+
+/***********************************************************
+ *
+ * Reset all counters
+ *
+ ***********************************************************/
+void i2c_stats_clear(void) {
+	uint8_t* p = (uint8_t*)&i2c_stats;
+	for (uint16_t i = 0; i < sizeof(i2c_stats); i++) {
+		p[i] = 0;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Transmit counters and histograms to debug receiver
+ * Sent as three frames with parse codes, each small
+ * enough for the receiver's 32 byte Wire buffer
+ *
+ * Counter frame:
+ * code, tx count, rx count, bytes (LSW, MSW),
+ * SLA+W NACK, data NACK, SLA+R NACK, arbitration lost,
+ * bus errors, timeouts, retries, PEC errors
+ *
+ * Latency frame (one per type):
+ * code, type, buckets 0-7
+ *
+ * @param addr : i2c address for receiver
+ *
+ ***********************************************************/
+void i2c_stats_debug(uint8_t addr) {
+	
+	uint8_t buffer[26];
+	uint16_t data[13] = {
+		DEBUG_I2C_STATS_CODE,
+		i2c_stats.transactions[I2C_TXN_TRANSMIT], i2c_stats.transactions[I2C_TXN_RECEIVE],
+		(uint16_t)(i2c_stats.bytes & 0xFFFF), (uint16_t)(i2c_stats.bytes >> 16),
+		i2c_stats.status[TW_MT_SLA_NACK >> 3], i2c_stats.status[TW_MT_DATA_NACK >> 3],
+		i2c_stats.status[TW_MR_SLA_NACK >> 3], i2c_stats.status[TW_MT_ARB_LOST >> 3],
+		i2c_stats.bus_errors, i2c_stats.timeouts, i2c_stats.retries, i2c_stats.pec_errors
+	};
+	
+	for(uint8_t i = 0; i < 26; i+=2) {
+		buffer[i] = (uint8_t)(data[i/2] & 0x00FF);
+		buffer[i+1] = (uint8_t)((data[i/2] >> 8) & 0x00FF);
+	}
+	i2c_controller_transmit(addr, buffer, 26, I2C_NO_REPEAT);
+	
+	for (uint8_t type = 0; type < I2C_TXN_TYPES; type++) {
+		
+		data[0] = DEBUG_I2C_LATENCY_CODE;
+		data[1] = type;
+		for (uint8_t b = 0; b < I2C_LAT_BUCKETS; b++) {
+			data[b + 2] = i2c_stats.latency[type][b];
+		}
+		
+		for(uint8_t i = 0; i < 20; i+=2) {
+			buffer[i] = (uint8_t)(data[i/2] & 0x00FF);
+			buffer[i+1] = (uint8_t)((data[i/2] >> 8) & 0x00FF);
+		}
+		i2c_controller_transmit(addr, buffer, 20, I2C_NO_REPEAT);
+	}
+}
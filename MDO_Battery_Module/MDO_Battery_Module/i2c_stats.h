@@ -0,0 +1,47 @@
+/*
+ * i2c_stats.h
+ *
+ * Created: 10/19/2026 7:25:27 AM
+ */ 
+
+
+#ifndef I2C_STATS_H_
+#define I2C_STATS_H_
+
+#include "stdint.h"
+#include "i2c.h"
+
+// Transaction types
+#define I2C_TXN_TRANSMIT	0
+#define I2C_TXN_RECEIVE		1
+#define I2C_TXN_TYPES		2
+
+// Latency histogram, bucket n counts < 2^(n + 6) us
+// (<64us, <128us ... <4096us, last bucket open ended)
+#define I2C_LAT_BUCKETS		8
+#define I2C_LAT_MIN_LOG2	6
+
+// Debug parsing codes
+#define DEBUG_I2C_STATS_CODE	0xABAB
+#define DEBUG_I2C_LATENCY_CODE	0xACAC
+
+// Transport counters
+typedef struct {
+	uint16_t transactions[I2C_TXN_TYPES];
+	uint32_t bytes;						// data bytes on the wire, excluding address
+	uint16_t status[32];				// failures by TW_STATUS >> 3
+	uint16_t pec_errors;
+	uint16_t bus_errors;
+	uint16_t timeouts;
+	uint16_t retries;
+	uint16_t latency[I2C_TXN_TYPES][I2C_LAT_BUCKETS];
+}I2c_stats_t;
+
+extern INSTANCE_LOCAL volatile I2c_stats_t i2c_stats;
+
+void i2c_stats_record(uint8_t type, uint8_t len, uint8_t err, uint32_t us);
+void i2c_stats_retry(void);
+void i2c_stats_clear(void);
+void i2c_stats_debug(uint8_t addr);
+
+#endif /* I2C_STATS_H_ */
@@ -21,8 +21,7 @@
 #include "avr/sfr_defs.h"
 #include "util/delay.h"
 
-#include "i2c.h"
-#include "max17263.h"
+#include "battery.h"
 
 
 #define F_TIMER1      7812.5
@@ -44,6 +43,7 @@
 volatile uint8_t sleep_count = 0;
 ISR(WDT_vect) {
 	sleep_count++;
+	tb_advance(8000);
 	wdt_disable();
 }
 
@@ -73,72 +73,41 @@ void io_init(void) {
 
 void start_sleep(void) {
 	cli();
-	ADCSRA = 0;
-	wdt_on();
+	// keep running period when woken early (host read)
+	if (!(WDTCSR & _BV(WDIE)))
+		wdt_on();
 	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
 	sleep_enable();
 	sei();
 }
 
 
-void process_battery(void) {
-	
-	// Power on reset has occured
-	// We need to reload configuration
-	if (max_checkPOR())
-		max_loadConfig();
-
-	// Save learned parameters
-	// When bit 6 of Cycles Reg has toggled
-	if (max_checkCycles())
-		max_saveLearnedParameters();
-
-	#ifdef I2C_DEBUG
-		max_readFuelGauge();
-		max_debugDataStruct();
-		max_debugEEPROM();
-	#endif
-}
-
-
 int main(void){
 	
-	#ifdef I2C_DEBUG
-		max_debugWrite(DEBUG_ADDR, DEBUG_STARTUP_CODE);
-	#endif
+	// gate all peripherals, TWI only powered for gauge access
+	bat_init(I2C_SCL_100KHZ);
 	
 	io_init();
-	i2c_init(F_CPU, I2C_SCL_100KHZ);
-	
-	// set cell capacity and charge termination
-	max_setSenseResistor(10);
-	max_setCellCap(1200);
-	max_setChargeTerm(100);
 	
-	// set LED driver operation
-	max_setLEDBars(4);
-	max_setLEDMode(LED_MODE_PUSH_BUTTON_TIMER);
-	max_setLEDBrightness(LED_MAX_BRIGHTNESS);
-	max_setLEDTimer(LED_TIME_1300MS);
-	max_enLEDChargeIndicator(true);
-	//max_enLEDEmptyBlink(true);
-
-	// load configuration settings
-	max_loadConfig();
+	// cell, sense resistor and LED settings for this SKU
+	max_loadProfile(max_profileSelected());
 	
-	#ifdef I2C_DEBUG
-		max_debugWrite(DEBUG_ADDR, DEBUG_DONE_STARTUP_CODE);
-	#endif
+	// load configuration settings, target mode when built
+	bat_start();
 	
 	while(1){
 		
 		// Request battery data every 1 minute
+		// Bus limited, drop core clock for gauge access
 		if (sleep_count == COUNT_1_MIN) {
-			process_battery();
+			bat_wake();
 			LED_PORT ^= _BV(LED_PIN);
 			sleep_count = 0;
 		}
-		// enter sleep
+		// finish queued eeprom writes, core clock back up
+		bat_idle();
+		
+		// enter sleep, time advanced by watchdog
 		start_sleep();
 		sleep_cpu();
 		/**
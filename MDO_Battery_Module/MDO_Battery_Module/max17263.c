@@ -8,7 +8,7 @@
 
 #include "max17263.h"
 
-volatile Max17263_t max17263 = {
+INSTANCE_LOCAL volatile Max17263_t max17263 = {
 	.addr = MAX17263_I2C_ADDR,
 	.rsense = 10,
 	.DesignCap.value = DesignCap_DEFAULT,
@@ -20,6 +20,8 @@ volatile Max17263_t max17263 = {
 	.LEDCfg3.value = LEDCfg3_DEFAULT
 };
 
+INSTANCE_LOCAL volatile uint16_t max_target_regs[MAX_TARGET_REGS];
+
 
 /***********************************************************
  *
@@ -27,15 +29,94 @@ volatile Max17263_t max17263 = {
  * Stored into two byte buffer
  * Shifts LSB and MSB for returning word
  *
+ * @param reg  : register address to be read
+ * @param data : register value, untouched on error
+ *
+ * @returns    : 0 on success, otherwise i2c error code
+ *
+ ***********************************************************/
+uint8_t max_tryReadRegister(uint8_t reg, uint16_t* data) {
+	uint8_t rx_buffer[2];
+	uint8_t err;
+	uint8_t cmd = reg;
+	err = i2c_controller_transfer(max17263.addr, &cmd, 1, rx_buffer, 2);
+	if (err == 0) {
+		*data = ((rx_buffer[1] << 8) | (rx_buffer[0]));
+	}
+	return err;
+}
+
+
+/***********************************************************
+ *
+ * Read consecutive registers in one transaction, gauge
+ * increments its register pointer after each word
+ *
+ * @param reg   : first register address
+ * @param data  : register values, untouched on error
+ * @param words : number of registers, up to MAX_BURST_WORDS
+ *
+ * @returns     : 0 on success, I2C_ERR_LENGTH for too many
+ *                words, otherwise i2c error code
+ *
+ ***********************************************************/
+uint8_t max_tryReadBurst(uint8_t reg, uint16_t* data, uint8_t words) {
+	uint8_t rx_buffer[2 * MAX_BURST_WORDS];
+	uint8_t err;
+	uint8_t cmd = reg;
+	if (words > MAX_BURST_WORDS) {
+		return I2C_ERR_LENGTH;
+	}
+	err = i2c_controller_transfer(max17263.addr, &cmd, 1, rx_buffer, words * 2);
+	if (err == 0) {
+		for (uint8_t i = 0; i < words; i++) {
+			data[i] = ((rx_buffer[2*i+1] << 8) | (rx_buffer[2*i]));
+		}
+	}
+	return err;
+}
+
+
+/***********************************************************
+ *
+ * Write consecutive registers in one transaction
+ *
+ * @param reg   : first register address
+ * @param data  : register values
+ * @param words : number of registers, up to MAX_BURST_WORDS
+ *
+ * @returns     : 0 on success, I2C_ERR_LENGTH for too many
+ *                words, otherwise i2c error code
+ *
+ ***********************************************************/
+uint8_t max_writeBurst(uint8_t reg, const uint16_t* data, uint8_t words) {
+	uint8_t tx_buffer[1 + 2 * MAX_BURST_WORDS];
+	if (words > MAX_BURST_WORDS) {
+		return I2C_ERR_LENGTH;
+	}
+	tx_buffer[0] = reg;
+	for (uint8_t i = 0; i < words; i++) {
+		tx_buffer[2*i+1] = (uint8_t)((data[i] & 0x00FF));
+		tx_buffer[2*i+2] = (uint8_t)((data[i] >> 8) & 0x00FF);
+		max_cacheInvalidate(reg + i);
+	}
+	return i2c_controller_transfer(max17263.addr, tx_buffer, 1 + words * 2, 0, 0);
+}
+
+
+/***********************************************************
+ *
+ * Read data from internal register
+ * Returns 0 on bus error, use max_tryReadRegister()
+ * wherever a failed read must not be taken as data
+ *
  * @param reg : register address to be read
  *
  ***********************************************************/
 uint16_t max_readRegister(uint8_t reg) {
-	uint8_t rx_buffer[2];
-	rx_buffer[0] = reg;
-	i2c_controller_transmit(max17263.addr, rx_buffer, 1, I2C_REPEAT);
-	i2c_controller_receive(max17263.addr, rx_buffer, 2);
-	return ((rx_buffer[1] << 8) | (rx_buffer[0]));
+	uint16_t data = 0;
+	max_tryReadRegister(reg, &data);
+	return data;
 }
 
 
@@ -51,20 +132,29 @@ uint16_t max_readRegister(uint8_t reg) {
  * @param reg  : register address to write
  * @param data : data to write
  *
+ * @returns    : 0 on success, otherwise i2c error code
+ *
  ***********************************************************/
-void max_writeRegister(uint8_t reg, uint16_t data) {
+uint8_t max_writeRegister(uint8_t reg, uint16_t data) {
 	uint8_t tx_buffer[3];
 	tx_buffer[0] = reg;
 	tx_buffer[1] = (uint8_t)((data & 0x00FF));
 	tx_buffer[2] = (uint8_t)((data >> 8) & 0x00FF);
-	i2c_controller_transmit(max17263.addr, tx_buffer, 3, I2C_NO_REPEAT);
+	max_cacheInvalidate(reg);
+	return i2c_controller_transfer(max17263.addr, tx_buffer, 3, 0, 0);
 }
 
 
 /***********************************************************
  *
  * Writes data to register and verifies data received
- * performs three attempts 
+ * Bus errors are retried inside the transport, this
+ * loop only repeats on readback mismatch and gives up
+ * once the transport does. Readback
+ * waits follow the transport backoff (1, 2, 4ms...)
+ * and attempts are capped by the same retry policy.
+ * With PEC enabled for the gauge an acknowledged write
+ * is already integrity checked and no readback is done
  *
  * @param reg  : register address to write
  * @param data : data to write
@@ -73,12 +163,32 @@ void max_writeRegister(uint8_t reg, uint16_t data) {
 void max_writeAndVerifyRegister(uint8_t reg, uint16_t data) {
 	uint16_t buffer;
 	uint8_t attempt = 0;
+	uint8_t err;
 	do {
-		max_writeRegister(reg, data);
-		_delay_ms(1);
-		buffer = max_readRegister(reg);
+		err = max_writeRegister(reg, data);
+		if ((err != 0) || i2c_pecEnabled(max17263.addr)) {
+			return;										// transport already retried
+		}
+		max_sleepFor(i2c_retryBackoff(attempt));
+		if (max_tryReadRegister(reg, &buffer) != 0) {
+			return;
+		}
 		attempt++;
-	}while(data != buffer && (attempt < 3));
+	}while(data != buffer && (attempt < i2c_retryAttempts()));
+}
+
+
+/***********************************************************
+ *
+ * Driver wait, all gauge polling and settle delays route
+ * through here. Core idles on Timer0 tick instead of
+ * spinning, busy waits only with interrupts disabled.
+ *
+ * @param ms : milliseconds to wait
+ *
+ ***********************************************************/
+void max_sleepFor(uint16_t ms) {
+	tb_sleepFor(ms);
 }
 
 
@@ -90,7 +200,11 @@ void max_writeAndVerifyRegister(uint8_t reg, uint16_t data) {
  *
  ***********************************************************/
 uint16_t max_checkPOR(void) {
-	return (max_readRegister(Status_REG_ADDR) & POR);	// return state of por bit in status reg
+	uint16_t status;
+	if (max_tryReadRegister(Status_REG_ADDR, &status) != 0) {
+		return 0;										// no valid status, retry next wake
+	}
+	return (status & POR);								// return state of por bit in status reg
 }
 
 
@@ -147,22 +261,18 @@ void max_loadConfig(void) {
 		max_debugWrite(DEBUG_ADDR, DEBUG_POR_CODE);
 	#endif
 	
-	// check to see if saved parameters exits
-	// (should be value 0xBEEF at address 0x00)
-	buffer = eeprom_read_word((uint16_t*)EEPROM_CHECK_ADDR);
+	// gauge registers reset, nothing cached is valid
+	max_cacheInvalidateAll();
 	
-	// if no saved parameters initialize eeprom and flag
-	if (buffer != EEPROM_CHECK_VAL) {
-	eeprom_write_word((uint16_t*)EEPROM_CHECK_ADDR, EEPROM_CHECK_VAL);
-		check_flag = 1;
-	}
+	// check to see if saved parameters exits, initialize
+	// blank eeprom and upgrade older layouts in place
+	check_flag = max_eepromOpen();
 
 	// wait until FSTAT.DNR bit = 0 (warming up)
 	while(max_readRegister(FStat_REG_ADDR) & DNR) {				
-		_delay_ms(10);
+		max_sleepFor(10);
 	}
 
-	buffer = max_readRegister(HibCfg_REG_ADDR);					// save original hibernate mode settings
 	max_writeRegister(SoftWakeup_REG_ADDR, SoftWakeup_CLEAR);	// exit hibernate mode step 1 
 	max_writeRegister(HibCfg_REG_ADDR, 0x0000);					// exit hibernate mode step 2 
 	max_writeRegister(SoftWakeup_REG_ADDR, SoftWakeup_SOFT);	// exit hibernate mode step 3 
@@ -171,11 +281,20 @@ void max_loadConfig(void) {
 	max_writeRegister(DesignCap_REG_ADDR, max17263.DesignCap.value);	// write DesignCap
 	max_writeRegister(IChgTerm_REG_ADDR, max17263.IChgTerm.value);		// write IChgTerm
 	max_writeRegister(VEmpty_REG_ADDR, max17263.VEmpty.value);			// write Vempty
-	max_writeRegister(ModelCfg_REG_ADDR, max17263.ModelCfg.value);		// write ModelCfg
 	
-	// wait until MODELCFG.REFRESH = 0
-	while(max_readRegister(ModelCfg_REG_ADDR) & ModelCfg_Refresh) {			
-		_delay_ms(10);
+	// characterised model when set, EZ model otherwise
+	// or when the load fails. Either is only applied by the
+	// refresh, so ModelCfg is always written with it set
+	max_loadModel();
+	max_writeRegister(ModelCfg_REG_ADDR, max17263.ModelCfg.value | ModelCfg_Refresh);	// write ModelCfg
+	
+	// wait until MODELCFG.REFRESH = 0, bounded so a gauge
+	// that never clears it cannot hang the config load
+	for (uint8_t poll = 0; poll < MAX_REFRESH_POLLS; poll++) {
+		if (!(max_readRegister(ModelCfg_REG_ADDR) & ModelCfg_Refresh)) {
+			break;
+		}
+		max_sleepFor(10);
 	}
 	
 	// if no learned parameters exist in eeprom we need default
@@ -200,12 +319,12 @@ void max_loadConfig(void) {
 	max_writeRegister(Cycles_REG_ADDR, max17263.Cycles);
 	max_writeRegister(FullCapNom_REG_ADDR, max17263.FullCapNom);
 	
-	// restore original hibernate settings
-	max_writeRegister(HibCfg_REG_ADDR, buffer);						
+	// hibernate settings from selected profile
+	max_hibRestore();
 
 	// set LED driver operation
-	max_writeRegister(LEDCfg3_REG_ADDR, max17263.LEDCfg3.value);
-	max_writeRegister(LEDCfg3_REG_ADDR, max17263.LEDCfg3.value);
+	max_writeRegister(LEDCfg1_REG_ADDR, max17263.LEDCfg1.value);
+	max_writeRegister(LEDCfg2_REG_ADDR, max17263.LEDCfg2.value);
 	max_writeRegister(LEDCfg3_REG_ADDR, max17263.LEDCfg3.value);
 	
 	buffer = max_readRegister(Status_REG_ADDR);						// read status
@@ -298,15 +417,159 @@ void max_setDLED(uint8_t dled) {
  *
  ***********************************************************/
 void max_readFuelGauge(void) {
-	max17263.RepCap	= max_readRegister(RepCap_REG_ADDR);
-	max17263.RepSOC	= max_readRegister(RepSOC_REG_ADDR);
-	max17263.TTE	= max_readRegister(TTE_REG_ADDR);
+	uint16_t cap, soc, tte;
+	
+	// keep previous snapshot unless every read succeeds
+	if ((max_tryReadRegisterCached(RepCap_REG_ADDR, &cap) == 0) &&
+		(max_tryReadRegisterCached(RepSOC_REG_ADDR, &soc) == 0) &&
+		(max_tryReadRegisterCached(TTE_REG_ADDR, &tte) == 0)) {
+		max17263.RepCap	= cap;
+		max17263.RepSOC	= soc;
+		max17263.TTE	= tte;
+	}
 	#ifdef I2C_DEBUG
 		max_debugFuelGauge();
 	#endif
 } 
 
 
+// Snapshot burst windows. Unused registers in a gap of
+// four or more words cost more bus time than starting a
+// new transaction, so bursts split there.
+static const uint8_t max_snapshot_bursts[][2] = {
+	{ RepCap_REG_ADDR,		7 },	// RepCap .. AvgCurrent
+	{ FullCapRep_REG_ADDR,	2 },	// FullCapRep, TTE
+	{ Cycles_REG_ADDR,		3 },	// Cycles .. AvgVCell
+	{ TTF_REG_ADDR,			1 },
+};
+
+#define MAX_SNAPSHOT_WORDS	13
+
+
+/***********************************************************
+ *
+ * Capture measurement and output registers together.
+ * Bursts run back to back, well inside one gauge task
+ * period, and the snapshot only changes when every burst
+ * succeeds so values are never mixed across wakes.
+ *
+ * @param snap : snapshot, untouched on error
+ *
+ * @returns    : 0 on success, otherwise i2c error code
+ *
+ ***********************************************************/
+uint8_t max_readSnapshot(Max17263_snapshot_t* snap) {
+	uint16_t raw[MAX_SNAPSHOT_WORDS];
+	uint16_t* word = raw;
+	uint32_t stamp = tb_millis();
+	uint32_t start = tb_micros();
+	uint8_t err;
+	
+	for (uint8_t i = 0; i < sizeof(max_snapshot_bursts) / sizeof(max_snapshot_bursts[0]); i++) {
+		err = max_tryReadBurst(max_snapshot_bursts[i][0], word, max_snapshot_bursts[i][1]);
+		if (err != 0) {
+			return err;
+		}
+		word += max_snapshot_bursts[i][1];
+	}
+	
+	// raw[] holds 0x05-0x0B, 0x10-0x11, 0x17-0x19, 0x20
+	snap->stamp		 = stamp;
+	snap->span_us	 = (uint16_t)(tb_micros() - start);
+	snap->RepCap	 = raw[0];
+	snap->RepSOC	 = raw[1];
+	snap->Temp		 = (int16_t)raw[3];
+	snap->VCell		 = raw[4];
+	snap->Current	 = (int16_t)raw[5];
+	snap->AvgCurrent = (int16_t)raw[6];
+	snap->FullCapRep = raw[7];
+	snap->TTE		 = raw[8];
+	snap->Cycles	 = raw[9];
+	snap->AvgVCell	 = raw[11];
+	snap->TTF		 = raw[12];
+	return 0;
+}
+
+
+/***********************************************************
+ *
+ * Copy data struct snapshot into target register file
+ * Host reads are served from here without touching the
+ * gauge bus. Call after max_readFuelGauge().
+ *
+ ***********************************************************/
+void max_targetUpdate(void) {
+	
+	uint16_t regs[][2] = {
+		{ RepCap_REG_ADDR,		max17263.RepCap },
+		{ TTE_REG_ADDR,			max17263.TTE },
+		{ FullCapRep_REG_ADDR,	max17263.FullCapRep },
+		{ RepSOC_REG_ADDR,		max17263.RepSOC },
+		{ Cycles_REG_ADDR,		max17263.Cycles },
+		{ FullCapNom_REG_ADDR,	max17263.FullCapNom },
+		{ RCOMP0_REG_ADDR,		max17263.RCOMP },
+		{ TempCo_REG_ADDR,		max17263.TempCo },
+		{ DesignCap_REG_ADDR,	max17263.DesignCap.value },
+		{ IChgTerm_REG_ADDR,	max17263.IChgTerm.value },
+		{ VEmpty_REG_ADDR,		max17263.VEmpty.value },
+	};
+	
+	for (uint8_t i = 0; i < sizeof(regs) / sizeof(regs[0]); i++) {
+		uint8_t sreg = SREG;
+		cli();
+		max_target_regs[regs[i][0]] = regs[i][1];
+		SREG = sreg;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Rebuild target register file as SBS command map
+ * Conversions done once per wake so host reads are
+ * answered straight from RAM. Sources come from a live
+ * register snapshot, FullCapRep and Cycles in the data
+ * struct only change at learned parameter saves. The
+ * previous map is kept when the snapshot read fails.
+ *
+ ***********************************************************/
+void max_sbsUpdate(void) {
+	
+	Max17263_snapshot_t live;
+	if (max_readSnapshot(&live) != 0) {
+		return;
+	}
+	
+	uint16_t regs[SBS_COMMANDS];
+	Sbs_snapshot_t snap = {
+		.pec = i2c_target_pecEnabled(),
+		.rsense = max17263.rsense,
+		.raw = {
+			[SBS_SRC_REPCAP]	 = live.RepCap,
+			[SBS_SRC_REPSOC]	 = live.RepSOC,
+			[SBS_SRC_TTE]		 = live.TTE,
+			[SBS_SRC_FULLCAPREP] = live.FullCapRep,
+			[SBS_SRC_CYCLES]	 = live.Cycles,
+			[SBS_SRC_DESIGNCAP]	 = max17263.DesignCap.value,
+			[SBS_SRC_TEMP]		 = (uint16_t)live.Temp,
+			[SBS_SRC_VCELL]		 = live.VCell,
+			[SBS_SRC_CURRENT]	 = (uint16_t)live.Current,
+			[SBS_SRC_AVGCURRENT] = (uint16_t)live.AvgCurrent,
+		}
+	};
+	
+	sbs_update(&snap, regs);
+	
+	// copy with target ISR masked
+	for (uint8_t i = 0; i < SBS_COMMANDS; i++) {
+		uint8_t sreg = SREG;
+		cli();
+		max_target_regs[i] = regs[i];
+		SREG = sreg;
+	}
+}
+
+
 /***********************************************************
  *
  * Check bit 6 of cycles register. Data sheet recommends
@@ -319,7 +582,10 @@ void max_readFuelGauge(void) {
  ***********************************************************/
 uint8_t max_checkCycles(void) {
 	
-	uint16_t buffer = max_readRegister(Cycles_REG_ADDR);	// read cycles register
+	uint16_t buffer;
+	if (max_tryReadRegisterCached(Cycles_REG_ADDR, &buffer) != 0) {	// read cycles register
+		return 0;
+	}
 	
 	// compare bit 6 of reading to last saved value 
 	if((buffer & Cycles_BIT6) != (max17263.Cycles & Cycles_BIT6)) {
@@ -338,32 +604,41 @@ uint8_t max_checkCycles(void) {
  *
  ***********************************************************/
 void max_saveLearnedParameters(void) {
-	max17263.RCOMP	 = max_readRegister(RCOMP0_REG_ADDR);
-	max17263.TempCo	 = max_readRegister(TempCo_REG_ADDR);
-	max17263.FullCapRep = max_readRegister(FullCapRep_REG_ADDR);
-	max17263.Cycles	    = max_readRegister(Cycles_REG_ADDR);
-	max17263.FullCapNom = max_readRegister(FullCapNom_REG_ADDR);
+	uint16_t rcomp, tempco, fullcaprep, cycles, fullcapnom;
+	
+	// never persist a failed read
+	if ((max_tryReadRegisterCached(RCOMP0_REG_ADDR, &rcomp) != 0) ||
+		(max_tryReadRegisterCached(TempCo_REG_ADDR, &tempco) != 0) ||
+		(max_tryReadRegisterCached(FullCapRep_REG_ADDR, &fullcaprep) != 0) ||
+		(max_tryReadRegisterCached(Cycles_REG_ADDR, &cycles) != 0) ||
+		(max_tryReadRegisterCached(FullCapNom_REG_ADDR, &fullcapnom) != 0)) {
+		return;
+	}
+	
+	max17263.RCOMP	    = rcomp;
+	max17263.TempCo	    = tempco;
+	max17263.FullCapRep = fullcaprep;
+	max17263.Cycles	    = cycles;
+	max17263.FullCapNom = fullcapnom;
 	max_eepromSaveParameters();
 }
 
 
 /***********************************************************
  *
- * Save learned parameters to non volatile data
- * eeprom_update_word() only writes if data mismatch
+ * Queue learned parameters for non volatile storage
+ * Written from EE_READY ISR, only changed bytes programmed
+ * Returns immediately, call ee_flush() before power down
  *
  * @param max : Max17263 data structured
  *
  ***********************************************************/
 void max_eepromSaveParameters(void) {
-	eeprom_update_word((uint16_t *)EEPROM_RCOMP0_ADDR, max17263.RCOMP);
-	eeprom_update_word((uint16_t *)EEPROM_TempCo_ADDR, max17263.TempCo);
-	eeprom_update_word((uint16_t *)EEPROM_FullCapRep_ADDR, max17263.FullCapRep);
-	eeprom_update_word((uint16_t *)EEPROM_Cycles_ADDR, max17263.Cycles);
-	eeprom_update_word((uint16_t *)EEPROM_FullCapNom_ADDR, max17263.FullCapNom);
-	#ifdef I2C_DEBUG
-		max_debugEEPROM();
-	#endif
+	ee_writeWord(EEPROM_RCOMP0_ADDR, max17263.RCOMP);
+	ee_writeWord(EEPROM_TempCo_ADDR, max17263.TempCo);
+	ee_writeWord(EEPROM_FullCapRep_ADDR, max17263.FullCapRep);
+	ee_writeWord(EEPROM_Cycles_ADDR, max17263.Cycles);
+	ee_writeWord(EEPROM_FullCapNom_ADDR, max17263.FullCapNom);
 }
 
 
@@ -375,11 +650,11 @@ void max_eepromSaveParameters(void) {
  *
  ***********************************************************/
 void max_eepromLoadParameters(void) {
-	max17263.RCOMP  = eeprom_read_word((uint16_t *)EEPROM_RCOMP0_ADDR);
-	max17263.TempCo = eeprom_read_word((uint16_t *)EEPROM_TempCo_ADDR);
-	max17263.FullCapRep = eeprom_read_word((uint16_t *)EEPROM_FullCapRep_ADDR);
-	max17263.Cycles     = eeprom_read_word((uint16_t *)EEPROM_Cycles_ADDR);
-	max17263.FullCapNom = eeprom_read_word((uint16_t *)EEPROM_FullCapNom_ADDR);
+	max17263.RCOMP  = ee_readWord(EEPROM_RCOMP0_ADDR);
+	max17263.TempCo = ee_readWord(EEPROM_TempCo_ADDR);
+	max17263.FullCapRep = ee_readWord(EEPROM_FullCapRep_ADDR);
+	max17263.Cycles     = ee_readWord(EEPROM_Cycles_ADDR);
+	max17263.FullCapNom = ee_readWord(EEPROM_FullCapNom_ADDR);
 	#ifdef I2C_DEBUG
 		max_debugEEPROM();
 	#endif
@@ -398,7 +673,7 @@ void max_eepromLoadParameters(void) {
 void max_debugRead(uint8_t addr, uint8_t reg) {
 	uint16_t rx_data;
 	uint8_t tx_buffer[2];
-	rx_data = max_readRegister(reg);
+	rx_data = max_readRegisterCached(reg);
 	tx_buffer[0] = (uint8_t)((rx_data & 0x00FF));
 	tx_buffer[1] = (uint8_t)((rx_data >> 8) & 0x00FF);
 	i2c_controller_transmit(addr, tx_buffer, 2, I2C_NO_REPEAT);
@@ -460,7 +735,7 @@ void max_debugDataStruct(void) {
 		max17263.TempCo, max17263.FullCapRep, max17263.Cycles, max17263.FullCapNom
 	};
   
-	for(uint8_t i = 0; i < 22; i+=2) {
+	for(uint8_t i = 0; i < 26; i+=2) {
 		buffer[i] = (uint8_t)(data[i/2] & 0x00FF);
 		buffer[i+1] = (uint8_t)((data[i/2] >> 8) & 0x00FF);
 	}
@@ -493,6 +768,38 @@ void max_debugFuelGauge(void) {
 }
 
 
+/***********************************************************
+ *
+ * Transmit telemetry snapshot to receiver
+ * Snapshot words in 30 byte buffer with parse code,
+ * nothing sent if the snapshot read fails
+ *
+ ***********************************************************/
+void max_debugSnapshot(void) {
+	
+	Max17263_snapshot_t snap;
+	if (max_readSnapshot(&snap) != 0) {
+		return;
+	}
+	
+	uint8_t buffer[30];
+	uint16_t data[] = {
+		DEBUG_SNAPSHOT_CODE,
+		(uint16_t)(snap.stamp & 0xFFFF), (uint16_t)(snap.stamp >> 16), snap.span_us,
+		snap.RepCap, snap.RepSOC, (uint16_t)snap.Temp, (uint16_t)snap.Current,
+		(uint16_t)snap.AvgCurrent, snap.FullCapRep, snap.TTE, snap.Cycles,
+		snap.AvgVCell, snap.VCell, snap.TTF
+	};
+	
+	for(uint8_t i = 0; i < 30; i+=2) {
+		buffer[i] = (uint8_t)(data[i/2] & 0x00FF);
+		buffer[i+1] = (uint8_t)((data[i/2] >> 8) & 0x00FF);
+	}
+	
+	i2c_controller_transmit(DEBUG_ADDR, buffer, 30, I2C_NO_REPEAT);
+}
+
+
 /***********************************************************
  *
  * Transmit saved parameters in EEPROM to receiver
@@ -504,17 +811,25 @@ void max_debugFuelGauge(void) {
  * 3 -> data LSB
  * 4 -> data MSB
  *
+ * Skipped while writes are queued rather than waiting on
+ * them, a later wake reports the contents once
+ * bat_idle() has drained the queue
+ *
  ***********************************************************/
 void max_debugEEPROM(void) {
+	
+	if (ee_busy()) {
+		return;
+	}
 
 	uint8_t buffer[22];
 	uint16_t data[] = {
 		DEBUG_EEPROM_CODE,
-		EEPROM_RCOMP0_ADDR, eeprom_read_word((uint16_t *) EEPROM_RCOMP0_ADDR),
-		EEPROM_TempCo_ADDR, eeprom_read_word((uint16_t *) EEPROM_TempCo_ADDR),
-		EEPROM_FullCapRep_ADDR, eeprom_read_word((uint16_t *) EEPROM_FullCapRep_ADDR),
-		EEPROM_Cycles_ADDR, eeprom_read_word((uint16_t *) EEPROM_Cycles_ADDR),
-		EEPROM_FullCapNom_ADDR, eeprom_read_word((uint16_t *) EEPROM_FullCapNom_ADDR)
+		EEPROM_RCOMP0_ADDR, ee_readWord(EEPROM_RCOMP0_ADDR),
+		EEPROM_TempCo_ADDR, ee_readWord(EEPROM_TempCo_ADDR),
+		EEPROM_FullCapRep_ADDR, ee_readWord(EEPROM_FullCapRep_ADDR),
+		EEPROM_Cycles_ADDR, ee_readWord(EEPROM_Cycles_ADDR),
+		EEPROM_FullCapNom_ADDR, ee_readWord(EEPROM_FullCapNom_ADDR)
 	};
 	
 	for(uint8_t i = 0; i < 22; i+=2) {
@@ -541,7 +856,7 @@ void max_debugLED(void) {
 	// toggle LEDs 1-4 
 	for (uint8_t i = 0; i < 4; i++) {
 		max_writeRegister(CustLED_REG_ADDR, (uint16_t)(1 << i));
-		_delay_ms(1000);
+		max_sleepFor(1000);
 	}
 	
 	// disable custom led control
@@ -549,5 +864,5 @@ void max_debugLED(void) {
 	max_writeRegister(CustLED_REG_ADDR, CustLED_DEFAULT);
 	max_writeRegister(CustLED_REG_ADDR, max17263.LEDCfg3.value);
 	
-	_delay_ms(1000);
+	max_sleepFor(1000);
 }
\ No newline at end of file
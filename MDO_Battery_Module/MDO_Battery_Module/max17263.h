@@ -18,6 +18,9 @@
 #include "util/delay.h"
 
 #include "i2c.h"
+#include "eeprom_queue.h"
+#include "timebase.h"
+#include "sbs.h"
 #include "max17263_regmap.h"
 
 
@@ -32,6 +35,11 @@
 #define MONITOR
 #undef  MONITOR
 
+// Load characterised model (cell_model.c) at config
+// instead of the EZ model refresh
+#define MAX_CUSTOM_MODEL
+#undef  MAX_CUSTOM_MODEL
+
 // max17263 i2c address
 #define MAX17263_I2C_ADDR	0x36
 
@@ -55,6 +63,7 @@ typedef struct max17263_t{
 	__LEDCfg1_t LEDCfg1;
 	__LEDCfg2_t LEDCfg2;
 	__LEDCfg3_t LEDCfg3;
+	uint16_t HibCfg;
 	
 	// Learned Parameters registers
 	uint16_t RCOMP;
@@ -69,16 +78,164 @@ typedef struct max17263_t{
 	uint16_t TTE;
 }Max17263_t;
 
+// Characterisation model from the cell INI, kept in
+// flash (PROGMEM). id 0 marks an empty table.
+typedef struct max17263_model_t{
+	uint16_t id;
+	uint16_t table[Model_WORDS];		// 0x80 - 0xAF
+	uint16_t RCOMP0;
+	uint16_t TempCo;
+	uint16_t QRTable[4];				// QRTable00, 10, 20, 30
+}Max17263_model_t;
+
+// Cell variant, raw register values so boot only copies
+// Tables in flash (cell_profiles.c), built with the
+// MAX_DESIGNCAP() ... encoders below
+typedef struct max17263_profile_t{
+	uint8_t  rsense;					// mOhm
+	uint16_t DesignCap;
+	uint16_t IChgTerm;
+	uint16_t VEmpty;
+	uint16_t ModelCfg;
+	uint16_t LEDCfg1;
+	uint16_t LEDCfg2;
+	uint16_t LEDCfg3;
+	const Max17263_model_t* model;		// NULL for EZ config
+}Max17263_profile_t;
+
+// Compile time encoders, UG6595 table 1 resolutions
+#define MAX_DESIGNCAP(mAh, mOhm)	((uint16_t)((uint32_t)(mAh) * (mOhm) / 5))			// 5uVh / rsense
+#define MAX_ICHGTERM(mA, mOhm)		((uint16_t)((uint32_t)(mA) * (mOhm) * 64 / 100))	// 1.5625uV / rsense
+#define MAX_VEMPTY(ve_mV, vr_mV)	((uint16_t)((((uint16_t)(ve_mV) / 10) << 7) | ((vr_mV) / 40)))
+#define MAX_LEDCFG1(bars, gray, chg, mode, ani, step, timer) \
+	((uint16_t)((bars) | ((gray) << 4) | ((chg) << 5) | ((mode) << 6) | \
+	((ani) << 8) | ((step) << 10) | ((uint16_t)(timer) << 13)))
+
 // MAX17263 data struct global instance
-extern volatile Max17263_t max17263;
+extern INSTANCE_LOCAL volatile Max17263_t max17263;
+
+
+// Measurement and output registers captured together
+// Raw register values, scaling per max17263_regmap.h
+typedef struct __attribute__((packed)) max17263_snapshot_t{
+	uint32_t stamp;			// tb_millis() before first burst
+	uint16_t span_us;		// first burst start to last burst end
+
+	uint16_t RepCap;
+	uint16_t RepSOC;
+	int16_t  Temp;
+	int16_t  Current;
+	int16_t  AvgCurrent;
+	uint16_t FullCapRep;
+	uint16_t TTE;
+	uint16_t Cycles;
+	uint16_t AvgVCell;
+	uint16_t VCell;
+	uint16_t TTF;
+}Max17263_snapshot_t;
 
 
 
 
 // read/write functions
+#define MAX_BURST_WORDS		16		// burst buffer size, longer bursts rejected
+uint8_t max_tryReadRegister(uint8_t reg, uint16_t* data);
 uint16_t max_readRegister(uint8_t reg);
-void max_writeRegister(uint8_t reg, uint16_t data);
+uint8_t max_tryReadBurst(uint8_t reg, uint16_t* data, uint8_t words);
+uint8_t max_writeBurst(uint8_t reg, const uint16_t* data, uint8_t words);
+uint8_t max_writeRegister(uint8_t reg, uint16_t data);
 void max_writeAndVerifyRegister(uint8_t reg, uint16_t data);
+void max_sleepFor(uint16_t ms);
+
+
+
+
+// Gauge update cadence
+#define MAX_TASK_PERIOD_MS	175		// active mode (175.8ms)
+#define MAX_HIB_PERIOD_MS	351		// hibernate, x 2^HibScalar
+
+// read cache for registers updated on task period
+uint8_t max_tryReadRegisterCached(uint8_t reg, uint16_t* data);
+uint16_t max_readRegisterCached(uint8_t reg);
+void max_cacheInvalidate(uint8_t reg);
+void max_cacheInvalidateAll(void);
+void max_cacheSetHibernate(bool hibernate);
+uint8_t max_cacheSyncHibernate(void);
+
+
+
+
+// Status event engine, one Status read per wake
+#define MAX_STATUS_RISE		0x01	// bit set since last poll
+#define MAX_STATUS_FALL		0x02	// bit cleared since last poll
+#define MAX_STATUS_LEVEL	0x04	// bit set on this poll
+#define MAX_STATUS_CLEAR	0x08	// clear bit in Status once read
+#define MAX_STATUS_HANDLERS	8
+
+typedef void (*Max_status_handler_t)(uint16_t bits, uint16_t status);
+
+uint8_t max_statusOn(uint16_t mask, uint8_t flags, Max_status_handler_t handler);
+uint8_t max_statusPoll(void);
+uint16_t max_statusLast(void);
+void max_statusReset(void);
+
+
+
+
+// HibCfg fields, enter time 2.8s x 2^enter, current
+// threshold FullCap / (0.8h x 2^thr), exit after
+// (exit + 1) hibernate periods of 351ms x 2^scalar
+#define MAX_HIBCFG(enter, thr, exit, scalar) \
+	(ENHIB | ((uint16_t)(enter) << 12) | ((uint16_t)(thr) << 8) | ((exit) << 3) | (scalar))
+
+// Hibernate profiles
+#define MAX_HIB_STORAGE		0
+#define MAX_HIB_IDLE		1
+#define MAX_HIB_ACTIVE		2
+#define MAX_HIB_PROFILES	3
+
+#define MAX_HIB_STORAGE_DEFAULT	MAX_HIBCFG(0, 4, 3, 7)	// C/12.8h, 45s updates
+#define MAX_HIB_IDLE_DEFAULT	MAX_HIBCFG(0, 7, 1, 4)	// POR value 0x870C
+#define MAX_HIB_ACTIVE_DEFAULT	0x0000					// never hibernate
+
+// Scheduler thresholds
+#define MAX_HIB_ACTIVE_MA		20		// |AvgCurrent| for active profile
+#define MAX_HIB_STORAGE_WAKES	60		// quiet wakes (~1h) before storage
+
+void max_setHibProfile(uint8_t profile, uint16_t hibcfg);
+uint16_t max_getHibProfile(uint8_t profile);
+uint8_t max_selectHibProfile(uint8_t profile);
+uint8_t max_hibProfile(void);
+void max_hibSchedule(void);
+void max_hibRestore(void);
+void max_hibReset(void);
+
+
+
+
+// Custom model loader, errors past the i2c codes
+#define MAX_MODEL_ERR_EMPTY		0x10	// no model set or id 0
+#define MAX_MODEL_ERR_VERIFY	0x11	// readback mismatch after retries
+#define MAX_MODEL_ERR_LOCK		0x12	// model area readable after lock
+#define MAX_MODEL_ATTEMPTS		2
+#define MAX_REFRESH_POLLS		100		// x 10ms, bound on ModelCfg.Refresh wait
+
+extern const Max17263_model_t cell_model;
+
+void max_setModel(const Max17263_model_t* model);
+uint8_t max_loadModel(void);
+
+
+
+
+// Cell profiles, index persisted in EEPROM
+extern const Max17263_profile_t cell_profiles[];
+extern const uint8_t cell_profile_count;
+
+void max_applyProfile(const Max17263_profile_t* profile);
+void max_loadProfile(uint8_t index);
+uint8_t max_profileSelected(void);
+void max_selectProfile(uint8_t index);
 
 
 
@@ -132,8 +289,19 @@ void max_setDLED(uint8_t dled);
 
 
 
+// Target mode register file, indexed by gauge register
+// address so a host reads the same map as the MAX17263
+#define MAX_TARGET_REGS		0x40
+extern INSTANCE_LOCAL volatile uint16_t max_target_regs[MAX_TARGET_REGS];
+
+
+
+
 // max17263 functionality
 void max_readFuelGauge(void);
+uint8_t max_readSnapshot(Max17263_snapshot_t* snap);
+void max_targetUpdate(void);
+void max_sbsUpdate(void);
 void max_saveLearnedParameters(void);
 uint16_t max_checkPOR(void);
 uint8_t max_checkCycles(void);
@@ -152,6 +320,28 @@ uint8_t max_checkCycles(void);
 #define EEPROM_Cycles_ADDR			0x0008
 #define EEPROM_FullCapNom_ADDR		0x000A
 
+// HibCfg profiles, one word each, 0xFFFF keeps default
+#define EEPROM_HibCfg_ADDR			0x000C
+
+// Cell profile index, 0xFF (erased) selects profile 0
+#define EEPROM_Profile_ADDR			0x0012
+
+// Layout version, reads 0xFF on images older than the
+// version byte (layout 1). Bump on every layout change
+// and describe it in ee_layouts[] (max17263_eeprom.c)
+#define EEPROM_Version_ADDR			0x0013
+#define EEPROM_LAYOUT_VERSION		2
+
+// Layout descriptor, one per version
+typedef struct ee_layout_t{
+	uint8_t version;
+	void (*migrate)(void);				// upgrade from previous layout, NULL when append only
+}Ee_layout_t;
+
+// layout header check and in place upgrade
+uint8_t max_eepromOpen(void);
+uint8_t max_eepromVersion(void);
+
 // max17263 save/load functions
 void max_eepromSaveParameters(void);
 void max_eepromLoadParameters(void);
@@ -170,6 +360,7 @@ void max_eepromLoadParameters(void);
 #define DEBUG_EEPROM_CODE			0xEEEE
 #define DEBUG_EEPROM_INIT_CODE		0xAABB
 #define DEBUG_FUEL_GAUGE_CODE		0xCCDD
+#define DEBUG_SNAPSHOT_CODE			0xADAD
 
 // debugging functions
 void max_debugRead(uint8_t addr, uint8_t reg);
@@ -177,6 +368,7 @@ void max_debugWrite(uint8_t addr, uint16_t data);
 void max_debugWriteCode(uint8_t addr, uint16_t code, uint16_t data);
 void max_debugDataStruct(void);
 void max_debugFuelGauge(void);
+void max_debugSnapshot(void);
 void max_debugEEPROM(void);
 void max_debugLED(void);
 
@@ -0,0 +1,169 @@
+/*
+ * max17263_cache.c
+ *
+ * Created: 10/19/2026 7:18:00 AM
+ */ 
+
+
+#include "stddef.h"
+#include "max17263.h"
+
+
+// Cached register entry
+typedef struct {
+	uint8_t  reg;
+	uint8_t  valid;
+	uint16_t value;
+	uint32_t stamp;		// tb_millis() at read
+}max_cache_t;
+
+// Registers only updated on the gauge task period
+static INSTANCE_LOCAL max_cache_t max_cache[] = {
+	{ .reg = RepCap_REG_ADDR },
+	{ .reg = RepSOC_REG_ADDR },
+	{ .reg = TTE_REG_ADDR },
+	{ .reg = TTF_REG_ADDR },
+	{ .reg = FullCapRep_REG_ADDR },
+	{ .reg = FullCapNom_REG_ADDR },
+	{ .reg = Cycles_REG_ADDR },
+	{ .reg = RCOMP0_REG_ADDR },
+	{ .reg = TempCo_REG_ADDR },
+};
+
+#define MAX_CACHE_SIZE	(sizeof(max_cache) / sizeof(max_cache[0]))
+
+static INSTANCE_LOCAL uint16_t max_cache_ttl = MAX_TASK_PERIOD_MS;
+
+
+/***********************************************************
+ *
+ * Find cache entry for register
+ *
+ * @returns : entry pointer, NULL if register not cached
+ *
+ ***********************************************************/
+static max_cache_t* max_cacheFind(uint8_t reg) {
+	for (uint8_t i = 0; i < MAX_CACHE_SIZE; i++) {
+		if (max_cache[i].reg == reg) {
+			return &max_cache[i];
+		}
+	}
+	return NULL;
+}
+
+
+/***********************************************************
+ *
+ * Read register through cache. Served from RAM while the
+ * last bus read is younger than one gauge task period,
+ * uncached registers always go to the bus. Failed reads
+ * are never cached.
+ *
+ * @param reg  : register address to be read
+ * @param data : register value, untouched on error
+ *
+ * @returns    : 0 on success, otherwise i2c error code
+ *
+ ***********************************************************/
+uint8_t max_tryReadRegisterCached(uint8_t reg, uint16_t* data) {
+	
+	max_cache_t* entry = max_cacheFind(reg);
+	if (entry == NULL) {
+		return max_tryReadRegister(reg, data);
+	}
+	
+	uint32_t now = tb_millis();
+	if (entry->valid && ((now - entry->stamp) < max_cache_ttl)) {
+		*data = entry->value;
+		return 0;
+	}
+	
+	uint8_t err = max_tryReadRegister(reg, data);
+	if (err == 0) {
+		entry->value = *data;
+		entry->stamp = now;
+		entry->valid = 1;
+	}
+	return err;
+}
+
+
+/***********************************************************
+ *
+ * Read register through cache
+ * Returns 0 on bus error, see max_tryReadRegisterCached()
+ *
+ * @param reg : register address to be read
+ *
+ ***********************************************************/
+uint16_t max_readRegisterCached(uint8_t reg) {
+	uint16_t data = 0;
+	max_tryReadRegisterCached(reg, &data);
+	return data;
+}
+
+
+/***********************************************************
+ *
+ * Drop cached value, next read goes to the bus
+ * Called on every register write
+ *
+ * @param reg : register address
+ *
+ ***********************************************************/
+void max_cacheInvalidate(uint8_t reg) {
+	max_cache_t* entry = max_cacheFind(reg);
+	if (entry != NULL) {
+		entry->valid = 0;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Drop all cached values (POR, config reload)
+ *
+ ***********************************************************/
+void max_cacheInvalidateAll(void) {
+	for (uint8_t i = 0; i < MAX_CACHE_SIZE; i++) {
+		max_cache[i].valid = 0;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Set cache lifetime from gauge update cadence
+ * Active task period is 175.8ms. In hibernate the gauge
+ * only updates every 351ms * 2^HibScalar. Only pass
+ * true for a gauge that reports Status2.Hib, a profile
+ * with ENHIB set does not mean it has entered hibernate
+ *
+ * @param hibernate : gauge is hibernating
+ *
+ ***********************************************************/
+void max_cacheSetHibernate(bool hibernate) {
+	if (hibernate && (max17263.HibCfg & ENHIB)) {
+		max_cache_ttl = MAX_HIB_PERIOD_MS << (max17263.HibCfg & HibCfg_HibScalar);
+	}
+	else {
+		max_cache_ttl = MAX_TASK_PERIOD_MS;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Follow the gauge's own hibernate state (Status2.Hib),
+ * read once per wake before any cached register. On a
+ * failed read the active period is used.
+ *
+ * @returns : 0 on success, otherwise i2c error code
+ *
+ ***********************************************************/
+uint8_t max_cacheSyncHibernate(void) {
+	uint16_t status2 = 0;
+	uint8_t err = max_tryReadRegister(Status2_REG_ADDR, &status2);
+	max_cacheSetHibernate((err == 0) && (status2 & Status2_Hib));
+	return err;
+}
@@ -0,0 +1,100 @@
+/*
+ * max17263_eeprom.c
+ *
+ * Created: 10/19/2026 8:05:54 AM
+ */ 
+
+
+#include "stddef.h"
+#include "avr/pgmspace.h"
+#include "max17263.h"
+
+
+/***********************************************************
+ *
+ * Every layout this firmware can upgrade from, oldest
+ * first, last entry is EEPROM_LAYOUT_VERSION.
+ *
+ * Layouts grow by appending fields at addresses older
+ * firmware never wrote, with the erased value (0xFF)
+ * meaning default, so an append step rewrites nothing.
+ * Moving or reformatting a field needs a migrate step.
+ * Steps are replayed after a torn upgrade so must be
+ * safe to run twice, and should leave fields an older
+ * firmware reads where it expects them, older firmware
+ * uses a newer layout as is.
+ *
+ ***********************************************************/
+static const Ee_layout_t ee_layouts[] PROGMEM = {
+	
+	// 1: check word, learned parameters 0x0002-0x000B
+	{ 1, NULL },
+	
+	// 2: HibCfg profiles, cell profile index, version byte
+	{ 2, NULL },
+};
+
+#define EE_LAYOUTS	(sizeof(ee_layouts) / sizeof(ee_layouts[0]))
+
+
+/***********************************************************
+ *
+ * Layout version stored in EEPROM
+ *
+ * @returns : version, 1 for images without a version byte
+ *
+ ***********************************************************/
+uint8_t max_eepromVersion(void) {
+	uint8_t version = (uint8_t)(ee_readWord(EEPROM_Version_ADDR) & 0x00FF);
+	return (version == 0xFF) ? 1 : version;
+}
+
+
+/***********************************************************
+ *
+ * Validate EEPROM header before learned parameters are
+ * loaded.
+ *
+ * Blank EEPROM gets the current header, version before
+ * check word so a reset part way starts over. Appended
+ * fields are left alone, a cell profile index programmed
+ * before first boot survives.
+ *
+ * Older layouts run each migrate step in turn, the
+ * version byte is queued after the step's writes so a
+ * reset part way repeats the upgrade. Untouched bytes
+ * are never rewritten, the queue skips equal values.
+ *
+ * @returns : 1 when no saved parameters exist, 0 otherwise
+ *
+ ***********************************************************/
+uint8_t max_eepromOpen(void) {
+	
+	Ee_layout_t layout;
+	
+	// no saved parameters, start from current layout
+	if (ee_readWord(EEPROM_CHECK_ADDR) != EEPROM_CHECK_VAL) {
+		ee_writeByte(EEPROM_Version_ADDR, EEPROM_LAYOUT_VERSION);
+		ee_writeWord(EEPROM_CHECK_ADDR, EEPROM_CHECK_VAL);
+		return 1;
+	}
+	
+	// current, or newer from a firmware downgrade
+	uint8_t version = max_eepromVersion();
+	if (version >= EEPROM_LAYOUT_VERSION) {
+		return 0;
+	}
+	
+	for (uint8_t i = 0; i < EE_LAYOUTS; i++) {
+		memcpy_P(&layout, &ee_layouts[i], sizeof(layout));
+		if (layout.version <= version) {
+			continue;
+		}
+		if (layout.migrate != NULL) {
+			layout.migrate();
+		}
+		ee_writeByte(EEPROM_Version_ADDR, layout.version);
+	}
+	
+	return 0;
+}
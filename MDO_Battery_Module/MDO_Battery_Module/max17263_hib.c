@@ -0,0 +1,163 @@
+/*
+ * max17263_hib.c
+ *
+ * Created: 10/19/2026 7:57:58 AM
+ */ 
+
+
+#include "stdlib.h"
+#include "max17263.h"
+
+
+// HibCfg per profile, EEPROM copies override at config load
+static INSTANCE_LOCAL uint16_t max_hib_profiles[MAX_HIB_PROFILES] = {
+	[MAX_HIB_STORAGE] = MAX_HIB_STORAGE_DEFAULT,
+	[MAX_HIB_IDLE]	  = MAX_HIB_IDLE_DEFAULT,
+	[MAX_HIB_ACTIVE]  = MAX_HIB_ACTIVE_DEFAULT,
+};
+
+static INSTANCE_LOCAL uint8_t max_hib_profile = MAX_HIB_IDLE;
+static INSTANCE_LOCAL uint16_t max_hib_quiet = 0;		// wakes below MAX_HIB_ACTIVE_MA
+
+
+/***********************************************************
+ *
+ * Profiles back to build defaults, selection to idle
+ *
+ ***********************************************************/
+void max_hibReset(void) {
+	max_hib_profiles[MAX_HIB_STORAGE] = MAX_HIB_STORAGE_DEFAULT;
+	max_hib_profiles[MAX_HIB_IDLE] = MAX_HIB_IDLE_DEFAULT;
+	max_hib_profiles[MAX_HIB_ACTIVE] = MAX_HIB_ACTIVE_DEFAULT;
+	max_hib_profile = MAX_HIB_IDLE;
+	max_hib_quiet = 0;
+}
+
+
+/***********************************************************
+ *
+ * Set and persist HibCfg for a profile. Applied straight
+ * away when the profile is selected.
+ *
+ * @param profile : MAX_HIB_STORAGE, _IDLE or _ACTIVE
+ * @param hibcfg  : register value, see MAX_HIBCFG()
+ *
+ ***********************************************************/
+void max_setHibProfile(uint8_t profile, uint16_t hibcfg) {
+	if (profile >= MAX_HIB_PROFILES) {
+		return;
+	}
+	max_hib_profiles[profile] = hibcfg;
+	ee_writeWord(EEPROM_HibCfg_ADDR + 2 * profile, hibcfg);
+	if (profile == max_hib_profile) {
+		max_selectHibProfile(profile);
+	}
+}
+
+
+uint16_t max_getHibProfile(uint8_t profile) {
+	if (profile >= MAX_HIB_PROFILES) {
+		return 0;
+	}
+	return max_hib_profiles[profile];
+}
+
+
+uint8_t max_hibProfile(void) {
+	return max_hib_profile;
+}
+
+
+/***********************************************************
+ *
+ * Write profile to HibCfg. Leaving hibernate (ENHIB clear)
+ * is forced with a soft wakeup so the gauge is back on
+ * the active task period before the next read.
+ *
+ * @param profile : MAX_HIB_STORAGE, _IDLE or _ACTIVE
+ *
+ * @returns       : 0 on success, otherwise i2c error code
+ *
+ ***********************************************************/
+uint8_t max_selectHibProfile(uint8_t profile) {
+	
+	if (profile >= MAX_HIB_PROFILES) {
+		return 0;
+	}
+	
+	uint16_t hibcfg = max_hib_profiles[profile];
+	bool wake = !(hibcfg & ENHIB) && (max17263.HibCfg & ENHIB);
+	
+	if (wake) {
+		max_writeRegister(SoftWakeup_REG_ADDR, SoftWakeup_SOFT);
+	}
+	uint8_t err = max_writeRegister(HibCfg_REG_ADDR, hibcfg);
+	if (wake) {
+		max_writeRegister(SoftWakeup_REG_ADDR, SoftWakeup_CLEAR);
+	}
+	if (err != 0) {
+		return err;
+	}
+	
+	max17263.HibCfg = hibcfg;
+	max_hib_profile = profile;
+	if (!(hibcfg & ENHIB)) {
+		max_cacheSetHibernate(false);	// woken above, entering is polled
+	}
+	return 0;
+}
+
+
+/***********************************************************
+ *
+ * Load persisted profiles, erased words keep defaults,
+ * then write the selected profile. Called at the end of
+ * max_loadConfig() in place of the POR HibCfg.
+ *
+ ***********************************************************/
+void max_hibRestore(void) {
+	for (uint8_t i = 0; i < MAX_HIB_PROFILES; i++) {
+		uint16_t hibcfg = ee_readWord(EEPROM_HibCfg_ADDR + 2 * i);
+		if (hibcfg != 0xFFFF) {
+			max_hib_profiles[i] = hibcfg;
+		}
+	}
+	max17263.HibCfg = 0x0000;		// hibernate left for config
+	max_selectHibProfile(max_hib_profile);
+}
+
+
+/***********************************************************
+ *
+ * Pick profile from load once per wake. Above
+ * MAX_HIB_ACTIVE_MA the gauge stays active, below it idle
+ * until MAX_HIB_STORAGE_WAKES quiet wakes in a row, then
+ * storage. Only a profile change touches HibCfg.
+ *
+ ***********************************************************/
+void max_hibSchedule(void) {
+	
+	uint16_t avg;
+	if (max_tryReadRegister(AvgCurrent_REG_ADDR, &avg) != 0) {
+		return;
+	}
+	
+	// 1.5625uV / rsense per LSB
+	int32_t active = (int32_t)MAX_HIB_ACTIVE_MA * max17263.rsense * 64 / 100;
+	uint8_t profile;
+	
+	if (labs((int16_t)avg) >= active) {
+		max_hib_quiet = 0;
+		profile = MAX_HIB_ACTIVE;
+	}
+	else {
+		if (max_hib_quiet < MAX_HIB_STORAGE_WAKES) {
+			max_hib_quiet++;
+		}
+		profile = (max_hib_quiet >= MAX_HIB_STORAGE_WAKES) ? MAX_HIB_STORAGE : MAX_HIB_IDLE;
+	}
+	
+	if (profile != max_hib_profile) {
+		max_selectHibProfile(profile);
+	}
+}
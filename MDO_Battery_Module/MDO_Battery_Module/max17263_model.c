@@ -0,0 +1,150 @@
+/*
+ * max17263_model.c
+ *
+ * Created: 10/19/2026 8:00:34 AM
+ */ 
+
+
+#include "stddef.h"
+#include "avr/pgmspace.h"
+#include "max17263.h"
+
+
+// Model loaded by max_loadConfig(), NULL for EZ config
+static INSTANCE_LOCAL const Max17263_model_t* max_model = NULL;
+
+// Burst size for model area transfers, the longest
+// burst max_tryReadBurst()/max_writeBurst() accept
+#define MAX_MODEL_BURST		MAX_BURST_WORDS
+
+
+/***********************************************************
+ *
+ * Select characterised model used at the next config load
+ *
+ * @param model : flash resident model, NULL for EZ config
+ *
+ ***********************************************************/
+void max_setModel(const Max17263_model_t* model) {
+	max_model = model;
+}
+
+
+/***********************************************************
+ *
+ * Burst write words straight from flash
+ *
+ ***********************************************************/
+static uint8_t max_modelWrite(uint8_t reg, const uint16_t* flash, uint8_t words) {
+	uint16_t data[MAX_MODEL_BURST];
+	for (uint8_t i = 0; i < words; i++) {
+		data[i] = pgm_read_word(&flash[i]);
+	}
+	return max_writeBurst(reg, data, words);
+}
+
+
+/***********************************************************
+ *
+ * Read back and compare against flash
+ *
+ * @returns : 0 on match, MAX_MODEL_ERR_VERIFY on mismatch,
+ *            otherwise i2c error code
+ *
+ ***********************************************************/
+static uint8_t max_modelVerify(uint8_t reg, const uint16_t* flash, uint8_t words) {
+	uint16_t data[MAX_MODEL_BURST];
+	uint8_t err = max_tryReadBurst(reg, data, words);
+	if (err != 0) {
+		return err;
+	}
+	for (uint8_t i = 0; i < words; i++) {
+		if (data[i] != pgm_read_word(&flash[i])) {
+			return MAX_MODEL_ERR_VERIFY;
+		}
+	}
+	return 0;
+}
+
+
+static uint8_t max_modelLock(bool unlock) {
+	uint16_t keys[2] = { 0x0000, 0x0000 };
+	if (unlock) {
+		keys[0] = ModelUnlock1_KEY;
+		keys[1] = ModelUnlock2_KEY;
+	}
+	return max_writeBurst(ModelUnlock1_REG_ADDR, keys, 2);
+}
+
+
+/***********************************************************
+ *
+ * Load the selected characterised model. Table written in
+ * three 16 word bursts with the area unlocked, read back
+ * once, rewritten only on mismatch, then locked. Lock is
+ * confirmed by all 48 table words reading zero. RCOMP0,
+ * TempCo and QRTable follow, learned values restored by
+ * max_loadConfig() overwrite RCOMP0 and TempCo.
+ *
+ * The gauge only takes the table up at the ModelCfg
+ * refresh max_loadConfig() issues next. About 20ms of
+ * bus time at 100kHz.
+ *
+ * @returns : 0 on success, MAX_MODEL_ERR_* or i2c error
+ *            code, area left locked on any failure
+ *
+ ***********************************************************/
+uint8_t max_loadModel(void) {
+	
+	const Max17263_model_t* model = max_model;
+	if ((model == NULL) || (pgm_read_word(&model->id) == 0)) {
+		return MAX_MODEL_ERR_EMPTY;
+	}
+	
+	uint8_t err = max_modelLock(true);
+	uint8_t attempt = 0;
+	while (err == 0) {
+		for (uint8_t i = 0; (err == 0) && (i < Model_WORDS); i += MAX_MODEL_BURST) {
+			err = max_modelWrite(Model_REG_ADDR + i, &model->table[i], MAX_MODEL_BURST);
+		}
+		for (uint8_t i = 0; (err == 0) && (i < Model_WORDS); i += MAX_MODEL_BURST) {
+			err = max_modelVerify(Model_REG_ADDR + i, &model->table[i], MAX_MODEL_BURST);
+		}
+		if ((err != MAX_MODEL_ERR_VERIFY) || (++attempt >= MAX_MODEL_ATTEMPTS)) {
+			break;
+		}
+		err = 0;
+	}
+	
+	// always relock, keep first error
+	uint8_t lock_err = max_modelLock(false);
+	if (err != 0) {
+		return err;
+	}
+	if (lock_err != 0) {
+		return lock_err;
+	}
+	
+	// locked area reads back zero throughout
+	for (uint8_t i = 0; i < Model_WORDS; i += MAX_MODEL_BURST) {
+		uint16_t data[MAX_MODEL_BURST];
+		err = max_tryReadBurst(Model_REG_ADDR + i, data, MAX_MODEL_BURST);
+		if (err != 0) {
+			return err;
+		}
+		for (uint8_t w = 0; w < MAX_MODEL_BURST; w++) {
+			if (data[w] != 0) {
+				return MAX_MODEL_ERR_LOCK;
+			}
+		}
+	}
+	
+	uint16_t rcomp[2] = {
+		pgm_read_word(&model->RCOMP0), pgm_read_word(&model->TempCo)
+	};
+	err = max_writeBurst(RCOMP0_REG_ADDR, rcomp, 2);
+	for (uint8_t i = 0; (err == 0) && (i < 4); i++) {
+		err = max_writeRegister(QRTable00_REG_ADDR + 0x10 * i, pgm_read_word(&model->QRTable[i]));
+	}
+	return err;
+}
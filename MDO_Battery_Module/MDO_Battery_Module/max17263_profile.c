@@ -0,0 +1,78 @@
+/*
+ * max17263_profile.c
+ *
+ * Created: 10/19/2026 8:03:02 AM
+ */ 
+
+
+#include "stddef.h"
+#include "avr/pgmspace.h"
+#include "max17263.h"
+
+
+/***********************************************************
+ *
+ * Take cell configuration from profile. Raw register
+ * values copied into the data struct, written to the
+ * gauge by max_loadConfig().
+ *
+ * @param profile : profile in RAM
+ *
+ ***********************************************************/
+void max_applyProfile(const Max17263_profile_t* profile) {
+	max17263.rsense = profile->rsense;
+	max17263.DesignCap.value = profile->DesignCap;
+	max17263.IChgTerm.value = profile->IChgTerm;
+	max17263.VEmpty.value = profile->VEmpty;
+	max17263.ModelCfg.value = profile->ModelCfg;
+	max17263.LEDCfg1.value = profile->LEDCfg1;
+	max17263.LEDCfg2.value = profile->LEDCfg2;
+	max17263.LEDCfg3.value = profile->LEDCfg3;
+	max_setModel(profile->model);
+}
+
+
+/***********************************************************
+ *
+ * Copy profile out of the flash table and apply it
+ *
+ * @param index : cell_profiles[] entry, out of range
+ *                falls back to profile 0
+ *
+ ***********************************************************/
+void max_loadProfile(uint8_t index) {
+	Max17263_profile_t profile;
+	if (index >= cell_profile_count) {
+		index = 0;
+	}
+	memcpy_P(&profile, &cell_profiles[index], sizeof(profile));
+	max_applyProfile(&profile);
+}
+
+
+/***********************************************************
+ *
+ * Profile index stored in EEPROM
+ *
+ * @returns : index, 0 when erased or out of range
+ *
+ ***********************************************************/
+uint8_t max_profileSelected(void) {
+	uint8_t index = (uint8_t)(ee_readWord(EEPROM_Profile_ADDR) & 0x00FF);
+	return (index < cell_profile_count) ? index : 0;
+}
+
+
+/***********************************************************
+ *
+ * Persist profile index, used from the next boot. Call
+ * max_loadProfile() and max_loadConfig() to switch now.
+ *
+ * @param index : cell_profiles[] entry
+ *
+ ***********************************************************/
+void max_selectProfile(uint8_t index) {
+	if (index < cell_profile_count) {
+		ee_writeByte(EEPROM_Profile_ADDR, index);
+	}
+}
@@ -189,6 +189,15 @@ extern volatile __LEDCfg3_t LEDCfg3;
 #define	HIBSCALAR_2			  (1 << 2)
 #define	HIBSCALAR_1			  (1 << 1)
 #define	HIBSCALAR_0			  (1 << 0)
+#define HibCfg_HibScalar	(HIBSCALAR_2 | HIBSCALAR_1 | HIBSCALAR_0)
+
+/***********************************************************
+ *
+ * Status2, Hib set while the gauge is in hibernate
+ *
+ ***********************************************************/
+#define Status2_REG_ADDR	0xB0
+#define Status2_Hib			  (1 << 1)
 
 /***********************************************************
  *
@@ -202,6 +211,47 @@ extern volatile __LEDCfg3_t LEDCfg3;
 
 
 
+/***********************************************************/
+/***********************************************************
+ *
+ *
+ *            CUSTOM MODEL REGISTERS
+ *
+ *
+ ***********************************************************/
+/***********************************************************
+ *
+ * Model area access, both keys written to unlock, both
+ * cleared to lock. Locked model area reads back zero.
+ *
+ ***********************************************************/
+#define ModelUnlock1_REG_ADDR	0x62
+#define ModelUnlock2_REG_ADDR	0x63
+#define ModelUnlock1_KEY		0x0059
+#define ModelUnlock2_KEY		0x00C4
+
+/***********************************************************
+ *
+ * Characterisation tables (OCV, X, RComp segments),
+ * 48 words from 0x80 to 0xAF, lost on POR
+ *
+ ***********************************************************/
+#define Model_REG_ADDR			0x80
+#define Model_WORDS				48
+
+/***********************************************************
+ *
+ * Empty compensation, one per temperature segment
+ *
+ ***********************************************************/
+#define QRTable00_REG_ADDR		0x12
+#define QRTable10_REG_ADDR		0x22
+#define QRTable20_REG_ADDR		0x32
+#define QRTable30_REG_ADDR		0x42
+
+
+
+
 /***********************************************************/
 /***********************************************************
  *
@@ -269,9 +319,10 @@ extern volatile __LEDCfg3_t LEDCfg3;
 /***********************************************************
  *
  * Reported state-of-charge percentage register
+ * 1/256 % per LSB (UG6595, 0x10 is FullCapRep)
  *
  ***********************************************************/
-#define RepSOC_REG_ADDR			0x10
+#define RepSOC_REG_ADDR			0x06
 
 /***********************************************************
  *
@@ -290,6 +341,61 @@ extern volatile __LEDCfg3_t LEDCfg3;
 
 
 
+/***********************************************************/
+/***********************************************************
+ *
+ *
+ *            MEASUREMENT REGISTERS
+ *
+ *
+ ***********************************************************/
+/***********************************************************
+ *
+ * Die or thermistor temperature, signed 1/256 C per LSB
+ *
+ ***********************************************************/
+#define Temp_REG_ADDR			0x08
+
+/***********************************************************
+ *
+ * Instantaneous current, signed 1.5625uV / rsense per LSB
+ *
+ ***********************************************************/
+#define Current_REG_ADDR		0x0A
+
+/***********************************************************
+ *
+ * Filtered current, same scale as Current
+ *
+ ***********************************************************/
+#define AvgCurrent_REG_ADDR		0x0B
+
+/***********************************************************
+ *
+ * Cell voltage, 78.125uV per LSB
+ *
+ ***********************************************************/
+#define VCell_REG_ADDR			0x09
+
+/***********************************************************
+ *
+ * Filtered cell voltage, same scale as VCell
+ *
+ ***********************************************************/
+#define AvgVCell_REG_ADDR		0x19
+
+/***********************************************************
+ *
+ * Max (high byte) and min (low byte) Temp since POR,
+ * signed 1 C per LSB
+ *
+ ***********************************************************/
+#define MaxMinTemp_REG_ADDR		0x1A
+#define MaxMinTemp_DEFAULT		0x807F
+
+
+
+
 /***********************************************************/
 /***********************************************************
  *
@@ -0,0 +1,128 @@
+/*
+ * max17263_status.c
+ *
+ * Created: 10/19/2026 7:55:32 AM
+ */ 
+
+
+#include "stddef.h"
+#include "max17263.h"
+
+
+// Registered Status handler
+typedef struct {
+	uint16_t mask;
+	uint8_t  flags;
+	Max_status_handler_t handler;
+}max_status_entry_t;
+
+static INSTANCE_LOCAL max_status_entry_t max_status_handlers[MAX_STATUS_HANDLERS];
+static INSTANCE_LOCAL uint8_t max_status_count = 0;
+
+// Status as left after the last poll, serviced bits cleared
+static INSTANCE_LOCAL uint16_t max_status_last = 0;
+
+
+/***********************************************************
+ *
+ * Register handler for Status bits. Edges are taken
+ * against the previous poll, level triggers fire on every
+ * poll the bit is set.
+ *
+ * @param mask    : Status bits (Smx, Tmx ... POR)
+ * @param flags   : MAX_STATUS_RISE, _FALL, _LEVEL, and
+ *                  MAX_STATUS_CLEAR to have the engine
+ *                  clear the bits once dispatched
+ * @param handler : called with triggering bits and Status
+ *
+ * @returns       : 0 on success, 1 if the table is full
+ *
+ ***********************************************************/
+uint8_t max_statusOn(uint16_t mask, uint8_t flags, Max_status_handler_t handler) {
+	if (max_status_count >= MAX_STATUS_HANDLERS) {
+		return 1;
+	}
+	max_status_handlers[max_status_count].mask = mask;
+	max_status_handlers[max_status_count].flags = flags;
+	max_status_handlers[max_status_count].handler = handler;
+	max_status_count++;
+	return 0;
+}
+
+
+/***********************************************************
+ *
+ * Drop all handlers and forget the previous Status
+ *
+ ***********************************************************/
+void max_statusReset(void) {
+	max_status_count = 0;
+	max_status_last = 0;
+}
+
+
+/***********************************************************
+ *
+ * Status after the last poll, serviced bits cleared
+ *
+ ***********************************************************/
+uint16_t max_statusLast(void) {
+	return max_status_last;
+}
+
+
+/***********************************************************
+ *
+ * Read Status once, clear serviced bits in a single write
+ * and dispatch handlers. The clear goes out straight after
+ * the read so an alert latching in between is not lost to
+ * a stale read-modify-write. Handlers run after the write
+ * and may use the bus (POR -> max_loadConfig()).
+ *
+ * @returns : 0 on success, otherwise i2c error code of the
+ *            Status read, nothing dispatched
+ *
+ ***********************************************************/
+uint8_t max_statusPoll(void) {
+	
+	uint16_t status;
+	uint16_t clear = 0;
+	uint8_t err = max_tryReadRegister(Status_REG_ADDR, &status);
+	if (err != 0) {
+		return err;
+	}
+	
+	uint16_t rising = status & ~max_status_last;
+	uint16_t falling = ~status & max_status_last;
+	
+	for (uint8_t i = 0; i < max_status_count; i++) {
+		if (max_status_handlers[i].flags & MAX_STATUS_CLEAR) {
+			clear |= status & max_status_handlers[i].mask;
+		}
+	}
+	
+	// failed clear leaves bits set, retried next poll
+	max_status_last = status;
+	if ((clear != 0) && (max_writeRegister(Status_REG_ADDR, status & ~clear) == 0)) {
+		max_status_last = status & ~clear;
+	}
+	
+	for (uint8_t i = 0; i < max_status_count; i++) {
+		max_status_entry_t* entry = &max_status_handlers[i];
+		uint16_t bits = 0;
+		if (entry->flags & MAX_STATUS_RISE) {
+			bits |= rising;
+		}
+		if (entry->flags & MAX_STATUS_FALL) {
+			bits |= falling;
+		}
+		if (entry->flags & MAX_STATUS_LEVEL) {
+			bits |= status;
+		}
+		bits &= entry->mask;
+		if (bits != 0) {
+			entry->handler(bits, status);
+		}
+	}
+	return 0;
+}
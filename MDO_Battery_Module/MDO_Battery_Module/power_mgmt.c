@@ -0,0 +1,158 @@
+/*
+ * power_mgmt.c
+ *
+ * Created: 10/19/2026 7:15:10 AM
+ */ 
+
+#include "power_mgmt.h"
+
+INSTANCE_LOCAL volatile Pwr_stats_t pwr_stats;
+
+
+/***********************************************************
+ *
+ * Cycle counter for gate transition profiling
+ * Timer1 is only powered for the measurement itself
+ *
+ ***********************************************************/
+#ifdef PWR_PROFILE
+static void pwr_profileStart(void) {
+	power_timer1_enable();
+	TCCR1A = 0;
+	TCNT1  = 0;
+	TCCR1B = _BV(CS10);		// clk/1
+}
+
+static uint16_t pwr_profileStop(void) {
+	uint16_t cycles = TCNT1;
+	TCCR1B = 0;
+	power_timer1_disable();
+	return cycles;
+}
+#endif
+
+
+/***********************************************************
+ *
+ * Shut down every on chip peripheral not needed while
+ * sleeping. Modules are re-enabled individually only
+ * for the duration of their use.
+ *
+ * Analog comparator and ADC digital input buffers are not
+ * covered by PRR0/PRR1 and are disabled here directly
+ *
+ ***********************************************************/
+void pwr_init(void) {
+	
+	// ADC off before gating clock, disable analog comparator
+	ADCSRA = 0;
+	ACSR   = _BV(ACD);
+	
+	// unused analog pins, disable digital input buffers
+	DIDR0 = 0xF3;	// ADC0-1, ADC4-7
+	DIDR1 = 0x01;	// AIN0
+	DIDR2 = 0x3F;	// ADC8-13
+	
+	// detach USB, stop PLL and USB pad regulator
+	UDCON  |= _BV(DETACH);
+	USBCON  = _BV(FRZCLK);
+	PLLCSR  = 0;
+	UHWCON &= ~_BV(UVREGE);
+	
+	// gate ADC, SPI, TWI, USART1, USB and all timers
+	power_all_disable();
+}
+
+
+/***********************************************************
+ *
+ * Power up TWI for gauge transactions
+ * Module state is lost while gated so the bit rate is
+ * reloaded through i2c_resume()
+ *
+ ***********************************************************/
+void pwr_twiEnable(void) {
+	
+	#ifdef PWR_PROFILE
+		pwr_profileStart();
+	#endif
+	
+	power_twi_enable();
+	i2c_resume();
+	
+	#ifdef PWR_PROFILE
+		pwr_stats.twi_enable_cycles = pwr_profileStop();
+		if (pwr_stats.twi_enable_cycles > pwr_stats.twi_enable_max)
+			pwr_stats.twi_enable_max = pwr_stats.twi_enable_cycles;
+	#endif
+	
+	pwr_stats.twi_enables++;
+}
+
+
+/***********************************************************
+ *
+ * Release the bus and gate TWI clock
+ * TWI stays powered while serving as I2C target
+ *
+ ***********************************************************/
+void pwr_twiDisable(void) {
+	
+	if (i2c_target_enabled()) {
+		return;
+	}
+	
+	#ifdef PWR_PROFILE
+		pwr_profileStart();
+	#endif
+	
+	i2c_disable();
+	power_twi_disable();
+	
+	#ifdef PWR_PROFILE
+		pwr_stats.twi_disable_cycles = pwr_profileStop();
+		if (pwr_stats.twi_disable_cycles > pwr_stats.twi_disable_max)
+			pwr_stats.twi_disable_max = pwr_stats.twi_disable_cycles;
+	#endif
+	
+	pwr_stats.twi_disables++;
+}
+
+
+/***********************************************************
+ *
+ * Check TWI power state
+ *
+ * @returns : true when TWI clock is running
+ *
+ ***********************************************************/
+bool pwr_twiEnabled(void) {
+	return !(PRR0 & _BV(PRTWI));
+}
+
+
+/***********************************************************
+ *
+ * Transmit power stats to debug receiver
+ * Sent as single data stream with parse code
+ *
+ * @param addr : i2c address for receiver
+ *
+ ***********************************************************/
+void pwr_debugStats(uint8_t addr) {
+	
+	uint8_t buffer[14];
+	uint16_t data[] = {
+		DEBUG_POWER_CODE,
+		pwr_stats.twi_enables, pwr_stats.twi_disables,
+		pwr_stats.twi_enable_cycles, pwr_stats.twi_disable_cycles,
+		pwr_stats.twi_enable_max, pwr_stats.twi_disable_max
+	};
+	
+	for(uint8_t i = 0; i < 14; i+=2) {
+		buffer[i] = (uint8_t)(data[i/2] & 0x00FF);
+		buffer[i+1] = (uint8_t)((data[i/2] >> 8) & 0x00FF);
+	}
+	
+	i2c_controller_transmit(addr, buffer, 14, I2C_NO_REPEAT);
+}
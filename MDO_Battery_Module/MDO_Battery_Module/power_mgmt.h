@@ -0,0 +1,43 @@
+/*
+ * power_mgmt.h
+ *
+ * Created: 10/19/2026 7:15:10 AM
+ */ 
+
+
+#ifndef POWER_MGMT_H_
+#define POWER_MGMT_H_
+
+#include "stdbool.h"
+#include "avr/io.h"
+#include "avr/power.h"
+#include "avr/interrupt.h"
+
+#include "i2c.h"
+
+// Profile gate transitions with Timer1 (cpu cycles)
+#define PWR_PROFILE
+#undef  PWR_PROFILE
+
+// Debug parsing code
+#define DEBUG_POWER_CODE		0xDDEE
+
+// Measured cost of peripheral gate transitions
+typedef struct {
+	uint16_t twi_enables;		// TWI power up count
+	uint16_t twi_disables;		// TWI power down count
+	uint16_t twi_enable_cycles;		// last TWI power up + i2c_init cost
+	uint16_t twi_disable_cycles;	// last TWI power down cost
+	uint16_t twi_enable_max;		// worst TWI power up cost
+	uint16_t twi_disable_max;		// worst TWI power down cost
+}Pwr_stats_t;
+
+extern INSTANCE_LOCAL volatile Pwr_stats_t pwr_stats;
+
+void pwr_init(void);
+void pwr_twiEnable(void);
+void pwr_twiDisable(void);
+bool pwr_twiEnabled(void);
+void pwr_debugStats(uint8_t addr);
+
+#endif /* POWER_MGMT_H_ */
@@ -0,0 +1,248 @@
+/*
+ * sbs.c
+ *
+ * Created: 10/19/2026 7:20:25 AM
+ */ 
+
+#include "sbs.h"
+
+#ifdef __AVR__
+#include "avr/pgmspace.h"
+#else
+#define PROGMEM
+#define pgm_read_byte(addr)	(*(const uint8_t *)(addr))
+#define pgm_read_word(addr)	(*(const uint16_t *)(addr))
+#endif
+
+
+// Conversion applied to command source
+enum {
+	SBS_CONV_CONST,		// arg is the value
+	SBS_CONV_CAPACITY,	// raw capacity -> mAh
+	SBS_CONV_PERCENT,	// raw 1/256 % -> %
+	SBS_CONV_MINUTES,	// raw 5.625s -> minutes
+	SBS_CONV_CYCLES,	// raw 1% cycle -> cycles
+	SBS_CONV_ABS_SOC,	// RepCap / DesignCap
+	SBS_CONV_STATUS,	// BatteryStatus flags
+	SBS_CONV_SPEC_INFO,	// SpecificationInfo, PEC support
+	SBS_CONV_TEMP,		// raw 1/256 C -> 0.1 K
+	SBS_CONV_VOLTAGE,	// raw 78.125uV -> mV
+	SBS_CONV_CURRENT,	// raw 1.5625uV / rsense -> signed mA
+};
+
+// Command table entry
+typedef struct {
+	uint8_t  cmd;
+	uint8_t  conv;
+	uint16_t arg;		// snapshot index or constant
+}Sbs_command_t;
+
+static const Sbs_command_t sbs_commands[] PROGMEM = {
+	{ SBS_REMAINING_CAPACITY_ALARM,	SBS_CONV_CONST,		0 },
+	{ SBS_REMAINING_TIME_ALARM,		SBS_CONV_CONST,		0 },
+	{ SBS_BATTERY_MODE,				SBS_CONV_CONST,		0 },
+	{ SBS_AT_RATE,					SBS_CONV_CONST,		0 },
+	{ SBS_TEMPERATURE,				SBS_CONV_TEMP,		SBS_SRC_TEMP },
+	{ SBS_VOLTAGE,					SBS_CONV_VOLTAGE,	SBS_SRC_VCELL },
+	{ SBS_CURRENT,					SBS_CONV_CURRENT,	SBS_SRC_CURRENT },
+	{ SBS_AVERAGE_CURRENT,			SBS_CONV_CURRENT,	SBS_SRC_AVGCURRENT },
+	{ SBS_MAX_ERROR,				SBS_CONV_CONST,		1 },
+	{ SBS_RELATIVE_STATE_OF_CHARGE,	SBS_CONV_PERCENT,	SBS_SRC_REPSOC },
+	{ SBS_ABSOLUTE_STATE_OF_CHARGE,	SBS_CONV_ABS_SOC,	SBS_SRC_REPCAP },
+	{ SBS_REMAINING_CAPACITY,		SBS_CONV_CAPACITY,	SBS_SRC_REPCAP },
+	{ SBS_FULL_CHARGE_CAPACITY,		SBS_CONV_CAPACITY,	SBS_SRC_FULLCAPREP },
+	{ SBS_RUN_TIME_TO_EMPTY,		SBS_CONV_MINUTES,	SBS_SRC_TTE },
+	{ SBS_AVERAGE_TIME_TO_EMPTY,	SBS_CONV_MINUTES,	SBS_SRC_TTE },
+	{ SBS_AVERAGE_TIME_TO_FULL,		SBS_CONV_CONST,		SBS_UNKNOWN },
+	{ SBS_BATTERY_STATUS,			SBS_CONV_STATUS,	SBS_SRC_REPSOC },
+	{ SBS_CYCLE_COUNT,				SBS_CONV_CYCLES,	SBS_SRC_CYCLES },
+	{ SBS_DESIGN_CAPACITY,			SBS_CONV_CAPACITY,	SBS_SRC_DESIGNCAP },
+	{ SBS_SPECIFICATION_INFO,		SBS_CONV_SPEC_INFO,	0 },
+};
+
+#define SBS_TABLE_SIZE	(sizeof(sbs_commands) / sizeof(sbs_commands[0]))
+
+
+/***********************************************************
+ *
+ * Capacity register to mAh
+ * LSB = 5.0uVh / Rsense (see UG6595 p.4 table 1)
+ *
+ * @param raw    : capacity register value
+ * @param rsense : sense resistor in mOhm
+ *
+ ***********************************************************/
+uint16_t sbs_capacity_mAh(uint16_t raw, uint8_t rsense) {
+	if (rsense == 0) {
+		return SBS_UNKNOWN;
+	}
+	return (uint16_t)(((uint32_t)raw * 5) / rsense);
+}
+
+
+/***********************************************************
+ *
+ * Percentage register to whole percent, rounded
+ * LSB = 1/256 %
+ *
+ * @param raw : percentage register value
+ *
+ ***********************************************************/
+uint16_t sbs_percent(uint16_t raw) {
+	uint16_t pct = (uint16_t)(((uint32_t)raw + 128) >> 8);
+	return (pct > 100) ? 100 : pct;
+}
+
+
+/***********************************************************
+ *
+ * Time register to minutes
+ * LSB = 5.625s, minutes = raw * 3 / 32
+ * 0xFFFF (not applicable) passes through
+ *
+ * @param raw : time register value
+ *
+ ***********************************************************/
+uint16_t sbs_minutes(uint16_t raw) {
+	if (raw == 0xFFFF) {
+		return SBS_UNKNOWN;
+	}
+	return (uint16_t)(((uint32_t)raw * 3) >> 5);
+}
+
+
+/***********************************************************
+ *
+ * Temperature register to 0.1 K
+ * LSB = 1/256 C signed, 0 C = 2731.5 (x 0.1 K)
+ *
+ * @param raw : Temp register value
+ *
+ ***********************************************************/
+uint16_t sbs_temperature(uint16_t raw) {
+	int32_t dK = ((int32_t)(int16_t)raw * 10) + 699264L;	// 2731.5 * 256
+	return (uint16_t)((dK + 128) >> 8);
+}
+
+
+/***********************************************************
+ *
+ * Cell voltage register to mV
+ * LSB = 78.125uV, mV = raw * 5 / 64
+ *
+ * @param raw : VCell register value
+ *
+ ***********************************************************/
+uint16_t sbs_voltage_mV(uint16_t raw) {
+	return (uint16_t)((((uint32_t)raw * 5) + 32) >> 6);
+}
+
+
+/***********************************************************
+ *
+ * Current register to signed mA, returned as the two's
+ * complement word the host reads
+ * LSB = 1.5625uV / Rsense, mA = raw * 25 / (16 * Rsense)
+ *
+ * @param raw    : Current/AvgCurrent register value
+ * @param rsense : sense resistor in mOhm
+ *
+ ***********************************************************/
+uint16_t sbs_current_mA(uint16_t raw, uint8_t rsense) {
+	if (rsense == 0) {
+		return 0;
+	}
+	int32_t mA = ((int32_t)(int16_t)raw * 25) / (16 * (int32_t)rsense);
+	return (uint16_t)(int16_t)mA;
+}
+
+
+/***********************************************************
+ *
+ * Convert a single command from the snapshot
+ *
+ ***********************************************************/
+static uint16_t sbs_convert(const Sbs_snapshot_t* snap, uint8_t conv, uint16_t arg) {
+	
+	switch (conv) {
+		
+		case SBS_CONV_CAPACITY:
+			return sbs_capacity_mAh(snap->raw[arg], snap->rsense);
+		
+		case SBS_CONV_PERCENT:
+			return sbs_percent(snap->raw[arg]);
+		
+		case SBS_CONV_MINUTES:
+			return sbs_minutes(snap->raw[arg]);
+		
+		case SBS_CONV_CYCLES:
+			return snap->raw[arg] / 100;
+		
+		case SBS_CONV_ABS_SOC: {
+			uint16_t design = snap->raw[SBS_SRC_DESIGNCAP];
+			if (design == 0) {
+				return 0;
+			}
+			uint32_t pct = (((uint32_t)snap->raw[arg] * 100) + (design / 2)) / design;
+			return (uint16_t)((pct > 100) ? 100 : pct);
+		}
+		
+		case SBS_CONV_STATUS: {
+			uint16_t status = SBS_STATUS_INITIALIZED;
+			uint16_t pct = sbs_percent(snap->raw[arg]);
+			if (pct >= 100) {
+				status |= SBS_STATUS_FULLY_CHARGED;
+			}
+			if (pct == 0) {
+				status |= SBS_STATUS_FULLY_DISCHARGED;
+			}
+			if (snap->raw[SBS_SRC_TTE] != 0xFFFF) {
+				status |= SBS_STATUS_DISCHARGING;
+			}
+			return status;
+		}
+		
+		case SBS_CONV_SPEC_INFO:
+			return snap->pec ? SBS_SPEC_INFO_1_1_PEC : SBS_SPEC_INFO_1_1;
+		
+		case SBS_CONV_TEMP:
+			return sbs_temperature(snap->raw[arg]);
+		
+		case SBS_CONV_VOLTAGE:
+			return sbs_voltage_mV(snap->raw[arg]);
+		
+		case SBS_CONV_CURRENT:
+			return sbs_current_mA(snap->raw[arg], snap->rsense);
+		
+		default:
+			return arg;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Rebuild SBS command words from a raw register snapshot
+ * Commands not in the table read as SBS_UNKNOWN. regs
+ * must hold SBS_COMMANDS words; callers sharing regs with
+ * an ISR should pass a private copy or mask interrupts.
+ *
+ * @param snap : raw gauge registers
+ * @param regs : command word array, indexed by command
+ *
+ ***********************************************************/
+void sbs_update(const Sbs_snapshot_t* snap, volatile uint16_t* regs) {
+	
+	uint8_t i;
+	
+	for (i = 0; i < SBS_COMMANDS; i++) {
+		regs[i] = SBS_UNKNOWN;
+	}
+	
+	for (i = 0; i < SBS_TABLE_SIZE; i++) {
+		uint8_t  cmd  = pgm_read_byte(&sbs_commands[i].cmd);
+		uint8_t  conv = pgm_read_byte(&sbs_commands[i].conv);
+		uint16_t arg  = pgm_read_word(&sbs_commands[i].arg);
+		regs[cmd] = sbs_convert(snap, conv, arg);
+	}
+}
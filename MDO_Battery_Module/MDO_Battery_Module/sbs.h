@@ -0,0 +1,88 @@
+/*
+ * sbs.h
+ *
+ * Created: 10/19/2026 7:20:25 AM
+ */ 
+
+
+#ifndef SBS_H_
+#define SBS_H_
+
+#include "stdint.h"
+#include "stdbool.h"
+
+// Serve Smart Battery Data commands instead of raw
+// gauge registers in I2C target mode
+#define SBS_EMULATION
+#undef  SBS_EMULATION
+
+// Smart Battery Data Specification 1.1 commands
+#define SBS_REMAINING_CAPACITY_ALARM	0x01
+#define SBS_REMAINING_TIME_ALARM		0x02
+#define SBS_BATTERY_MODE				0x03
+#define SBS_AT_RATE						0x04
+#define SBS_TEMPERATURE					0x08
+#define SBS_VOLTAGE						0x09
+#define SBS_CURRENT						0x0A
+#define SBS_AVERAGE_CURRENT				0x0B
+#define SBS_MAX_ERROR					0x0C
+#define SBS_RELATIVE_STATE_OF_CHARGE	0x0D
+#define SBS_ABSOLUTE_STATE_OF_CHARGE	0x0E
+#define SBS_REMAINING_CAPACITY			0x0F
+#define SBS_FULL_CHARGE_CAPACITY		0x10
+#define SBS_RUN_TIME_TO_EMPTY			0x11
+#define SBS_AVERAGE_TIME_TO_EMPTY		0x12
+#define SBS_AVERAGE_TIME_TO_FULL		0x13
+#define SBS_BATTERY_STATUS				0x16
+#define SBS_CYCLE_COUNT					0x17
+#define SBS_DESIGN_CAPACITY				0x18
+#define SBS_DESIGN_VOLTAGE				0x19
+#define SBS_SPECIFICATION_INFO			0x1A
+
+// Number of command words served
+#define SBS_COMMANDS					0x20
+
+// BatteryStatus bits
+#define SBS_STATUS_FULLY_DISCHARGED		(1 << 4)
+#define SBS_STATUS_FULLY_CHARGED		(1 << 5)
+#define SBS_STATUS_DISCHARGING			(1 << 6)
+#define SBS_STATUS_INITIALIZED			(1 << 7)
+
+// SpecificationInfo, SBS 1.1, no scaling
+#define SBS_SPEC_INFO_1_1				0x0021
+#define SBS_SPEC_INFO_1_1_PEC			0x0031
+
+// Value reported for unsupported or infinite times
+#define SBS_UNKNOWN						0xFFFF
+
+// Raw gauge register snapshot indexes
+enum {
+	SBS_SRC_REPCAP,
+	SBS_SRC_REPSOC,
+	SBS_SRC_TTE,
+	SBS_SRC_FULLCAPREP,
+	SBS_SRC_CYCLES,
+	SBS_SRC_DESIGNCAP,
+	SBS_SRC_TEMP,
+	SBS_SRC_VCELL,
+	SBS_SRC_CURRENT,
+	SBS_SRC_AVGCURRENT,
+	SBS_SRC_COUNT
+};
+
+// Raw MAX17263 register values and sense resistor
+typedef struct {
+	uint8_t  pec;					// host reads carry PEC
+	uint8_t  rsense;				// mOhm
+	uint16_t raw[SBS_SRC_COUNT];
+}Sbs_snapshot_t;
+
+uint16_t sbs_capacity_mAh(uint16_t raw, uint8_t rsense);
+uint16_t sbs_percent(uint16_t raw);
+uint16_t sbs_minutes(uint16_t raw);
+uint16_t sbs_temperature(uint16_t raw);
+uint16_t sbs_voltage_mV(uint16_t raw);
+uint16_t sbs_current_mA(uint16_t raw, uint8_t rsense);
+void sbs_update(const Sbs_snapshot_t* snap, volatile uint16_t* regs);
+
+#endif /* SBS_H_ */
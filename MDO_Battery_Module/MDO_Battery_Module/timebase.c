@@ -0,0 +1,218 @@
+/*
+ * timebase.c
+ *
+ * Created: 10/19/2026 7:15:40 AM
+ */ 
+
+#include "timebase.h"
+#include "i2c.h"
+
+static INSTANCE_LOCAL volatile uint32_t tb_ms = 0;
+static INSTANCE_LOCAL uint8_t tb_compare = 124;	// 1ms @ 8MHz / 64
+static INSTANCE_LOCAL uint8_t tb_clksel = _BV(CS01) | _BV(CS00);
+static INSTANCE_LOCAL uint8_t tb_shift = 0;		// log2(F_CPU / fcpu), scales busy waits
+static INSTANCE_LOCAL uint8_t tb_tick_us = 8;		// microseconds per Timer0 count
+
+
+/***********************************************************
+ *
+ * Timer0 compare match, 1ms system tick
+ * Also wakes the core from SLEEP_MODE_IDLE
+ *
+ ***********************************************************/
+ISR(TIMER0_COMPA_vect) {
+	tb_ms++;
+}
+
+
+/***********************************************************
+ *
+ * Set Timer0 prescaler and compare value for 1ms tick
+ * OCR0A = fcpu / (prescaler * 1000) - 1
+ * Called again whenever the clock prescaler changes
+ *
+ * @param fcpu : CPU clock speed
+ *
+ ***********************************************************/
+void tb_init(uint32_t fcpu) {
+	
+	uint32_t prescaler = TB_PRESCALER;
+	tb_clksel = _BV(CS01) | _BV(CS00);
+	if (fcpu <= 2000000UL) {
+		prescaler = TB_PRESCALER_SLOW;
+		tb_clksel = _BV(CS01);
+	}
+	
+	// round to nearest count
+	tb_compare = (uint8_t)(((fcpu + (prescaler * 500UL)) / (prescaler * 1000UL)) - 1);
+	
+	tb_tick_us = (uint8_t)((prescaler * 1000000UL) / fcpu);
+	
+	tb_shift = 0;
+	while ((F_CPU >> tb_shift) > fcpu) {
+		tb_shift++;
+	}
+	
+	if (tb_running()) {
+		OCR0A  = tb_compare;
+		TCCR0B = tb_clksel;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Power up Timer0 and start 1ms tick in CTC mode
+ *
+ ***********************************************************/
+void tb_start(void) {
+	power_timer0_enable();
+	TCCR0A = _BV(WGM01);				// CTC, TOP = OCR0A
+	OCR0A  = tb_compare;
+	TCNT0  = 0;
+	TIFR0  = _BV(OCF0A);				// clear stale match
+	TIMSK0 = _BV(OCIE0A);
+	TCCR0B = tb_clksel;
+}
+
+
+/***********************************************************
+ *
+ * Stop tick and gate Timer0
+ *
+ ***********************************************************/
+void tb_stop(void) {
+	TCCR0B = 0;
+	TIMSK0 = 0;
+	power_timer0_disable();
+}
+
+
+/***********************************************************
+ *
+ * Check Timer0 tick state
+ *
+ * @returns : true when 1ms tick is running
+ *
+ ***********************************************************/
+bool tb_running(void) {
+	return (TCCR0B != 0) && !(PRR0 & _BV(PRTIM0));
+}
+
+
+/***********************************************************
+ *
+ * Milliseconds since startup, including time advanced
+ * by sleep wakeup sources through tb_advance()
+ *
+ ***********************************************************/
+uint32_t tb_millis(void) {
+	uint32_t ms;
+	uint8_t sreg = SREG;
+	cli();
+	ms = tb_ms;
+	SREG = sreg;
+	return ms;
+}
+
+
+/***********************************************************
+ *
+ * Microseconds since startup, resolution of one Timer0
+ * count (4-16us depending on clock). Only advances
+ * while the tick is running.
+ *
+ ***********************************************************/
+uint32_t tb_micros(void) {
+	uint32_t ms;
+	uint8_t count;
+	uint8_t sreg = SREG;
+	cli();
+	ms = tb_ms;
+	count = TCNT0;
+	
+	// compare match pending, counter already wrapped
+	if ((TIFR0 & _BV(OCF0A)) && (count < tb_compare)) {
+		ms++;
+	}
+	SREG = sreg;
+	return (ms * 1000UL) + ((uint32_t)count * tb_tick_us);
+}
+
+
+/***********************************************************
+ *
+ * Account for time spent with Timer0 stopped
+ * (watchdog power down periods)
+ *
+ * @param ms : elapsed milliseconds
+ *
+ ***********************************************************/
+void tb_advance(uint16_t ms) {
+	uint8_t sreg = SREG;
+	cli();
+	tb_ms += ms;
+	SREG = sreg;
+}
+
+
+/***********************************************************
+ *
+ * Clear the tick count, timebase as after reset
+ *
+ ***********************************************************/
+void tb_reset(void) {
+	uint8_t sreg = SREG;
+	cli();
+	tb_ms = 0;
+	SREG = sreg;
+}
+
+
+/***********************************************************
+ *
+ * Wait using idle sleep, woken by the 1ms tick
+ * Falls back to busy wait when interrupts are disabled
+ * since nothing could wake the core
+ *
+ * @param ms : milliseconds to wait
+ *
+ ***********************************************************/
+void tb_sleepFor(uint16_t ms) {
+	
+	if (ms == 0) {
+		return;
+	}
+	
+	// _delay_us assumes F_CPU, 125us steps scaled to clock
+	if (!(SREG & _BV(SREG_I))) {
+		uint32_t steps = ((uint32_t)ms * 8) >> tb_shift;
+		if (steps == 0) {
+			steps = 1;
+		}
+		while (steps--) {
+			_delay_us(125);
+		}
+		return;
+	}
+	
+	// only keep timer powered if caller already had it running
+	bool stop = !tb_running();
+	if (stop) {
+		tb_start();
+	}
+	
+	uint32_t start = tb_millis();
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	
+	// one extra tick, first may be partial
+	while ((tb_millis() - start) <= ms) {
+		sleep_enable();
+		sleep_cpu();
+		sleep_disable();
+	}
+	
+	if (stop) {
+		tb_stop();
+	}
+}
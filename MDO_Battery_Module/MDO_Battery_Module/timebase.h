@@ -0,0 +1,37 @@
+/*
+ * timebase.h
+ *
+ * Created: 10/19/2026 7:15:40 AM
+ */ 
+
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#ifndef F_CPU
+#define F_CPU 8000000UL
+#endif
+
+#include "stdbool.h"
+#include "avr/io.h"
+#include "avr/sleep.h"
+#include "avr/power.h"
+#include "avr/interrupt.h"
+#include "util/delay.h"
+
+// Timer0 prescalers for 1ms tick
+// clk/8 once the core clock is scaled to 2MHz or below
+#define TB_PRESCALER		64UL
+#define TB_PRESCALER_SLOW	8UL
+
+void tb_init(uint32_t fcpu);
+void tb_start(void);
+void tb_stop(void);
+bool tb_running(void);
+uint32_t tb_millis(void);
+uint32_t tb_micros(void);
+void tb_advance(uint16_t ms);
+void tb_reset(void);
+void tb_sleepFor(uint16_t ms);
+
+#endif /* TIMEBASE_H_ */
@@ -0,0 +1,171 @@
+/*
+ * fuzz_main.cpp
+ *
+ * Created: 10/19/2026 7:52:11 AM
+ *
+ * Stand-alone driver for toolchains without libFuzzer. Runs
+ * each corpus input, then random mutations of the corpus
+ *   max17263-fuzz-debug fuzz/corpus/debug_parser -n 100000
+ *   max17263-fuzz-debug -c fuzz/corpus/debug_parser
+ * -c checks every corpus frame parses clean (debug_parse()
+ * returns PARSE_OK), a guard on encoder/parser drift.
+ */ 
+
+#include "debug_parser.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Input {
+	std::string name;
+	std::vector<uint8_t> data;
+};
+
+void usage()
+{
+	std::fprintf(stderr,
+		"usage: max17263-fuzz-debug [-c] [-n RUNS] [-s SEED] PATH...\n"
+		"  PATH   corpus file or directory\n"
+		"  -c     require every corpus frame to parse clean\n"
+		"  -n     random mutations to run (default 0)\n"
+		"  -s     mutation seed (default 1)\n");
+}
+
+bool load(const fs::path& path, std::vector<Input>& corpus)
+{
+	std::error_code ec;
+	if (fs::is_directory(path, ec)) {
+		std::vector<fs::path> files;
+		for (const auto& entry : fs::directory_iterator(path, ec))
+			if (entry.is_regular_file())
+				files.push_back(entry.path());
+		std::sort(files.begin(), files.end());
+		for (const auto& file : files)
+			if (!load(file, corpus))
+				return false;
+		return true;
+	}
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		std::fprintf(stderr, "cannot open %s\n", path.c_str());
+		return false;
+	}
+	corpus.push_back({ path.string(),
+		std::vector<uint8_t>(std::istreambuf_iterator<char>(in), {}) });
+	return true;
+}
+
+// Parse with no-op output, the -c check only wants the flags
+uint8_t parseFlags(const std::vector<uint8_t>& data)
+{
+	static const debug_output_t quiet = {
+		[](const char*) {},
+		[](const char*, uint32_t, uint8_t, const char*) {},
+		[](uint16_t) {},
+		[]() {}
+	};
+	return debug_parse(data.data(), static_cast<uint8_t>(data.size()), &quiet);
+}
+
+// One to four edits: flip, overwrite, insert, erase or splice
+void mutate(std::vector<uint8_t>& data, const std::vector<Input>& corpus, std::mt19937& rng)
+{
+	int edits = 1 + rng() % 4;
+	while (edits--) {
+		size_t size = data.size();
+		switch (rng() % 5) {
+		case 0:
+			if (size)
+				data[rng() % size] ^= static_cast<uint8_t>(1u << (rng() % 8));
+			break;
+		case 1:
+			if (size)
+				data[rng() % size] = static_cast<uint8_t>(rng());
+			break;
+		case 2:
+			data.insert(data.begin() + (size ? rng() % (size + 1) : 0),
+				static_cast<uint8_t>(rng()));
+			break;
+		case 3:
+			if (size)
+				data.erase(data.begin() + rng() % size);
+			break;
+		case 4: {
+			const auto& other = corpus[rng() % corpus.size()].data;
+			size_t at = size ? rng() % (size + 1) : 0;
+			data.resize(at);
+			data.insert(data.end(), other.begin(), other.end());
+			break;
+		}
+		}
+	}
+}
+
+}
+
+
+int main(int argc, char** argv)
+{
+	bool check = false;
+	unsigned long runs = 0;
+	unsigned long seed = 1;
+	std::vector<Input> corpus;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "-c")
+			check = true;
+		else if (arg == "-n" && i + 1 < argc)
+			runs = std::strtoul(argv[++i], nullptr, 0);
+		else if (arg == "-s" && i + 1 < argc)
+			seed = std::strtoul(argv[++i], nullptr, 0);
+		else if (arg[0] == '-') {
+			usage();
+			return 2;
+		}
+		else if (!load(arg, corpus))
+			return 2;
+	}
+	if (corpus.empty()) {
+		usage();
+		return 2;
+	}
+
+	int failed = 0;
+	for (const auto& input : corpus) {
+		LLVMFuzzerTestOneInput(input.data.data(), input.data.size());
+		if (check) {
+			uint8_t flags = parseFlags(input.data);
+			if (flags != PARSE_OK) {
+				std::fprintf(stderr, "%s: flags 0x%02X\n", input.name.c_str(), flags);
+				failed++;
+			}
+		}
+	}
+
+	std::mt19937 rng(seed);
+	std::vector<uint8_t> data;
+	for (unsigned long n = 0; n < runs; n++) {
+		data = corpus[rng() % corpus.size()].data;
+		mutate(data, corpus, rng);
+		LLVMFuzzerTestOneInput(data.data(), data.size());
+	}
+
+	std::printf("%zu corpus inputs, %lu mutations, %d malformed\n",
+		corpus.size(), runs, failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,379 @@
+/*
+ * gauge_model.cpp
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ */ 
+
+#include "gauge_model.h"
+#include "sim_context.h"
+
+extern "C" {
+#include "max17263_regmap.h"
+}
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#define GAUGE_HibCfg_DEFAULT	0x870C
+#define GAUGE_RCOMP0_DEFAULT	0x0070
+#define GAUGE_TempCo_DEFAULT	0x223E
+#define GAUGE_DNR_US			250000ULL	// first conversion after POR
+#define GAUGE_REFRESH_US		100000ULL	// model refresh after ModelCfg write
+#define GAUGE_LEARN_RATE		0.3			// per full charge
+
+// Gauge supply current, LEDs off. Hibernate adds the
+// active conversion share scaled by the longer period.
+#define GAUGE_IQ_ACTIVE_UA		24.0
+#define GAUGE_IQ_HIB_UA			5.1
+#define GAUGE_TASK_US			175800ULL
+#define GAUGE_HIB_TASK_US		351000ULL
+#define GAUGE_HIB_ENTER_US		2812000ULL	// x 2^HibEnterTime
+
+
+Max17263Model::Max17263Model(SimContext& ctx, const GaugeConfig& config, uint32_t seed)
+	: ctx_(ctx), config_(config), rng_(seed) {
+	
+	std::uniform_real_distribution<double> spread(0.95, 1.05);
+	std::uniform_real_distribution<double> soc(0.3, 1.0);
+	cap_new_mAh_ = config_.capacity_mAh * spread(rng_);
+	cap_mAh_ = cap_new_mAh_;
+	charge_mAh_ = cap_mAh_ * soc(rng_);
+	est_mAh_ = cap_mAh_;
+	por();
+	pors_ = 0;								// power up is not a reset
+	phase_ = Phase::RestHigh;
+	phase_end_us_ = 0;
+}
+
+
+/***********************************************************
+ *
+ * Gauge power on reset, registers to defaults and all
+ * learned state back to the DesignCap based model
+ *
+ ***********************************************************/
+void Max17263Model::por() {
+	std::memset(regs_, 0, sizeof(regs_));
+	regs_[Status_REG_ADDR] = Status_DEFAULT;
+	regs_[DesignCap_REG_ADDR] = DesignCap_DEFAULT;
+	regs_[VEmpty_REG_ADDR] = VEmpty_DEFAULT;
+	regs_[ModelCfg_REG_ADDR] = ModelCfg_DEFAULT & ~ModelCfg_Refresh;
+	regs_[IChgTerm_REG_ADDR] = IChgTerm_DEFAULT;
+	regs_[HibCfg_REG_ADDR] = GAUGE_HibCfg_DEFAULT;
+	regs_[LEDCfg1_REG_ADDR] = LEDCfg1_DEFAULT;
+	regs_[LEDCfg2_REG_ADDR] = LEDCfg2_DEFAULT;
+	regs_[LEDCfg3_REG_ADDR] = LEDCfg3_DEFAULT;
+	regs_[TempCo_REG_ADDR] = GAUGE_TempCo_DEFAULT;
+	regs_[MaxMinTemp_REG_ADDR] = MaxMinTemp_DEFAULT;
+	
+	rcomp_ = GAUGE_RCOMP0_DEFAULT;
+	est_mAh_ = DesignCap_DEFAULT * lsb_mAh();
+	cycles_pct_ = 0;
+	dnr_until_us_ = ctx_.now() + GAUGE_DNR_US;
+	refresh_until_us_ = 0;
+	busy_until_us_ = 0;
+	hibernating_ = false;
+	dwell_us_ = 0;
+	custom_model_ = false;
+	pors_++;
+	refresh();
+}
+
+
+/***********************************************************
+ *
+ * Pick next leg of the synthetic usage profile
+ * discharge to a random floor, rest, charge at charge_C
+ * to full, rest
+ *
+ ***********************************************************/
+void Max17263Model::nextPhase() {
+	
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	double hours;
+	
+	switch (phase_) {
+		case Phase::RestHigh: {
+			phase_ = Phase::Discharge;
+			current_mA_ = -(config_.discharge_mA_min +
+				unit(rng_) * (config_.discharge_mA_max - config_.discharge_mA_min));
+			soc_low_ = 0.05 + 0.25 * unit(rng_);
+			hours = std::max(0.0, charge_mAh_ - soc_low_ * cap_mAh_) / -current_mA_;
+			break;
+		}
+		case Phase::Discharge:
+			phase_ = Phase::RestLow;
+			current_mA_ = 0;
+			hours = unit(rng_) * config_.rest_h_max;
+			break;
+		case Phase::RestLow:
+			phase_ = Phase::Charge;
+			current_mA_ = config_.charge_C * cap_mAh_;
+			hours = std::max(0.0, cap_mAh_ - charge_mAh_) / current_mA_;
+			break;
+		default:
+			// full charge, gauge learns capacity and model
+			est_mAh_ += GAUGE_LEARN_RATE * (cap_mAh_ - est_mAh_);
+			rcomp_ += GAUGE_LEARN_RATE * ((GAUGE_RCOMP0_DEFAULT + 0.05 * cell_pct_ / 100.0) - rcomp_);
+			phase_ = Phase::RestHigh;
+			current_mA_ = 0;
+			hours = unit(rng_) * config_.rest_h_max;
+			break;
+	}
+	phase_end_us_ = t_us_ + (uint64_t)(hours * 3600e6) + 1;
+}
+
+
+/***********************************************************
+ *
+ * Integrate cell state up to now
+ *
+ ***********************************************************/
+void Max17263Model::advanceTo(uint64_t now_us) {
+	while (t_us_ < now_us) {
+		if (t_us_ >= phase_end_us_) {
+			nextPhase();
+		}
+		uint64_t end = std::min(now_us, phase_end_us_);
+		double dq = current_mA_ * (double)(end - t_us_) / 3600e6;
+		double before = charge_mAh_;
+		charge_mAh_ = std::min(std::max(charge_mAh_ + dq, 0.0), cap_mAh_);
+		double pct = std::fabs(charge_mAh_ - before) / cap_mAh_ * 50.0;
+		cycles_pct_ += pct;
+		cell_pct_ += pct;
+		cap_mAh_ = cap_new_mAh_ * std::max(0.5, 1.0 - config_.fade_per_cycle * cell_pct_ / 100.0);
+		advanceHibernate(end - t_us_);
+		t_us_ = end;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Hibernate state over a stretch of constant current.
+ * Enters after |I| stays below HibThreshold for the enter
+ * time, leaves after HibExitTime + 1 hibernate periods
+ * above it. Supply current integrated per state.
+ *
+ ***********************************************************/
+void Max17263Model::advanceHibernate(uint64_t us) {
+	
+	uint16_t hib = regs_[HibCfg_REG_ADDR];
+	uint8_t scalar = hib & HibCfg_HibScalar;
+	uint64_t period_us = GAUGE_HIB_TASK_US << scalar;
+	uint64_t enter_us = GAUGE_HIB_ENTER_US << ((hib >> 12) & 0x07);
+	uint64_t exit_us = (((hib >> 3) & 0x03) + 1) * period_us;
+	double threshold_mA = est_mAh_ / (0.8 * (double)(1u << ((hib >> 8) & 0x0F)));
+	bool below = std::fabs(current_mA_) < threshold_mA;
+	
+	if (!(hib & ENHIB)) {
+		hibernating_ = false;
+		dwell_us_ = 0;
+	}
+	
+	while (us > 0) {
+		uint64_t step = us;
+		bool toward = (hib & ENHIB) && (hibernating_ ? !below : below);
+		uint64_t need = hibernating_ ? exit_us : enter_us;
+		
+		if (toward && (need - std::min(need, dwell_us_) <= step)) {
+			step = need - std::min(need, dwell_us_);
+		}
+		
+		double iq = hibernating_ ?
+			GAUGE_IQ_HIB_UA + (GAUGE_IQ_ACTIVE_UA - GAUGE_IQ_HIB_UA) * GAUGE_TASK_US / period_us :
+			GAUGE_IQ_ACTIVE_UA;
+		iq_uAs_ += iq * (double)step / 1e6;
+		if (hibernating_) {
+			hib_us_ += step;
+		}
+		
+		dwell_us_ = toward ? dwell_us_ + step : 0;
+		if (toward && (dwell_us_ >= need)) {
+			hibernating_ = !hibernating_;
+			dwell_us_ = 0;
+		}
+		us -= step;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Recompute output registers from cell state
+ *
+ ***********************************************************/
+void Max17263Model::refresh() {
+	
+	uint64_t now = ctx_.now();
+	advanceTo(now);
+	
+	if (now >= dnr_until_us_) {
+		regs_[FStat_REG_ADDR] &= ~DNR;
+	}
+	else {
+		regs_[FStat_REG_ADDR] |= DNR;
+	}
+	
+	if (hibernating_) {
+		regs_[Status2_REG_ADDR] |= Status2_Hib;
+	}
+	else {
+		regs_[Status2_REG_ADDR] &= ~Status2_Hib;
+	}
+	
+	// refresh done, a table in the model area replaces EZ
+	if ((regs_[ModelCfg_REG_ADDR] & ModelCfg_Refresh) && (now >= refresh_until_us_)) {
+		regs_[ModelCfg_REG_ADDR] &= ~ModelCfg_Refresh;
+		est_mAh_ = regs_[DesignCap_REG_ADDR] * lsb_mAh();
+		custom_model_ = std::any_of(regs_ + Model_REG_ADDR, regs_ + Model_REG_ADDR + Model_WORDS,
+									[](uint16_t w) { return w != 0; });
+		model_loads_ += custom_model_ ? 1 : 0;
+	}
+	
+	double lsb = lsb_mAh();
+	double soc = (est_mAh_ > 0) ? std::min(charge_mAh_ / est_mAh_, 1.0) : 0;
+	regs_[RepCap_REG_ADDR] = (uint16_t)std::min(charge_mAh_ / lsb, 65535.0);
+	regs_[RepSOC_REG_ADDR] = (uint16_t)(soc * 25600.0);
+	regs_[FullCapRep_REG_ADDR] = (uint16_t)std::min(est_mAh_ / lsb, 65535.0);
+	regs_[FullCapNom_REG_ADDR] = regs_[FullCapRep_REG_ADDR];
+	regs_[Cycles_REG_ADDR] = (uint16_t)(uint32_t)cycles_pct_;		// 655.35 cycles, rolls over
+	regs_[RCOMP0_REG_ADDR] = (uint16_t)std::lround(rcomp_);
+	regs_[TTE_REG_ADDR] = (current_mA_ < 0) ?
+		(uint16_t)std::min(charge_mAh_ / -current_mA_ * 3600.0 / 5.625, 65534.0) : 0xFFFF;
+	regs_[TTF_REG_ADDR] = (current_mA_ > 0) ?
+		(uint16_t)std::min((cap_mAh_ - charge_mAh_) / current_mA_ * 3600.0 / 5.625, 65534.0) : 0xFFFF;
+	
+	// 1.5625uV / rsense per LSB, 78.125uV per LSB, 1/256 C per LSB
+	int16_t i_raw = (int16_t)std::lround(current_mA_ / (1.5625 / config_.rsense));
+	regs_[Current_REG_ADDR] = (uint16_t)i_raw;
+	regs_[AvgCurrent_REG_ADDR] = (uint16_t)i_raw;
+	vcell_V_ = 3.3 + 0.9 * soc;
+	regs_[VCell_REG_ADDR] = (uint16_t)(vcell_V_ / 78.125e-6);
+	regs_[AvgVCell_REG_ADDR] = regs_[VCell_REG_ADDR];
+	regs_[Temp_REG_ADDR] = 25 * 256;
+	
+	// whole degrees, max in the high byte, min in the low
+	int8_t t = (int8_t)(regs_[Temp_REG_ADDR] >> 8);
+	int8_t t_max = std::max((int8_t)(regs_[MaxMinTemp_REG_ADDR] >> 8), t);
+	int8_t t_min = std::min((int8_t)regs_[MaxMinTemp_REG_ADDR], t);
+	regs_[MaxMinTemp_REG_ADDR] = (uint16_t)(((uint8_t)t_max << 8) | (uint8_t)t_min);
+}
+
+
+/***********************************************************
+ *
+ * Driver write to a register, learned values adopted
+ *
+ ***********************************************************/
+void Max17263Model::registerWrite(uint8_t addr, uint16_t value) {
+	
+	bool model_area = (addr >= Model_REG_ADDR) && (addr < Model_REG_ADDR + Model_WORDS);
+	if (model_area && !modelUnlocked()) {
+		return;								// locked, write ignored
+	}
+	
+	reg_writes_++;
+	regs_[addr] = value;
+	
+	switch (addr) {
+		case FullCapNom_REG_ADDR:
+		case FullCapRep_REG_ADDR:
+			est_mAh_ = value * lsb_mAh();
+			break;
+		case Cycles_REG_ADDR:
+			cycles_pct_ = value;
+			break;
+		case HibCfg_REG_ADDR:
+			if (!(value & ENHIB)) {
+				hibernating_ = false;
+				dwell_us_ = 0;
+			}
+			break;
+		case SoftWakeup_REG_ADDR:
+			if (value == SoftWakeup_SOFT) {
+				hibernating_ = false;
+				dwell_us_ = 0;
+			}
+			break;
+		case RCOMP0_REG_ADDR:
+			rcomp_ = value;
+			break;
+		case ModelCfg_REG_ADDR:
+			if (value & ModelCfg_Refresh) {
+				refresh_until_us_ = ctx_.now() + GAUGE_REFRESH_US;
+			}
+			break;
+		default:
+			break;
+	}
+	
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	if ((config_.busy_nack > 0) && (unit(rng_) < config_.busy_nack)) {
+		busy_until_us_ = ctx_.now() + 500 + (uint64_t)(unit(rng_) * 2500);
+	}
+}
+
+
+bool Max17263Model::modelUnlocked() const {
+	return (regs_[ModelUnlock1_REG_ADDR] == ModelUnlock1_KEY) &&
+		   (regs_[ModelUnlock2_REG_ADDR] == ModelUnlock2_KEY);
+}
+
+
+// Locked model area reads back zero
+uint16_t Max17263Model::registerRead(uint8_t addr) const {
+	if ((addr >= Model_REG_ADDR) && (addr < Model_REG_ADDR + Model_WORDS) && !modelUnlocked()) {
+		return 0;
+	}
+	return regs_[addr];
+}
+
+
+bool Max17263Model::start(bool read) {
+	if (ctx_.now() < busy_until_us_) {
+		return false;
+	}
+	refresh();
+	reading_ = read;
+	count_ = 0;
+	return true;
+}
+
+
+bool Max17263Model::write(uint8_t data) {
+	if (count_ == 0) {
+		ptr_ = data;
+	}
+	else if (count_ & 0x01) {
+		lsb_ = data;
+	}
+	else {
+		registerWrite(ptr_, (uint16_t)(lsb_ | (data << 8)));
+		ptr_++;
+	}
+	count_++;
+	return true;
+}
+
+
+uint8_t Max17263Model::read(bool ack) {
+	(void)ack;
+	uint16_t v = registerRead(ptr_);
+	uint8_t out;
+	if ((count_ & 0x01) == 0) {
+		out = (uint8_t)(v & 0xFF);
+	}
+	else {
+		out = (uint8_t)(v >> 8);
+		ptr_++;
+	}
+	count_++;
+	return out;
+}
+
+
+void Max17263Model::stop() {
+	count_ = 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * gauge_model.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Behavioural MAX17263 on the simulated bus. Register
+ * protocol as the part (pointer write, LSB first, auto
+ * increment on reads), a single cell that cycles through
+ * discharge/rest/charge in virtual time, and the parts of
+ * learning the driver cares about: Cycles, FullCapNom and
+ * RCOMP0 evolve and are lost on gauge POR unless restored.
+ * Hibernate entry/exit follows HibCfg and the gauge's own
+ * supply current is integrated for shelf drain estimates.
+ */ 
+
+
+#ifndef GAUGE_MODEL_H_
+#define GAUGE_MODEL_H_
+
+#include "twi_bus.h"
+
+#include <cstdint>
+#include <random>
+
+class SimContext;
+
+struct GaugeConfig {
+	double capacity_mAh = 1200;		// true capacity when new
+	double fade_per_cycle = 0.0002;	// fraction of capacity lost per cycle
+	uint8_t rsense = 10;			// milliohms, register scaling
+	double busy_nack = 0;			// chance a write leaves the gauge busy
+	uint32_t stretch_us = 0;		// SCL held low after each ACK
+	double discharge_mA_min = 150;
+	double discharge_mA_max = 600;
+	double charge_C = 0.5;
+	double rest_h_max = 6;
+};
+
+
+class Max17263Model : public TwiDevice {
+public:
+	Max17263Model(SimContext& ctx, const GaugeConfig& config, uint32_t seed);
+	
+	bool start(bool read) override;
+	bool write(uint8_t data) override;
+	uint8_t read(bool ack) override;
+	void stop() override;
+	uint32_t stretchUs() override { return config_.stretch_us; }
+	
+	void por();
+	void advanceTo(uint64_t now_us);
+	
+	uint16_t reg(uint8_t addr) const { return regs_[addr]; }
+	double trueCapacity() const { return cap_mAh_; }
+	double estimatedCapacity() const { return est_mAh_; }
+	double cellVoltage() const { return vcell_V_; }
+	double cycles() const { return cell_pct_ / 100.0; }				// cell, survives POR
+	double gaugeCycles() const { return cycles_pct_ / 100.0; }		// Cycles register
+	uint64_t pors() const { return pors_; }
+	bool hibernating() const { return hibernating_; }
+	bool customModel() const { return custom_model_; }
+	uint64_t modelLoads() const { return model_loads_; }
+	double quiescent_uAh() const { return iq_uAs_ / 3600.0; }
+	uint64_t hibernate_us() const { return hib_us_; }
+	uint64_t registerWrites() const { return reg_writes_; }
+	
+private:
+	enum class Phase { Discharge, RestLow, Charge, RestHigh };
+	
+	void nextPhase();
+	void advanceHibernate(uint64_t us);
+	void registerWrite(uint8_t addr, uint16_t value);
+	uint16_t registerRead(uint8_t addr) const;
+	bool modelUnlocked() const;
+	void refresh();
+	double lsb_mAh() const { return 5.0 / config_.rsense; }
+	
+	SimContext& ctx_;
+	GaugeConfig config_;
+	std::mt19937 rng_;
+	
+	uint16_t regs_[256];
+	uint8_t ptr_ = 0;
+	uint8_t count_ = 0;				// bytes since START
+	uint8_t lsb_ = 0;
+	bool reading_ = false;
+	uint64_t busy_until_us_ = 0;
+	uint64_t dnr_until_us_ = 0;
+	uint64_t refresh_until_us_ = 0;
+	
+	// cell
+	uint64_t t_us_ = 0;
+	Phase phase_ = Phase::RestHigh;
+	uint64_t phase_end_us_ = 0;
+	double current_mA_ = 0;			// + charge, - discharge
+	double soc_low_ = 0.2;
+	double charge_mAh_;
+	double cap_mAh_;
+	double cap_new_mAh_;
+	double est_mAh_;				// gauge's learned capacity (FullCapNom)
+	double cycles_pct_ = 0;			// gauge counter, lost on POR
+	double cell_pct_ = 0;			// cell aging
+	double rcomp_ = 0x0070;
+	double vcell_V_ = 0;
+	
+	// hibernate
+	bool hibernating_ = false;
+	uint64_t dwell_us_ = 0;			// qualifying time toward enter/exit
+	uint64_t hib_us_ = 0;
+	double iq_uAs_ = 0;
+	
+	// custom model area
+	bool custom_model_ = false;
+	uint64_t model_loads_ = 0;
+	
+	uint64_t pors_ = 0;
+	uint64_t reg_writes_ = 0;
+};
+
+#endif /* GAUGE_MODEL_H_ */
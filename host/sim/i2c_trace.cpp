@@ -0,0 +1,292 @@
+/*
+ * i2c_trace.cpp
+ *
+ * Created: 10/19/2026 7:46:39 AM
+ */ 
+
+#include "i2c_trace.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+static thread_local Trace* trace_current = nullptr;
+
+
+static void put(std::vector<uint8_t>& out, uint32_t v, uint8_t width) {
+	for (uint8_t b = 0; b < width; b++) {
+		out.push_back((uint8_t)(v >> (8 * b)));
+	}
+}
+
+static uint32_t get(const uint8_t* p, uint8_t width) {
+	uint32_t v = 0;
+	for (uint8_t b = 0; b < width; b++) {
+		v |= (uint32_t)p[b] << (8 * b);
+	}
+	return v;
+}
+
+
+bool Trace::save(const std::string& path, std::string& error) const {
+	
+	std::vector<uint8_t> out(TRACE_FILE_MAGIC, TRACE_FILE_MAGIC + 8);
+	std::vector<uint8_t> h;
+	put(h, header.wake_s, 4);
+	put(h, header.fscl, 4);
+	put(h, header.retry.attempts, 1);
+	put(h, header.retry.backoff_ms, 1);
+	put(h, header.retry.backoff_max_ms, 1);
+	put(h, header.retry.mask, 1);
+	put(h, header.rsense, 1);
+	put(h, header.capacity_mAh, 2);
+	put(h, header.debug, 1);
+	put(h, header.wakes, 4);
+	put(h, header.stretch_us, 4);
+	put(out, (uint32_t)h.size(), 2);
+	out.insert(out.end(), h.begin(), h.end());
+	
+	for (const TraceRecord& r : records) {
+		put(out, r.t_us, 4);
+		put(out, r.dur_us, 4);
+		out.push_back(r.addr);
+		out.push_back(r.dir);
+		out.push_back(r.len);
+		out.push_back(r.done);
+		out.push_back(r.err);
+		out.insert(out.end(), r.data.begin(), r.data.end());
+	}
+	
+	FILE* f = std::fopen(path.c_str(), "wb");
+	if (f == nullptr) {
+		error = path + ": " + std::strerror(errno);
+		return false;
+	}
+	bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+	ok = (std::fclose(f) == 0) && ok;
+	if (!ok) {
+		error = path + ": write failed";
+	}
+	return ok;
+}
+
+
+/***********************************************************
+ *
+ * Read a trace, header fields past the ones known here
+ * are skipped so the header can grow
+ *
+ ***********************************************************/
+bool Trace::load(const std::string& path, std::string& error) {
+	
+	FILE* f = std::fopen(path.c_str(), "rb");
+	if (f == nullptr) {
+		error = path + ": " + std::strerror(errno);
+		return false;
+	}
+	std::vector<uint8_t> in;
+	uint8_t buf[4096];
+	size_t n;
+	while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) {
+		in.insert(in.end(), buf, buf + n);
+	}
+	std::fclose(f);
+	
+	if ((in.size() < 10) || (std::memcmp(in.data(), TRACE_FILE_MAGIC, 8) != 0)) {
+		error = path + ": not a trace file";
+		return false;
+	}
+	size_t hlen = get(&in[8], 2);
+	if ((hlen < 20) || (in.size() < 10 + hlen)) {
+		error = path + ": truncated header";
+		return false;
+	}
+	const uint8_t* h = &in[10];
+	header.wake_s = get(h, 4);
+	header.fscl = get(h + 4, 4);
+	header.retry = { h[8], h[9], h[10], h[11] };
+	header.rsense = h[12];
+	header.capacity_mAh = (uint16_t)get(h + 13, 2);
+	header.debug = h[15] != 0;
+	header.wakes = get(h + 16, 4);
+	header.stretch_us = (hlen >= 24) ? get(h + 20, 4) : 0;
+	
+	records.clear();
+	size_t pos = 10 + hlen;
+	while (pos + 13 <= in.size()) {
+		TraceRecord r;
+		r.t_us = get(&in[pos], 4);
+		r.dur_us = get(&in[pos + 4], 4);
+		r.addr = in[pos + 8];
+		r.dir = in[pos + 9];
+		r.len = in[pos + 10];
+		r.done = in[pos + 11];
+		r.err = in[pos + 12];
+		size_t bytes = (r.dir == TW_WRITE) ? r.len : r.done;
+		if (pos + 13 + bytes > in.size()) {
+			break;
+		}
+		r.data.assign(in.begin() + pos + 13, in.begin() + pos + 13 + bytes);
+		records.push_back(std::move(r));
+		pos += 13 + bytes;
+	}
+	if (pos != in.size()) {
+		error = path + ": truncated record at offset " + std::to_string(pos);
+		return false;
+	}
+	return true;
+}
+
+
+std::string traceFormat(const TraceRecord& r) {
+	char line[160];
+	int n = std::snprintf(line, sizeof(line), "%10u.%06u %5uus 0x%02X %c %2u/%-2u err 0x%02X ",
+		r.t_us / 1000000, r.t_us % 1000000, r.dur_us, r.addr, (r.dir == TW_WRITE) ? 'W' : 'R',
+		r.done, r.len, r.err);
+	std::string s(line, (size_t)n);
+	for (uint8_t b : r.data) {
+		std::snprintf(line, sizeof(line), " %02X", b);
+		s += line;
+	}
+	return s;
+}
+
+
+void TraceRecorder::attach() {
+	trace_current = &trace_;
+	i2c_setTraceHook(&TraceRecorder::hook);
+}
+
+
+void TraceRecorder::detach() {
+	i2c_setTraceHook(0);
+	trace_current = nullptr;
+}
+
+
+void TraceRecorder::hook(const I2c_trace_t* txn) {
+	if (trace_current == nullptr) {
+		return;
+	}
+	TraceRecord r;
+	r.t_us = txn->t_us;
+	r.dur_us = txn->dur_us;
+	r.addr = txn->addr;
+	r.dir = txn->dir;
+	r.len = txn->len;
+	r.done = txn->done;
+	r.err = txn->err;
+	size_t bytes = (txn->dir == TW_WRITE) ? txn->len : txn->done;
+	r.data.assign(txn->data, txn->data + bytes);
+	trace_current->records.push_back(std::move(r));
+}
+
+
+TraceReplay::TraceReplay(const Trace& trace) : trace_(trace) {
+}
+
+
+/***********************************************************
+ *
+ * One bus port per address seen in the trace, replaces
+ * whatever device was attached there
+ *
+ ***********************************************************/
+void TraceReplay::attach(TwiBus& bus) {
+	bool seen[128] = {};
+	for (const TraceRecord& r : trace_.records) {
+		if (!seen[r.addr & 0x7F]) {
+			seen[r.addr & 0x7F] = true;
+			ports_.emplace_back(new Port(*this, r.addr));
+			bus.attach(r.addr, ports_.back().get());
+		}
+	}
+}
+
+
+void TraceReplay::diverge(const std::string& why) {
+	if (!diverged_) {
+		diverged_ = true;
+		why_ = "transaction " + std::to_string(pos_) + ": " + why;
+	}
+	active_ = false;
+}
+
+
+/***********************************************************
+ *
+ * Address phase, must match the next recorded transaction.
+ * Recorded address NACKs are replayed as NACKs. Faults
+ * below the protocol (timeout, bus error, arbitration)
+ * cannot be produced by a device and replay as completed.
+ *
+ ***********************************************************/
+bool TraceReplay::start(uint8_t addr, bool read) {
+	
+	if (diverged_) {
+		return false;
+	}
+	if (finished()) {
+		diverge("driver continued past end of trace");
+		return false;
+	}
+	
+	const TraceRecord& r = trace_.records[pos_];
+	if ((r.addr != addr) || ((r.dir == TW_READ) != read)) {
+		char why[96];
+		std::snprintf(why, sizeof(why), "expected 0x%02X %c, driver sent 0x%02X %c",
+			r.addr, (r.dir == TW_WRITE) ? 'W' : 'R', addr, read ? 'R' : 'W');
+		diverge(why);
+		return false;
+	}
+	if ((r.err == TW_MT_SLA_NACK) || (r.err == TW_MR_SLA_NACK)) {
+		pos_++;
+		return false;
+	}
+	active_ = true;
+	byte_ = 0;
+	return true;
+}
+
+
+bool TraceReplay::write(uint8_t data) {
+	
+	if (!active_) {
+		return false;
+	}
+	const TraceRecord& r = trace_.records[pos_];
+	if (byte_ >= r.len) {
+		byte_++;
+		return true;						// PEC, not traced
+	}
+	if (r.data[byte_] != data) {
+		char why[96];
+		std::snprintf(why, sizeof(why), "byte %zu expected 0x%02X, driver sent 0x%02X",
+			byte_, r.data[byte_], data);
+		diverge(why);
+		return false;
+	}
+	if ((byte_ == r.done) && (r.err == TW_MT_DATA_NACK)) {
+		byte_++;
+		return false;
+	}
+	byte_++;
+	return true;
+}
+
+
+uint8_t TraceReplay::read() {
+	if (!active_) {
+		return 0xFF;
+	}
+	const TraceRecord& r = trace_.records[pos_];
+	return (byte_ < r.data.size()) ? r.data[byte_++] : 0xFF;
+}
+
+
+void TraceReplay::stop() {
+	if (active_) {
+		active_ = false;
+		pos_++;
+	}
+}
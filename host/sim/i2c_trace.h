@@ -0,0 +1,128 @@
+/*
+ * i2c_trace.h
+ *
+ * Created: 10/19/2026 7:46:39 AM
+ *
+ * Bus transaction traces from the i2c.c trace hook.
+ * TraceRecorder captures a simulated run, TraceReplay
+ * answers the driver from a trace in place of the gauge
+ * (and debug receiver) so the exact run repeats.
+ *
+ * File: "MAXTRC01", u16 header length, header fields
+ * (readers skip unknown trailing ones), then per
+ * transaction u32 t_us, u32 dur_us, u8 addr, u8 dir,
+ * u8 len, u8 done, u8 err, data. Data is len
+ * bytes for writes (what the driver meant to send) and
+ * done bytes for reads. Little endian.
+ */ 
+
+
+#ifndef I2C_TRACE_H_
+#define I2C_TRACE_H_
+
+#include "twi_bus.h"
+
+extern "C" {
+#include "i2c.h"
+}
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define TRACE_FILE_MAGIC	"MAXTRC01"
+
+struct TraceRecord {
+	uint32_t t_us;
+	uint32_t dur_us;
+	uint8_t addr;
+	uint8_t dir;
+	uint8_t len;
+	uint8_t done;
+	uint8_t err;
+	std::vector<uint8_t> data;
+};
+
+// pack settings the run depends on, replay must match
+struct TraceHeader {
+	uint32_t wake_s = 56;
+	uint32_t fscl = I2C_SCL_100KHZ;
+	I2c_retry_t retry = { I2C_RETRY_ATTEMPTS, I2C_RETRY_BACKOFF_MS,
+						  I2C_RETRY_BACKOFF_MAX_MS, I2C_RETRY_MASK };
+	uint8_t rsense = 10;
+	uint16_t capacity_mAh = 1200;
+	bool debug = true;
+	uint32_t wakes = 0;
+	uint32_t stretch_us = 0;		// gauge clock stretching, replayed
+};
+
+struct Trace {
+	TraceHeader header;
+	std::vector<TraceRecord> records;
+	
+	bool save(const std::string& path, std::string& error) const;
+	bool load(const std::string& path, std::string& error);
+};
+
+std::string traceFormat(const TraceRecord& r);
+
+
+// Records every controller transaction on this thread
+class TraceRecorder {
+public:
+	explicit TraceRecorder(Trace& trace) : trace_(trace) {}
+	
+	void attach();
+	static void detach();
+	
+private:
+	static void hook(const I2c_trace_t* txn);
+	
+	Trace& trace_;
+};
+
+
+class TraceReplay {
+public:
+	explicit TraceReplay(const Trace& trace);
+	
+	void attach(TwiBus& bus);
+	void setStretch(uint8_t addr, uint32_t us) { stretch_[addr & 0x7F] = us; }
+	
+	bool finished() const { return pos_ >= trace_.records.size(); }
+	bool diverged() const { return diverged_; }
+	size_t position() const { return pos_; }
+	const std::string& divergence() const { return why_; }
+	
+private:
+	class Port : public TwiDevice {
+	public:
+		Port(TraceReplay& replay, uint8_t addr) : replay_(replay), addr_(addr) {}
+		bool start(bool read) override { return replay_.start(addr_, read); }
+		bool write(uint8_t data) override { return replay_.write(data); }
+		uint8_t read(bool ack) override { (void)ack; return replay_.read(); }
+		void stop() override { replay_.stop(); }
+		uint32_t stretchUs() override { return replay_.stretch_[addr_ & 0x7F]; }
+	private:
+		TraceReplay& replay_;
+		uint8_t addr_;
+	};
+	
+	bool start(uint8_t addr, bool read);
+	bool write(uint8_t data);
+	uint8_t read();
+	void stop();
+	void diverge(const std::string& why);
+	
+	const Trace& trace_;
+	std::vector<std::unique_ptr<Port>> ports_;
+	uint32_t stretch_[128] = {};
+	size_t pos_ = 0;
+	size_t byte_ = 0;
+	bool active_ = false;
+	bool diverged_ = false;
+	std::string why_;
+};
+
+#endif /* I2C_TRACE_H_ */
@@ -0,0 +1,17 @@
+/*
+ * eeprom.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Host stand-in, reads the simulated EEPROM array
+ */ 
+
+
+#ifndef SIM_AVR_EEPROM_H_
+#define SIM_AVR_EEPROM_H_
+
+#include "avr/io.h"
+
+#define eeprom_read_word(addr)	sim_eepromReadWord((uintptr_t)(addr))
+
+#endif /* SIM_AVR_EEPROM_H_ */
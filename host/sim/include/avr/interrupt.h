@@ -0,0 +1,36 @@
+/*
+ * interrupt.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ */ 
+
+
+#ifndef SIM_AVR_INTERRUPT_H_
+#define SIM_AVR_INTERRUPT_H_
+
+#include "avr/io.h"
+
+// ISRs are plain functions the peripheral models call when
+// SREG_I is set, pending ones run from sei(), sleep_cpu()
+// and whenever virtual time moves
+#define cli()			(SREG &= (uint8_t)~_BV(SREG_I))
+#define sei()			sim_sei()
+
+#define ISR(vector)		void vector(void)
+#define TWI_vect			sim_twi_vect
+#define TIMER0_COMPA_vect	sim_timer0_compa_vect
+#define EE_READY_vect		sim_ee_ready_vect
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void sim_twi_vect(void);
+void sim_timer0_compa_vect(void);
+void sim_ee_ready_vect(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_AVR_INTERRUPT_H_ */
@@ -0,0 +1,162 @@
+/*
+ * io.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Host stand-in for <avr/io.h>, driver sources only (HOST_SIM)
+ * Registers with side effects go through an accessor so the
+ * peripheral models see every access: TWCR (TWI), EECR and
+ * EEDR (EEPROM), TCCR0B, OCR0A, TCNT0 and TIFR0 (Timer0).
+ * The other registers are plain per thread bytes.
+ */ 
+
+
+#ifndef SIM_AVR_IO_H_
+#define SIM_AVR_IO_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	uint8_t twcr;
+	uint8_t twdr;
+	uint8_t twsr;
+	uint8_t twbr;
+	uint8_t twar;
+	uint8_t sreg;
+	uint8_t twcr_model;		// TWCR as last left by the TWI model
+	uint8_t eecr;
+	uint8_t eecr_model;		// EECR as last left by the EEPROM model
+	uint8_t eedr;
+	uint16_t eear;
+	uint8_t tccr0a;
+	uint8_t tccr0b;
+	uint8_t ocr0a;
+	uint8_t tcnt0;
+	uint8_t tcnt0_model;	// TCNT0 as last left by the Timer0 model
+	uint8_t tifr0;
+	uint8_t timsk0;
+	uint8_t tccr1a;
+	uint8_t tccr1b;
+	uint16_t tcnt1;
+	uint8_t prr0;
+	uint8_t prr1;
+	uint8_t clkpr;
+	uint8_t smcr;
+	uint8_t adcsra;
+	uint8_t acsr;
+	uint8_t didr0;
+	uint8_t didr1;
+	uint8_t didr2;
+	uint8_t udcon;
+	uint8_t usbcon;
+	uint8_t pllcsr;
+	uint8_t uhwcon;
+}Sim_avr_t;
+
+extern __thread Sim_avr_t sim_avr;
+
+volatile uint8_t* sim_twcr(void);
+volatile uint8_t* sim_eecr(void);
+volatile uint8_t* sim_eedr(void);
+volatile uint8_t* sim_timer0(volatile uint8_t* reg);
+volatile uint8_t* sim_tifr0(void);
+void sim_clockPrescaleSet(uint8_t div);
+void sim_sei(void);
+void sim_sleepCpu(void);
+void sim_delayUs(double us);
+uint16_t sim_eepromReadWord(uintptr_t addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define _BV(bit)	(1 << (bit))
+
+#define SREG		(sim_avr.sreg)
+#define SREG_I		7
+
+#define TWCR		(*sim_twcr())
+#define TWDR		(sim_avr.twdr)
+#define TWSR		(sim_avr.twsr)
+#define TWBR		(sim_avr.twbr)
+#define TWAR		(sim_avr.twar)
+
+#define TWINT		7
+#define TWEA		6
+#define TWSTA		5
+#define TWSTO		4
+#define TWWC		3
+#define TWEN		2
+#define TWIE		0
+
+#define EECR		(*sim_eecr())
+#define EEDR		(*sim_eedr())
+#define EEAR		(sim_avr.eear)
+
+#define EERIE		3
+#define EEMPE		2
+#define EEPE		1
+#define EERE		0
+
+#define TCCR0A		(sim_avr.tccr0a)
+#define TCCR0B		(*sim_timer0(&sim_avr.tccr0b))
+#define OCR0A		(*sim_timer0(&sim_avr.ocr0a))
+#define TCNT0		(*sim_timer0(&sim_avr.tcnt0))
+#define TIFR0		(*sim_tifr0())
+#define TIMSK0		(sim_avr.timsk0)
+
+#define WGM01		1
+#define CS02		2
+#define CS01		1
+#define CS00		0
+#define OCF0A		1
+#define OCIE0A		1
+
+// Timer1 is only used by the profiling builds, not modelled
+#define TCCR1A		(sim_avr.tccr1a)
+#define TCCR1B		(sim_avr.tccr1b)
+#define TCNT1		(sim_avr.tcnt1)
+
+#define CS11		1
+#define CS10		0
+
+#define PRR0		(sim_avr.prr0)
+#define PRR1		(sim_avr.prr1)
+#define CLKPR		(sim_avr.clkpr)
+#define SMCR		(sim_avr.smcr)
+
+#define PRTWI		7
+#define PRTIM0		5
+#define PRTIM1		3
+#define PRSPI		2
+#define PRADC		0
+#define PRUSB		7
+#define PRTIM4		4
+#define PRTIM3		3
+#define PRUSART1	0
+
+#define SM2			3
+#define SM1			2
+#define SM0			1
+#define SE			0
+
+#define ADCSRA		(sim_avr.adcsra)
+#define ACSR		(sim_avr.acsr)
+#define DIDR0		(sim_avr.didr0)
+#define DIDR1		(sim_avr.didr1)
+#define DIDR2		(sim_avr.didr2)
+#define UDCON		(sim_avr.udcon)
+#define USBCON		(sim_avr.usbcon)
+#define PLLCSR		(sim_avr.pllcsr)
+#define UHWCON		(sim_avr.uhwcon)
+
+#define ACD			7
+#define DETACH		0
+#define FRZCLK		5
+#define UVREGE		0
+
+#endif /* SIM_AVR_IO_H_ */
@@ -0,0 +1,19 @@
+/*
+ * pgmspace.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ */ 
+
+
+#ifndef SIM_AVR_PGMSPACE_H_
+#define SIM_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr)		(*(const uint8_t*)(addr))
+#define pgm_read_word(addr)		(*(const uint16_t*)(addr))
+#define memcpy_P(dst, src, n)	memcpy((dst), (src), (n))
+
+#endif /* SIM_AVR_PGMSPACE_H_ */
@@ -0,0 +1,41 @@
+/*
+ * power.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Host stand-in, PRR0/PRR1 gating and the clock prescaler
+ * The prescaler write sets the simulated core clock
+ */ 
+
+
+#ifndef SIM_AVR_POWER_H_
+#define SIM_AVR_POWER_H_
+
+#include "avr/io.h"
+
+typedef enum {
+	clock_div_1 = 0,
+	clock_div_2 = 1,
+	clock_div_4 = 2,
+	clock_div_8 = 3,
+	clock_div_16 = 4,
+	clock_div_32 = 5,
+	clock_div_64 = 6,
+	clock_div_128 = 7,
+	clock_div_256 = 8
+}clock_div_t;
+
+#define clock_prescale_set(div)		sim_clockPrescaleSet((uint8_t)(div))
+#define clock_prescale_get()		((clock_div_t)(CLKPR & 0x0F))
+
+#define power_twi_enable()			(PRR0 &= (uint8_t)~_BV(PRTWI))
+#define power_twi_disable()			(PRR0 |= (uint8_t)_BV(PRTWI))
+#define power_timer0_enable()		(PRR0 &= (uint8_t)~_BV(PRTIM0))
+#define power_timer0_disable()		(PRR0 |= (uint8_t)_BV(PRTIM0))
+#define power_timer1_enable()		(PRR0 &= (uint8_t)~_BV(PRTIM1))
+#define power_timer1_disable()		(PRR0 |= (uint8_t)_BV(PRTIM1))
+
+#define power_all_disable()			(PRR0 |= (uint8_t)(_BV(PRTWI) | _BV(PRTIM0) | _BV(PRTIM1) | _BV(PRSPI) | _BV(PRADC)), \
+									 PRR1 |= (uint8_t)(_BV(PRUSB) | _BV(PRTIM4) | _BV(PRTIM3) | _BV(PRUSART1)))
+
+#endif /* SIM_AVR_POWER_H_ */
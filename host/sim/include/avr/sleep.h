@@ -0,0 +1,24 @@
+/*
+ * sleep.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Host stand-in, sleep_cpu() runs virtual time forward to
+ * the next enabled interrupt and services it
+ */ 
+
+
+#ifndef SIM_AVR_SLEEP_H_
+#define SIM_AVR_SLEEP_H_
+
+#include "avr/io.h"
+
+#define SLEEP_MODE_IDLE			0
+#define SLEEP_MODE_PWR_DOWN		(_BV(SM1))
+
+#define set_sleep_mode(mode)	(SMCR = (uint8_t)((SMCR & ~(_BV(SM2) | _BV(SM1) | _BV(SM0))) | (mode)))
+#define sleep_enable()			(SMCR |= (uint8_t)_BV(SE))
+#define sleep_disable()			(SMCR &= (uint8_t)~_BV(SE))
+#define sleep_cpu()				sim_sleepCpu()
+
+#endif /* SIM_AVR_SLEEP_H_ */
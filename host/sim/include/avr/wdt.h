@@ -0,0 +1,15 @@
+/*
+ * wdt.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Host stand-in, nothing the driver sources use directly
+ */ 
+
+
+#ifndef SIM_AVR_WDT_H_
+#define SIM_AVR_WDT_H_
+
+#include "avr/io.h"
+
+#endif /* SIM_AVR_WDT_H_ */
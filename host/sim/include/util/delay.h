@@ -0,0 +1,20 @@
+/*
+ * delay.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Host stand-in, busy waits cost active time. Like the
+ * real macros they assume F_CPU, a scaled core clock
+ * stretches them.
+ */ 
+
+
+#ifndef SIM_UTIL_DELAY_H_
+#define SIM_UTIL_DELAY_H_
+
+#include "avr/io.h"
+
+#define _delay_us(us)	sim_delayUs((double)(us))
+#define _delay_ms(ms)	sim_delayUs((double)(ms) * 1000.0)
+
+#endif /* SIM_UTIL_DELAY_H_ */
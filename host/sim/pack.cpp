@@ -0,0 +1,224 @@
+/*
+ * pack.cpp
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ */ 
+
+#include "pack.h"
+#include "sim_driver.h"
+
+#include <cmath>
+#include <cstring>
+
+extern "C" {
+#include "max17263.h"
+#include "i2c_stats.h"
+#include "timebase.h"
+#include "battery.h"
+}
+
+#define SIM_WDT_PERIOD_US	8000000ULL
+#define SIM_WDT_WAKE_US		50		// ISR + back to sleep
+
+
+// Synthetic OCV, X and RComp segments, not a real cell
+extern "C" const Max17263_model_t sim_cell_model = {
+	0x51AB,
+	{
+		0x9600, 0x9A00, 0x9E00, 0xA1FF, 0xA600, 0xAA00, 0xAE00, 0xB200,
+		0xB600, 0xB9FF, 0xBE00, 0xC200, 0xC600, 0xCA00, 0xCE00, 0xD200,
+		0x0064, 0x0118, 0x01CC, 0x0280, 0x0334, 0x03E8, 0x049C, 0x0550,
+		0x0604, 0x06B8, 0x076C, 0x0820, 0x08D4, 0x0988, 0x0A3C, 0x0AF0,
+		0x0100, 0x00F8, 0x00F0, 0x00E8, 0x00E0, 0x00D8, 0x00D0, 0x00C8,
+		0x00C0, 0x00B8, 0x00B0, 0x00A8, 0x00A0, 0x0098, 0x0090, 0x0088,
+	},
+	0x0070, 0x223E,
+	{ 0x1050, 0x0580, 0x0280, 0x0200 },
+};
+
+
+/***********************************************************
+ *
+ * End of a debug frame. Snapshot VCell (word 12 after the
+ * parse code, see max_debugSnapshot()) must be the cell
+ * voltage within a few mV, the cell barely moves between
+ * the burst read and the frame.
+ *
+ ***********************************************************/
+void DebugSink::stop() {
+	frames++;
+	if ((frame_.size() != 30) || (frame_[0] != (DEBUG_SNAPSHOT_CODE & 0xFF)) ||
+		(frame_[1] != (DEBUG_SNAPSHOT_CODE >> 8))) {
+		return;
+	}
+	snapshots++;
+	uint16_t vcell = (uint16_t)(frame_[26] | (frame_[27] << 8));
+	if (std::fabs(vcell * 78.125e-6 - gauge_.cellVoltage()) > 0.005) {
+		snapshot_errors++;
+	}
+}
+
+
+Pack::Pack(uint32_t id, const PackConfig& config)
+	: id_(id), config_(config), gauge_(ctx_, config.gauge, config.seed), debug_(gauge_) {
+	ctx_.bus.attach(MAX17263_I2C_ADDR, &gauge_);
+	ctx_.bus.attach(DEBUG_ADDR, &debug_);
+}
+
+
+/***********************************************************
+ *
+ * Power down until the next processing wake, one short
+ * active period per watchdog interrupt. Each interrupt
+ * advances the timebase as ISR(WDT_vect) in main.c does.
+ *
+ ***********************************************************/
+void Pack::sleep(uint64_t us) {
+	uint64_t wdt = us / SIM_WDT_PERIOD_US;
+	ctx_.advance(us - wdt * SIM_WDT_WAKE_US, CpuMode::PowerDown);
+	ctx_.advance(wdt * SIM_WDT_WAKE_US, CpuMode::Active);
+	for (uint64_t i = 0; i < wdt; i++) {
+		tb_advance((uint16_t)(SIM_WDT_PERIOD_US / 1000));
+	}
+}
+
+
+/***********************************************************
+ *
+ * main() up to the loop, through the same battery.c calls.
+ * The pack config stands in for the build flags and the
+ * EEPROM profile selector, io_init() has no counterpart.
+ *
+ ***********************************************************/
+void Pack::boot() {
+	
+	ctx_.bind();
+	sim_driverReset();
+	if (recorder_ != nullptr) {
+		recorder_->attach();
+	}
+	boots_++;
+	i2c_last_ = I2c_stats_t();
+	uint64_t start = ctx_.now();
+	
+	bat_config.debug = config_.debug;
+	bat_config.hib_profile = (config_.hib_profile < 0) ? BAT_HIB_SCHEDULE : (uint8_t)config_.hib_profile;
+	
+	bat_init(config_.fscl);
+	i2c_setRetryPolicy(&config_.retry);
+	
+	// cell profile built from the pack config, same
+	// encoding as the firmware table in cell_profiles.c
+	uint8_t rsense = config_.gauge.rsense;
+	Max17263_profile_t profile = {};
+	profile.rsense = rsense;
+	profile.DesignCap = MAX_DESIGNCAP((uint16_t)config_.gauge.capacity_mAh, rsense);
+	profile.IChgTerm = MAX_ICHGTERM(100, rsense);
+	profile.VEmpty = VEmpty_DEFAULT;
+	profile.ModelCfg = ModelCfg_DEFAULT;
+	profile.LEDCfg1 = MAX_LEDCFG1(4, 1, 1, LED_MODE_PUSH_BUTTON_TIMER, LED_ANI_MODE_OFF, 0, LED_TIME_1300MS);
+	profile.LEDCfg2 = LEDCfg2_DEFAULT | LED_MAX_BRIGHTNESS;
+	profile.LEDCfg3 = LEDCfg3_DEFAULT;
+	profile.model = config_.custom_model ? &sim_cell_model : NULL;
+	max_applyProfile(&profile);
+	
+	bat_start();
+	
+	// first pass of the loop, sleep_count not yet reached
+	bat_idle();
+	boot_us_ = ctx_.now() - start;
+}
+
+
+/***********************************************************
+ *
+ * Queued EEPROM writes finish, clock and timer down for
+ * sleep, bat_idle() as the main loop runs it
+ *
+ ***********************************************************/
+void Pack::flushEeprom() {
+	bat_idle();
+}
+
+
+/***********************************************************
+ *
+ * One pass of the main loop after COUNT_1_MIN watchdog
+ * periods. The firmware's 16 bit transport counters run
+ * on, each wake folds what they moved into 64 bit totals.
+ *
+ * @param flush : false leaves queued EEPROM writes pending
+ *                for fault injection before the flush
+ *
+ ***********************************************************/
+void Pack::wake(bool flush) {
+	
+	sleep((uint64_t)config_.wake_s * 1000000ULL);
+	wakes_++;
+	
+	bat_wake();
+	if (flush) {
+		bat_idle();
+	}
+	
+	I2c_stats_t now;
+	memcpy(&now, (const void*)&i2c_stats, sizeof(now));
+	i2c_transactions_ += (uint16_t)(now.transactions[I2C_TXN_TRANSMIT] - i2c_last_.transactions[I2C_TXN_TRANSMIT]);
+	i2c_transactions_ += (uint16_t)(now.transactions[I2C_TXN_RECEIVE] - i2c_last_.transactions[I2C_TXN_RECEIVE]);
+	i2c_retries_ += (uint16_t)(now.retries - i2c_last_.retries);
+	for (uint8_t i = 0; i < 32; i++) {
+		i2c_failures_ += (uint16_t)(now.status[i] - i2c_last_.status[i]);
+	}
+	i2c_last_ = now;
+}
+
+
+/***********************************************************
+ *
+ * Brown out or watchdog reset, RAM and the EEPROM write
+ * queue are lost, EEPROM contents and the gauge are not
+ *
+ ***********************************************************/
+void Pack::mcuReset() {
+	boot();
+}
+
+
+PackResult Pack::run() {
+	boot();
+	uint64_t end = (uint64_t)(config_.days * 86400e6);
+	while (ctx_.now() < end) {
+		wake();
+	}
+	return result();
+}
+
+
+PackResult Pack::result() {
+	PackResult r;
+	r.id = id_;
+	gauge_.advanceTo(ctx_.now());
+	r.true_mAh = gauge_.trueCapacity();
+	r.gauge_mAh = gauge_.estimatedCapacity();
+	r.learned_mAh = ctx_.eeRead(EEPROM_FullCapNom_ADDR) | (ctx_.eeRead(EEPROM_FullCapNom_ADDR + 1) << 8);
+	r.learned_mAh *= 5.0 / config_.gauge.rsense;
+	r.cycles = gauge_.cycles();
+	r.wakes = wakes_;
+	r.boots = boots_;
+	r.gauge_pors = gauge_.pors();
+	r.debug_frames = debug_.frames;
+	r.snapshots = debug_.snapshots;
+	r.snapshot_errors = debug_.snapshot_errors;
+	r.i2c_transactions = i2c_transactions_;
+	r.i2c_retries = i2c_retries_;
+	r.i2c_failures = i2c_failures_;
+	r.ee_max_wear = ctx_.eeMaxWear();
+	r.model_loads = gauge_.modelLoads();
+	r.boot_us = boot_us_;
+	r.gauge_uAh = gauge_.quiescent_uAh();
+	r.gauge_hib_s = gauge_.hibernate_us() * 1e-6;
+	r.energy = ctx_.energy;
+	r.ee = ctx_.ee_stats;
+	r.bus = ctx_.bus.stats;
+	return r;
+}
@@ -0,0 +1,133 @@
+/*
+ * pack.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * One simulated battery module: the firmware's main loop
+ * (boot, watchdog wakes, bat_process, EEPROM flush)
+ * run against a Max17263Model in virtual time. Boot and
+ * each wake call the battery.c functions main() uses.
+ */ 
+
+
+#ifndef PACK_H_
+#define PACK_H_
+
+#include "sim_context.h"
+#include "gauge_model.h"
+#include "i2c_trace.h"
+#include "vcd_writer.h"
+
+extern "C" {
+#include "i2c.h"
+#include "i2c_stats.h"
+#include "max17263.h"
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct PackConfig {
+	GaugeConfig gauge;
+	double days = 30;
+	uint32_t wake_s = 56;					// main.c COUNT_1_MIN x 8s WDT
+	uint32_t fscl = I2C_SCL_100KHZ;
+	I2c_retry_t retry = { I2C_RETRY_ATTEMPTS, I2C_RETRY_BACKOFF_MS,
+						  I2C_RETRY_BACKOFF_MAX_MS, I2C_RETRY_MASK };
+	bool debug = true;						// bat_config.debug, I2C_DEBUG frames each wake
+	int hib_profile = -1;					// bat_config.hib_profile, -1 for max_hibSchedule()
+	bool custom_model = false;				// load sim_cell_model instead of EZ config
+	uint32_t seed = 1;
+};
+
+struct PackResult {
+	uint32_t id = 0;
+	double true_mAh = 0;
+	double learned_mAh = 0;					// FullCapNom held in EEPROM
+	double gauge_mAh = 0;					// gauge estimate at end
+	double cycles = 0;
+	uint64_t wakes = 0;
+	uint64_t boots = 0;
+	uint64_t gauge_pors = 0;
+	uint64_t debug_frames = 0;
+	uint64_t snapshots = 0;					// snapshot frames checked
+	uint64_t snapshot_errors = 0;
+	uint64_t i2c_transactions = 0;
+	uint64_t i2c_retries = 0;
+	uint64_t i2c_failures = 0;
+	uint32_t ee_max_wear = 0;
+	uint64_t model_loads = 0;
+	uint64_t boot_us = 0;					// last boot, reset to main loop
+	double gauge_uAh = 0;					// gauge supply charge
+	double gauge_hib_s = 0;					// time in hibernate
+	EnergyStats energy;
+	EepromStats ee;
+	BusStats bus;
+};
+
+
+// Synthetic characterisation model for loader runs
+extern "C" const Max17263_model_t sim_cell_model;
+
+
+// Receiver at DEBUG_ADDR, counts frames and checks
+// snapshot VCell against the model's cell voltage, so a
+// wrong register mapping shows up in soak and fleet runs
+class DebugSink : public TwiDevice {
+public:
+	explicit DebugSink(const Max17263Model& gauge) : gauge_(gauge) {}
+	
+	bool start(bool read) override { (void)read; frame_.clear(); return true; }
+	bool write(uint8_t data) override { frame_.push_back(data); bytes++; return true; }
+	uint8_t read(bool ack) override { (void)ack; return 0xFF; }
+	void stop() override;
+	
+	uint64_t frames = 0;
+	uint64_t bytes = 0;
+	uint64_t snapshots = 0;
+	uint64_t snapshot_errors = 0;			// VCell off the cell voltage
+	
+private:
+	const Max17263Model& gauge_;
+	std::vector<uint8_t> frame_;
+};
+
+
+class Pack {
+public:
+	Pack(uint32_t id, const PackConfig& config);
+	
+	void boot();
+	void wake(bool flush = true);
+	void flushEeprom();
+	void mcuReset();
+	PackResult run();
+	PackResult result();
+	
+	void attach(uint8_t addr, TwiDevice* device) { ctx_.bus.attach(addr, device); }
+	void record(TraceRecorder* recorder) { recorder_ = recorder; }
+	void waveform(VcdWriter* vcd) { ctx_.bus.setVcd(vcd); }
+	
+	SimContext& context() { return ctx_; }
+	Max17263Model& gauge() { return gauge_; }
+	
+private:
+	void sleep(uint64_t us);
+	
+	uint32_t id_;
+	PackConfig config_;
+	SimContext ctx_;
+	Max17263Model gauge_;
+	DebugSink debug_;
+	TraceRecorder* recorder_ = nullptr;
+	uint64_t wakes_ = 0;
+	uint64_t boots_ = 0;
+	uint64_t boot_us_ = 0;
+	uint64_t i2c_transactions_ = 0;
+	uint64_t i2c_retries_ = 0;
+	uint64_t i2c_failures_ = 0;
+	I2c_stats_t i2c_last_ = {};				// counters at the last fold
+};
+
+#endif /* PACK_H_ */
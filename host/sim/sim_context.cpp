@@ -0,0 +1,137 @@
+/*
+ * sim_context.cpp
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ */ 
+
+#include "sim_context.h"
+
+#include "avr/io.h"
+
+extern "C" {
+__thread Sim_avr_t sim_avr;
+}
+
+static thread_local SimContext* sim_current = nullptr;
+
+
+/***********************************************************
+ *
+ * Active supply current by core clock, same table as
+ * clk_benchmark() (ATmega32U4 typ. @ 3.3V) extended down
+ * to the EEPROM flush clock. Idle taken as 40% of active.
+ *
+ ***********************************************************/
+double simActiveCurrent_uA(uint32_t fcpu) {
+	if (fcpu >= 8000000UL)	return 3800;
+	if (fcpu >= 4000000UL)	return 2100;
+	if (fcpu >= 2000000UL)	return 1200;
+	if (fcpu >= 1000000UL)	return 700;
+	return 250;
+}
+
+#define SIM_IDLE_FRACTION	0.4
+#define SIM_SLEEP_uA		6.0		// power down, WDT running
+
+
+SimContext::SimContext()
+	: eeprom_(SIM_EEPROM_SIZE, 0xFF), wear_(SIM_EEPROM_SIZE, 0) {
+}
+
+
+/***********************************************************
+ *
+ * Make this the context for driver calls on this thread
+ * Registers and peripherals as after reset, a byte being
+ * programmed completes. The bus keeps its devices.
+ *
+ ***********************************************************/
+void SimContext::bind() {
+	sim_current = this;
+	sim_avr = Sim_avr_t();
+	sim_avr.twcr = 0x02;
+	sim_avr.twcr_model = sim_avr.twcr;
+	sim_avr.sreg = 0x80;
+	bus.reset();
+	resetPeripherals();
+}
+
+
+SimContext& SimContext::current() {
+	return *sim_current;
+}
+
+
+/***********************************************************
+ *
+ * Charge energy for an interval in one power state
+ *
+ ***********************************************************/
+void SimContext::charge(uint64_t us, CpuMode mode) {
+	double uA;
+	switch (mode) {
+		case CpuMode::Active:
+			energy.active_us += us;
+			uA = simActiveCurrent_uA(fcpu_);
+			break;
+		case CpuMode::Idle:
+			energy.idle_us += us;
+			uA = simActiveCurrent_uA(fcpu_) * SIM_IDLE_FRACTION;
+			break;
+		default:
+			energy.sleep_us += us;
+			uA = SIM_SLEEP_uA;
+			break;
+	}
+	energy.energy_uJ += uA * SIM_VCC_V * (double)us * 1e-6;
+}
+
+
+/***********************************************************
+ *
+ * Move virtual time and charge energy for the interval
+ * Peripheral events inside it are stepped through in
+ * order, their interrupts run as they would on the part
+ *
+ ***********************************************************/
+void SimContext::advance(uint64_t us, CpuMode mode) {
+	uint64_t end = now_us_ + us;
+	eecrAccess();
+	timerSync();
+	for (;;) {
+		uint64_t next = nextEvent();
+		if (next > end) {
+			break;
+		}
+		charge(next - now_us_, mode);
+		now_us_ = next;
+		if (ee_programming_ && (ee_done_us_ <= now_us_)) {
+			eeComplete();
+		}
+		timerSync();
+		interrupts();
+	}
+	charge(end - now_us_, mode);
+	now_us_ = end;
+}
+
+
+/***********************************************************
+ *
+ * Core clock change, Timer0 counts up to here at the old
+ * rate
+ *
+ ***********************************************************/
+void SimContext::setCpuClock(uint32_t fcpu) {
+	timerSync();
+	fcpu_ = fcpu;
+}
+
+
+uint32_t SimContext::eeMaxWear() const {
+	uint32_t m = 0;
+	for (uint32_t w : wear_) {
+		m = (w > m) ? w : m;
+	}
+	return m;
+}
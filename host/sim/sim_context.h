@@ -0,0 +1,110 @@
+/*
+ * sim_context.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Per pack simulation state. The driver sources keep their
+ * globals thread local (INSTANCE_LOCAL), so a pack runs to
+ * completion on one worker thread with its context bound
+ * through SimContext::bind().
+ */ 
+
+
+#ifndef SIM_CONTEXT_H_
+#define SIM_CONTEXT_H_
+
+#include "twi_bus.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define SIM_F_CPU			8000000UL
+#define SIM_VCC_V			3.3
+#define SIM_EEPROM_SIZE		1024
+#define SIM_EEPROM_WRITE_US	3400		// erase + write, datasheet tWD_EEPROM
+
+// Thrown out of the driver when an injected MCU reset hits,
+// driver sources are built with -fexceptions to unwind
+struct SimReset {};
+
+// MCU power state for energy accounting
+enum class CpuMode { Active, Idle, PowerDown };
+
+struct EnergyStats {
+	uint64_t active_us = 0;
+	uint64_t idle_us = 0;
+	uint64_t sleep_us = 0;
+	double energy_uJ = 0;
+};
+
+struct EepromStats {
+	uint64_t bytes_programmed = 0;		// EEPE writes, the queue skips equal bytes
+};
+
+
+class SimContext {
+public:
+	SimContext();
+	
+	void bind();
+	static SimContext& current();
+	
+	// virtual time, peripheral events and their interrupts
+	// falling inside the interval run on the way
+	uint64_t now() const { return now_us_; }
+	void advance(uint64_t us, CpuMode mode);
+	void setCpuClock(uint32_t fcpu);
+	uint32_t cpuClock() const { return fcpu_; }
+	
+	// core side of the interrupt and sleep stand-ins
+	void interrupts();
+	void sleepCpu();
+	void delayUs(double us);
+	
+	// EEPROM peripheral, register side in sim_mcu.cpp
+	void eecrAccess();
+	uint8_t eeRead(uint16_t addr) const { return eeprom_[addr % SIM_EEPROM_SIZE]; }
+	uint16_t eeReadWord(uint16_t addr);
+	void eeTearAfter(size_t writes) { tear_left_ = writes; tear_armed_ = true; }
+	void eeTearDisarm() { tear_armed_ = false; }
+	uint32_t eeMaxWear() const;
+	std::vector<uint8_t>& eeprom() { return eeprom_; }
+	
+	// Timer0 peripheral
+	void timerAccess() { timerSync(); }
+	
+	TwiBus bus;
+	EnergyStats energy;
+	EepromStats ee_stats;
+	
+private:
+	void charge(uint64_t us, CpuMode mode);
+	void resetPeripherals();
+	uint64_t nextEvent() const;
+	void eeComplete();
+	bool timerRunning() const;
+	uint64_t timerPeriodNs() const;
+	void timerSync();
+	void isr(void (*vector)(void));
+	
+	uint64_t now_us_ = 0;
+	uint32_t fcpu_ = SIM_F_CPU;
+	std::vector<uint8_t> eeprom_;
+	std::vector<uint32_t> wear_;
+	bool ee_programming_ = false;
+	uint16_t ee_addr_ = 0;
+	uint8_t ee_data_ = 0;
+	uint64_t ee_done_us_ = 0;
+	bool tear_armed_ = false;
+	size_t tear_left_ = 0;
+	uint8_t t0_count_ = 0;
+	uint64_t t0_edge_ns_ = 0;			// time t0_count_ was reached
+	uint8_t tifr0_ = 0;
+	uint64_t isr_count_ = 0;
+	uint64_t isr_slept_ = 0;			// isr_count_ at the last sleep_cpu()
+};
+
+double simActiveCurrent_uA(uint32_t fcpu);
+
+#endif /* SIM_CONTEXT_H_ */
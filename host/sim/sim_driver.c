@@ -0,0 +1,49 @@
+/*
+ * sim_driver.c
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Built as C with the driver sources so it sees the same
+ * INSTANCE_LOCAL globals the driver uses.
+ */ 
+
+#include "string.h"
+#include "sim_driver.h"
+#include "max17263.h"
+#include "i2c_stats.h"
+#include "battery.h"
+
+
+static __thread Max17263_t sim_pristine;
+static __thread Bat_config_t sim_bat_pristine;
+static __thread bool sim_saved = false;
+
+
+/***********************************************************
+ *
+ * RAM state as after reset. The first call on a thread
+ * sees the initialised globals and keeps a copy, later
+ * calls (next pack, simulated MCU reset) restore it.
+ *
+ ***********************************************************/
+void sim_driverReset(void) {
+	if (!sim_saved) {
+		memcpy(&sim_pristine, (const void*)&max17263, sizeof(Max17263_t));
+		sim_bat_pristine = bat_config;
+		sim_saved = true;
+	}
+	else {
+		memcpy((void*)&max17263, &sim_pristine, sizeof(Max17263_t));
+		bat_config = sim_bat_pristine;
+	}
+	max_cacheInvalidateAll();
+	max_statusReset();
+	max_hibReset();
+	max_setModel(NULL);
+	i2c_stats_clear();
+	memset((void*)&pwr_stats, 0, sizeof(Pwr_stats_t));
+	ee_reset();
+	tb_reset();
+	i2c_setTraceHook(0);
+	i2c_target_disable();
+}
@@ -0,0 +1,22 @@
+/*
+ * sim_driver.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ */ 
+
+
+#ifndef SIM_DRIVER_H_
+#define SIM_DRIVER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// driver globals back to power up values (MCU reset)
+void sim_driverReset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_DRIVER_H_ */
@@ -0,0 +1,323 @@
+/*
+ * sim_mcu.cpp
+ *
+ * Created: 10/19/2026 8:29:25 AM
+ *
+ * ATmega32U4 peripherals the driver sources touch besides
+ * TWI: EEPROM, Timer0, clock prescaler and sleep. The real
+ * timebase.c, eeprom_queue.c, clock.c and power_mgmt.c run
+ * against these, time is virtual.
+ */ 
+
+#include "sim_context.h"
+
+#include "avr/io.h"
+#include "avr/interrupt.h"
+#include "avr/sleep.h"
+
+#include <cmath>
+#include <stdexcept>
+
+// TIFR0 bit 7 is reserved and reads 0 on the part. Like
+// SIM_TWCR_SEEN it marks contents the model left behind,
+// a write (flags are write one to clear) always clears it
+#define SIM_TIFR0_SEEN	0x80
+
+#define SIM_CS0_MASK	(_BV(CS02) | _BV(CS01) | _BV(CS00))
+
+// Timer0 prescaler by CS02:0, external clock not modelled
+static const uint16_t sim_t0_prescaler[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+
+
+/***********************************************************
+ *
+ * MCU reset, a byte being programmed still completes
+ *
+ ***********************************************************/
+void SimContext::resetPeripherals() {
+	if (ee_programming_) {
+		eeComplete();
+	}
+	fcpu_ = SIM_F_CPU;
+	t0_count_ = 0;
+	t0_edge_ns_ = now_us_ * 1000;
+	tifr0_ = 0;
+	isr_count_ = 0;
+	isr_slept_ = 0;
+}
+
+
+/***********************************************************
+ *
+ * Time of the next peripheral event, EEPROM write done or
+ * Timer0 compare match with its interrupt enabled
+ *
+ ***********************************************************/
+uint64_t SimContext::nextEvent() const {
+	uint64_t next = UINT64_MAX;
+	if (ee_programming_) {
+		next = ee_done_us_;
+	}
+	if (timerRunning() && (sim_avr.timsk0 & _BV(OCIE0A))) {
+		uint8_t top = sim_avr.ocr0a;
+		uint64_t counts = (t0_count_ <= top) ? (uint64_t)(top - t0_count_ + 1) : (uint64_t)(256 - t0_count_ + top + 1);
+		uint64_t t = (t0_edge_ns_ + counts * timerPeriodNs() + 999) / 1000;
+		next = (t < next) ? t : next;
+	}
+	return next;
+}
+
+
+/***********************************************************
+ *
+ * Run one interrupt vector, I cleared for its duration
+ * as the hardware does
+ *
+ ***********************************************************/
+void SimContext::isr(void (*vector)(void)) {
+	isr_count_++;
+	sim_avr.sreg &= (uint8_t)~_BV(SREG_I);
+	vector();
+	sim_avr.sreg |= _BV(SREG_I);
+}
+
+
+/***********************************************************
+ *
+ * Service pending interrupts while SREG_I is set, Timer0
+ * compare match ahead of EE_READY (vector order)
+ *
+ ***********************************************************/
+void SimContext::interrupts() {
+	while (sim_avr.sreg & _BV(SREG_I)) {
+		eecrAccess();
+		timerSync();
+		if ((tifr0_ & _BV(OCF0A)) && (sim_avr.timsk0 & _BV(OCIE0A))) {
+			tifr0_ &= (uint8_t)~_BV(OCF0A);
+			sim_avr.tifr0 = tifr0_ | SIM_TIFR0_SEEN;
+			isr(sim_timer0_compa_vect);
+		}
+		else if ((sim_avr.eecr & _BV(EERIE)) && !(sim_avr.eecr & _BV(EEPE))) {
+			isr(sim_ee_ready_vect);
+		}
+		else {
+			return;
+		}
+	}
+}
+
+
+/***********************************************************
+ *
+ * sleep_cpu(), runs time forward to the next event and
+ * services it. Pending interrupts already ran at sei(),
+ * one that ran since the last sleep stands in for the
+ * wake up and the call returns at once. The driver always
+ * sleeps in a loop re-checking its condition.
+ *
+ ***********************************************************/
+void SimContext::sleepCpu() {
+	
+	if (!(sim_avr.smcr & _BV(SE))) {
+		return;
+	}
+	interrupts();
+	if (isr_count_ != isr_slept_) {
+		isr_slept_ = isr_count_;
+		return;
+	}
+	
+	uint64_t next = nextEvent();
+	if ((next == UINT64_MAX) || !(sim_avr.sreg & _BV(SREG_I))) {
+		throw std::logic_error("sleep_cpu() with no wake up source");
+	}
+	uint8_t mode = sim_avr.smcr & (_BV(SM2) | _BV(SM1) | _BV(SM0));
+	advance(next - now_us_, (mode == SLEEP_MODE_IDLE) ? CpuMode::Idle : CpuMode::PowerDown);
+	isr_slept_ = isr_count_;
+}
+
+
+/***********************************************************
+ *
+ * _delay_us(), cycle counted for F_CPU so a scaled core
+ * clock stretches it
+ *
+ ***********************************************************/
+void SimContext::delayUs(double us) {
+	advance((uint64_t)std::llround(us * (double)SIM_F_CPU / (double)fcpu_), CpuMode::Active);
+}
+
+
+/***********************************************************
+ *
+ * Act on EECR writes since the last access. EERE strobes
+ * a read into EEDR, EEPE with EEMPE set starts an erase +
+ * write of EEDR to EEAR. An armed tear resets the MCU in
+ * place of a write.
+ *
+ ***********************************************************/
+void SimContext::eecrAccess() {
+	
+	uint8_t v = sim_avr.eecr;
+	uint8_t m = sim_avr.eecr_model;
+	if (v == m) {
+		return;
+	}
+	
+	if (v & _BV(EERE)) {
+		sim_avr.eedr = eeRead(sim_avr.eear);
+		v &= (uint8_t)~_BV(EERE);
+	}
+	
+	if ((v & _BV(EEPE)) && !(m & _BV(EEPE))) {
+		if ((v & _BV(EEMPE)) && !ee_programming_) {
+			if (tear_armed_ && (tear_left_-- == 0)) {
+				tear_armed_ = false;
+				throw SimReset();
+			}
+			ee_programming_ = true;
+			ee_addr_ = sim_avr.eear % SIM_EEPROM_SIZE;
+			ee_data_ = sim_avr.eedr;
+			ee_done_us_ = now_us_ + SIM_EEPROM_WRITE_US;
+		}
+		v &= (uint8_t)~_BV(EEMPE);
+	}
+	
+	// EEPE only clears when the write is done
+	v = ee_programming_ ? (v | _BV(EEPE)) : (v & (uint8_t)~_BV(EEPE));
+	sim_avr.eecr = v;
+	sim_avr.eecr_model = v;
+}
+
+
+void SimContext::eeComplete() {
+	eecrAccess();
+	eeprom_[ee_addr_] = ee_data_;
+	wear_[ee_addr_]++;
+	ee_stats.bytes_programmed++;
+	ee_programming_ = false;
+	sim_avr.eecr &= (uint8_t)~_BV(EEPE);
+	sim_avr.eecr_model = sim_avr.eecr;
+}
+
+
+/***********************************************************
+ *
+ * eeprom_read_word(), spins until a write in progress is
+ * done
+ *
+ ***********************************************************/
+uint16_t SimContext::eeReadWord(uint16_t addr) {
+	eecrAccess();
+	if (ee_programming_) {
+		advance(ee_done_us_ - now_us_, CpuMode::Active);
+	}
+	return (uint16_t)(eeRead(addr) | (eeRead(addr + 1) << 8));
+}
+
+
+bool SimContext::timerRunning() const {
+	return !(sim_avr.prr0 & _BV(PRTIM0)) && (sim_t0_prescaler[sim_avr.tccr0b & SIM_CS0_MASK] != 0);
+}
+
+
+uint64_t SimContext::timerPeriodNs() const {
+	return (uint64_t)sim_t0_prescaler[sim_avr.tccr0b & SIM_CS0_MASK] * 1000000000ULL / fcpu_;
+}
+
+
+/***********************************************************
+ *
+ * Count Timer0 up to now at the current settings. CTC
+ * mode only (WGM01, TOP = OCR0A) as timebase.c runs it,
+ * a count above a lowered OCR0A runs on to 0xFF first.
+ * TCNT0 and TIFR0 writes since the last access apply
+ * before counting.
+ *
+ ***********************************************************/
+void SimContext::timerSync() {
+	
+	uint64_t now_ns = now_us_ * 1000;
+	
+	if (sim_avr.tcnt0 != sim_avr.tcnt0_model) {
+		t0_count_ = sim_avr.tcnt0;
+		t0_edge_ns_ = now_ns;
+	}
+	if (!(sim_avr.tifr0 & SIM_TIFR0_SEEN)) {
+		tifr0_ &= (uint8_t)~sim_avr.tifr0;
+	}
+	
+	if (!timerRunning()) {
+		t0_edge_ns_ = now_ns;
+	}
+	else {
+		uint64_t period = timerPeriodNs();
+		uint64_t counts = (now_ns - t0_edge_ns_) / period;
+		uint8_t top = sim_avr.ocr0a;
+		t0_edge_ns_ += counts * period;
+		
+		while (counts > 0) {
+			uint64_t wrap = (t0_count_ <= top) ? (uint64_t)(top - t0_count_ + 1) : (uint64_t)(256 - t0_count_);
+			if (counts < wrap) {
+				t0_count_ = (uint8_t)(t0_count_ + counts);
+				break;
+			}
+			if (t0_count_ <= top) {
+				tifr0_ |= _BV(OCF0A);
+			}
+			counts -= wrap;
+			t0_count_ = 0;
+			if (counts > top) {
+				tifr0_ |= _BV(OCF0A);
+				counts %= (uint64_t)top + 1;
+			}
+		}
+	}
+	
+	sim_avr.tcnt0 = t0_count_;
+	sim_avr.tcnt0_model = t0_count_;
+	sim_avr.tifr0 = tifr0_ | SIM_TIFR0_SEEN;
+}
+
+
+extern "C" volatile uint8_t* sim_eecr(void) {
+	SimContext::current().eecrAccess();
+	return &sim_avr.eecr;
+}
+
+extern "C" volatile uint8_t* sim_eedr(void) {
+	SimContext::current().eecrAccess();
+	return &sim_avr.eedr;
+}
+
+extern "C" volatile uint8_t* sim_timer0(volatile uint8_t* reg) {
+	SimContext::current().timerAccess();
+	return reg;
+}
+
+extern "C" volatile uint8_t* sim_tifr0(void) {
+	SimContext::current().timerAccess();
+	return &sim_avr.tifr0;
+}
+
+extern "C" void sim_clockPrescaleSet(uint8_t div) {
+	sim_avr.clkpr = div;
+	SimContext::current().setCpuClock(SIM_F_CPU >> div);
+}
+
+extern "C" void sim_sei(void) {
+	sim_avr.sreg |= _BV(SREG_I);
+	SimContext::current().interrupts();
+}
+
+extern "C" void sim_sleepCpu(void) {
+	SimContext::current().sleepCpu();
+}
+
+extern "C" void sim_delayUs(double us) {
+	SimContext::current().delayUs(us);
+}
+
+extern "C" uint16_t sim_eepromReadWord(uintptr_t addr) {
+	return SimContext::current().eeReadWord((uint16_t)addr);
+}
@@ -0,0 +1,121 @@
+/*
+ * thread_pool.cpp
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ */ 
+
+#include "thread_pool.h"
+
+
+ThreadPool::ThreadPool(unsigned threads) {
+	if (threads == 0) {
+		threads = 1;
+	}
+	for (unsigned i = 0; i < threads; i++) {
+		queues_.emplace_back(new Queue);
+	}
+	for (unsigned i = 0; i < threads; i++) {
+		workers_.emplace_back(&ThreadPool::worker, this, i);
+	}
+}
+
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		stop_ = true;
+	}
+	work_.notify_all();
+	for (std::thread& t : workers_) {
+		t.join();
+	}
+}
+
+
+/***********************************************************
+ *
+ * Queue a task, spread round robin over the workers
+ *
+ ***********************************************************/
+void ThreadPool::submit(std::function<void()> task) {
+	Queue& q = *queues_[next_++ % queues_.size()];
+	{
+		std::lock_guard<std::mutex> guard(q.lock);
+		q.tasks.push_back(std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		pending_++;
+	}
+	work_.notify_one();
+}
+
+
+/***********************************************************
+ *
+ * Block until every submitted task has finished
+ *
+ ***********************************************************/
+void ThreadPool::wait() {
+	std::unique_lock<std::mutex> guard(lock_);
+	done_.wait(guard, [this] { return pending_ == 0; });
+}
+
+
+/***********************************************************
+ *
+ * Own queue from the back, then steal from the front of
+ * the others starting at the next worker
+ *
+ ***********************************************************/
+bool ThreadPool::take(unsigned index, std::function<void()>& task) {
+	{
+		Queue& q = *queues_[index];
+		std::lock_guard<std::mutex> guard(q.lock);
+		if (!q.tasks.empty()) {
+			task = std::move(q.tasks.back());
+			q.tasks.pop_back();
+			return true;
+		}
+	}
+	for (size_t i = 1; i < queues_.size(); i++) {
+		Queue& q = *queues_[(index + i) % queues_.size()];
+		std::lock_guard<std::mutex> guard(q.lock);
+		if (!q.tasks.empty()) {
+			task = std::move(q.tasks.front());
+			q.tasks.pop_front();
+			steals_++;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void ThreadPool::worker(unsigned index) {
+	std::function<void()> task;
+	while (true) {
+		if (take(index, task)) {
+			task();
+			task = nullptr;
+			std::lock_guard<std::mutex> guard(lock_);
+			if (--pending_ == 0) {
+				done_.notify_all();
+			}
+			continue;
+		}
+		std::unique_lock<std::mutex> guard(lock_);
+		if (stop_) {
+			return;
+		}
+		// recheck under the lock, a submit may have raced the scan
+		bool queued = false;
+		for (auto& q : queues_) {
+			std::lock_guard<std::mutex> qguard(q->lock);
+			queued = queued || !q->tasks.empty();
+		}
+		if (!queued) {
+			work_.wait(guard);
+		}
+	}
+}
@@ -0,0 +1,62 @@
+/*
+ * thread_pool.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Work stealing pool for independent pack runs. Each worker
+ * owns a deque, runs its own work newest first and steals
+ * oldest first from the others once empty, so packs that
+ * finish early (short runs, fewer faults) do not leave
+ * threads idle.
+ */ 
+
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+	explicit ThreadPool(unsigned threads);
+	~ThreadPool();
+	
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	
+	void submit(std::function<void()> task);
+	void wait();
+	
+	unsigned size() const { return (unsigned)workers_.size(); }
+	uint64_t steals() const { return steals_; }
+	
+private:
+	struct Queue {
+		std::mutex lock;
+		std::deque<std::function<void()>> tasks;
+	};
+	
+	void worker(unsigned index);
+	bool take(unsigned index, std::function<void()>& task);
+	
+	std::vector<std::unique_ptr<Queue>> queues_;
+	std::vector<std::thread> workers_;
+	std::mutex lock_;
+	std::condition_variable work_;
+	std::condition_variable done_;
+	std::atomic<size_t> pending_{0};
+	std::atomic<uint64_t> steals_{0};
+	std::atomic<unsigned> next_{0};
+	bool stop_ = false;
+};
+
+#endif /* THREAD_POOL_H_ */
@@ -0,0 +1,244 @@
+/*
+ * twi_bus.cpp
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ */ 
+
+#include "twi_bus.h"
+#include "sim_context.h"
+#include "vcd_writer.h"
+
+#include "avr/io.h"
+#include "util/twi.h"
+
+// TWCR bit 1 is reserved and reads 0 on the part, the model
+// marks register contents it has already acted on with it so
+// a full write is always seen, read-modify-write is caught
+// against the copy the model left behind
+#define SIM_TWCR_SEEN	0x02
+
+
+void TwiBus::reset() {
+	target_ = nullptr;
+	phase_ = Phase::Idle;
+	owned_ = false;
+}
+
+
+/***********************************************************
+ *
+ * SCL from bit rate register, TWPS = 0
+ *
+ ***********************************************************/
+uint32_t TwiBus::sclHz(uint32_t fcpu, uint8_t twbr) const {
+	return fcpu / (16UL + 2UL * twbr);
+}
+
+
+/***********************************************************
+ *
+ * Bus time for a number of SCL periods plus any target
+ * clock stretching, CPU spins on TWINT meanwhile
+ *
+ ***********************************************************/
+void TwiBus::spend(SimContext& ctx, uint32_t bits, uint32_t stretch_us) {
+	uint32_t scl = sclHz(ctx.cpuClock(), sim_avr.twbr);
+	uint64_t us = ((uint64_t)bits * 1000000ULL + scl - 1) / scl + stretch_us;
+	stats.busy_us += us;
+	ctx.advance(us, CpuMode::Active);
+}
+
+
+void TwiBus::line(uint64_t t_ns, int signal, bool value) {
+	if (vcd_ != nullptr) {
+		vcd_->change(t_ns, (VcdSignal)signal, value);
+	}
+}
+
+
+/***********************************************************
+ *
+ * START, or repeated START from SCL low
+ *
+ * @returns : time SCL is low again after the condition
+ *
+ ***********************************************************/
+uint64_t TwiBus::waveStart(uint64_t t_ns, uint64_t half_ns) {
+	if (owned_) {
+		line(t_ns, VCD_SDA, true);
+		line(t_ns + half_ns / 2, VCD_SCL, true);
+		t_ns += half_ns;
+	}
+	line(t_ns, VCD_SDA, false);
+	line(t_ns + half_ns / 2, VCD_SCL, false);
+	return t_ns + half_ns / 2;
+}
+
+
+/***********************************************************
+ *
+ * 8 data bits MSB first and the ACK bit, SDA changes
+ * while SCL is low
+ *
+ * @returns : end of the ninth clock
+ *
+ ***********************************************************/
+uint64_t TwiBus::waveByte(uint64_t t_ns, uint64_t half_ns, uint8_t data, bool ack) {
+	for (uint8_t bit = 0; bit < 9; bit++) {
+		bool level = (bit < 8) ? ((data >> (7 - bit)) & 0x01) : !ack;
+		line(t_ns, VCD_SDA, level);
+		line(t_ns + half_ns, VCD_SCL, true);
+		line(t_ns + 2 * half_ns, VCD_SCL, false);
+		t_ns += 2 * half_ns;
+	}
+	return t_ns;
+}
+
+
+void TwiBus::waveStop(uint64_t t_ns, uint64_t half_ns) {
+	line(t_ns, VCD_SDA, false);
+	line(t_ns + half_ns / 2, VCD_SCL, true);
+	line(t_ns + half_ns, VCD_SDA, true);
+	line(t_ns + half_ns, VCD_TWSTO, false);
+}
+
+
+/***********************************************************
+ *
+ * Act on a TWCR write, one TWINT cycle of the controller
+ * state machine. Status lands in TWSR, TWINT set when done.
+ * The driver's own time since the last TWINT is charged
+ * first, it shows as SCL low (or idle) between bytes.
+ *
+ ***********************************************************/
+void TwiBus::control(SimContext& ctx, uint8_t twcr) {
+	
+	uint8_t status = TW_NO_INFO;
+	
+	if (!(twcr & _BV(TWEN))) {
+		reset();
+		sim_avr.twcr = twcr | SIM_TWCR_SEEN;
+		sim_avr.twcr_model = sim_avr.twcr;
+		return;
+	}
+	if (!(twcr & _BV(TWINT))) {
+		sim_avr.twcr = twcr | SIM_TWCR_SEEN;
+		sim_avr.twcr_model = sim_avr.twcr;
+		return;
+	}
+	
+	// not controlling the bus, TWINT write from the target
+	// ISR releases SCL for the host side (TwiHost)
+	if (!owned_ && !(twcr & (_BV(TWSTA) | _BV(TWSTO)))) {
+		sim_avr.twcr = (twcr & ~_BV(TWINT)) | SIM_TWCR_SEEN;
+		sim_avr.twcr_model = sim_avr.twcr;
+		return;
+	}
+	
+	ctx.advance(((uint64_t)SIM_TWI_DRIVER_CYCLES * 1000000ULL + ctx.cpuClock() - 1) / ctx.cpuClock(),
+		CpuMode::Active);
+	
+	uint64_t t_ns = ctx.now() * 1000;
+	uint64_t half_ns = 500000000ULL / sclHz(ctx.cpuClock(), sim_avr.twbr);
+	line(t_ns, VCD_TWINT, false);
+	
+	if (twcr & _BV(TWSTA)) {
+		status = owned_ ? TW_REP_START : TW_START;
+		if (owned_ && (target_ != nullptr)) {
+			target_->stop();
+		}
+		waveStart(t_ns, half_ns);
+		owned_ = true;
+		phase_ = Phase::Address;
+		target_ = nullptr;
+		stats.starts++;
+		spend(ctx, 1);
+	}
+	else if (twcr & _BV(TWSTO)) {
+		if (target_ != nullptr) {
+			target_->stop();
+		}
+		line(t_ns, VCD_TWSTO, true);
+		waveStop(t_ns, half_ns);
+		reset();
+		spend(ctx, 1);
+		// STOP does not set TWINT, TWSTO clears when sent
+		sim_avr.twcr = (twcr & ~(_BV(TWSTO) | _BV(TWINT))) | SIM_TWCR_SEEN;
+		sim_avr.twcr_model = sim_avr.twcr;
+		return;
+	}
+	else {
+		uint32_t stretch = 0;
+		
+		switch (phase_) {
+			
+			case Phase::Address: {
+				bool read = (sim_avr.twdr & 0x01) != 0;
+				auto it = devices_.find(sim_avr.twdr >> 1);
+				bool ack = (it != devices_.end()) && it->second->start(read);
+				target_ = ack ? it->second : nullptr;
+				if (ack) {
+					phase_ = read ? Phase::Read : Phase::Write;
+					status = read ? TW_MR_SLA_ACK : TW_MT_SLA_ACK;
+					stretch = target_->stretchUs();
+				}
+				else {
+					phase_ = Phase::Nacked;
+					status = read ? TW_MR_SLA_NACK : TW_MT_SLA_NACK;
+					stats.nacks++;
+				}
+				waveByte(t_ns, half_ns, sim_avr.twdr, ack);
+				stats.bytes++;
+				spend(ctx, 9, stretch);
+				break;
+			}
+			
+			case Phase::Write: {
+				bool ack = target_->write(sim_avr.twdr);
+				status = ack ? TW_MT_DATA_ACK : TW_MT_DATA_NACK;
+				stats.nacks += ack ? 0 : 1;
+				stretch = target_->stretchUs();
+				waveByte(t_ns, half_ns, sim_avr.twdr, ack);
+				stats.bytes++;
+				spend(ctx, 9, stretch);
+				break;
+			}
+			
+			case Phase::Read: {
+				bool ack = (twcr & _BV(TWEA)) != 0;
+				sim_avr.twdr = target_->read(ack);
+				status = ack ? TW_MR_DATA_ACK : TW_MR_DATA_NACK;
+				stretch = target_->stretchUs();
+				waveByte(t_ns, half_ns, sim_avr.twdr, ack);
+				stats.bytes++;
+				spend(ctx, 9, stretch);
+				break;
+			}
+			
+			default:
+				status = TW_BUS_ERROR;
+				break;
+		}
+	}
+	
+	line(ctx.now() * 1000, VCD_TWINT, true);
+	sim_avr.twsr = (uint8_t)((sim_avr.twsr & ~TW_STATUS_MASK) | status);
+	sim_avr.twcr = (twcr & ~_BV(TWSTA)) | _BV(TWINT) | SIM_TWCR_SEEN;
+	sim_avr.twcr_model = sim_avr.twcr;
+}
+
+
+/***********************************************************
+ *
+ * Every TWCR access from i2c.c lands here first. A value
+ * other than the one the model left was written by the
+ * driver since the model last ran and is acted on now.
+ *
+ ***********************************************************/
+extern "C" volatile uint8_t* sim_twcr(void) {
+	if (sim_avr.twcr != sim_avr.twcr_model) {
+		SimContext& ctx = SimContext::current();
+		ctx.bus.control(ctx, sim_avr.twcr);
+	}
+	return &sim_avr.twcr;
+}
@@ -0,0 +1,76 @@
+/*
+ * twi_bus.h
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Host model of the ATmega32U4 TWI in controller mode.
+ * i2c.c drives it through TWCR/TWDR/TWSR exactly as on the
+ * part; each TWINT cycle is handed to the addressed device
+ * and costs bus time at the TWBR derived SCL rate.
+ */ 
+
+
+#ifndef TWI_BUS_H_
+#define TWI_BUS_H_
+
+#include <cstdint>
+#include <map>
+
+class SimContext;
+class VcdWriter;
+
+// CPU cycles between TWINT and the next TWCR write (call,
+// status check, loop), idle time on SCL between bytes
+#define SIM_TWI_DRIVER_CYCLES	40
+
+// I2C target on the simulated bus
+class TwiDevice {
+public:
+	virtual ~TwiDevice() = default;
+	virtual bool start(bool read) = 0;			// address phase, false = NACK
+	virtual bool write(uint8_t data) = 0;		// false = NACK
+	virtual uint8_t read(bool ack) = 0;
+	virtual void stop() = 0;
+	virtual uint32_t stretchUs() { return 0; }	// SCL held low after ACK
+};
+
+struct BusStats {
+	uint64_t starts = 0;
+	uint64_t bytes = 0;
+	uint64_t nacks = 0;
+	uint64_t busy_us = 0;
+};
+
+
+class TwiBus {
+public:
+	void attach(uint8_t addr, TwiDevice* device) { devices_[addr] = device; }
+	void detach(uint8_t addr) { devices_.erase(addr); }
+	void reset();
+	
+	// TWCR write observed by sim_twcr()
+	void control(SimContext& ctx, uint8_t twcr);
+	uint32_t sclHz(uint32_t fcpu, uint8_t twbr) const;
+	
+	// waveform of SCL/SDA/TWINT/TWSTO, nullptr to stop
+	void setVcd(VcdWriter* vcd) { vcd_ = vcd; }
+	
+	BusStats stats;
+	
+private:
+	enum class Phase { Idle, Address, Write, Read, Nacked };
+	
+	void spend(SimContext& ctx, uint32_t bits, uint32_t stretch_us = 0);
+	void line(uint64_t t_ns, int signal, bool value);
+	uint64_t waveStart(uint64_t t_ns, uint64_t half_ns);
+	uint64_t waveByte(uint64_t t_ns, uint64_t half_ns, uint8_t data, bool ack);
+	void waveStop(uint64_t t_ns, uint64_t half_ns);
+	
+	std::map<uint8_t, TwiDevice*> devices_;
+	TwiDevice* target_ = nullptr;
+	Phase phase_ = Phase::Idle;
+	bool owned_ = false;
+	VcdWriter* vcd_ = nullptr;
+};
+
+#endif /* TWI_BUS_H_ */
@@ -0,0 +1,159 @@
+/*
+ * twi_host.cpp
+ *
+ * Created: 10/19/2026 8:14:34 AM
+ */ 
+
+#include "twi_host.h"
+
+#include "avr/io.h"
+#include "util/twi.h"
+
+// ISR(TWI_vect) in i2c.c
+extern "C" void sim_twi_vect(void);
+
+
+// CRC-8, x^8 + x^2 + x + 1 (SMBus PEC)
+static uint8_t twiHostCrc8(uint8_t crc, uint8_t data) {
+	crc ^= data;
+	for (uint8_t i = 0; i < 8; i++) {
+		crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+	}
+	return crc;
+}
+
+
+/***********************************************************
+ *
+ * Target answers its address while TWAR matches and the
+ * driver left TWEN, TWEA and TWIE set
+ *
+ ***********************************************************/
+bool TwiHost::acked() const {
+	uint8_t armed = _BV(TWEN) | _BV(TWEA) | _BV(TWIE);
+	return ((sim_avr.twar >> 1) == addr_) && ((sim_avr.twcr & armed) == armed);
+}
+
+
+void TwiHost::event(uint8_t status) {
+	sim_avr.twsr = (uint8_t)((sim_avr.twsr & ~TW_STATUS_MASK) | status);
+	sim_twi_vect();
+}
+
+
+/***********************************************************
+ *
+ * START, addr+W, command, repeated START, addr+R, LSB,
+ * MSB, PEC when enabled, NACK + STOP
+ *
+ * @param cmd   : command byte
+ * @param value : word read
+ * @param pec   : expect and check a PEC byte
+ *
+ * @returns     : TWI_HOST_OK, TWI_HOST_NACK or TWI_HOST_PEC
+ *
+ ***********************************************************/
+uint8_t TwiHost::readWord(uint8_t cmd, uint16_t* value, bool pec) {
+	
+	if (!acked()) {
+		return TWI_HOST_NACK;
+	}
+	uint8_t crc = twiHostCrc8(0, (uint8_t)(addr_ << 1));
+	event(TW_SR_SLA_ACK);
+	
+	sim_avr.twdr = cmd;
+	crc = twiHostCrc8(crc, cmd);
+	event(TW_SR_DATA_ACK);
+	
+	// repeated START reports as STOP while addressed
+	event(TW_SR_STOP);
+	
+	crc = twiHostCrc8(crc, (uint8_t)((addr_ << 1) | TW_READ));
+	event(TW_ST_SLA_ACK);
+	uint8_t lo = sim_avr.twdr;
+	crc = twiHostCrc8(crc, lo);
+	
+	event(TW_ST_DATA_ACK);
+	uint8_t hi = sim_avr.twdr;
+	crc = twiHostCrc8(crc, hi);
+	*value = (uint16_t)(lo | (hi << 8));
+	
+	if (!pec) {
+		event(TW_ST_DATA_NACK);
+		return TWI_HOST_OK;
+	}
+	
+	event(TW_ST_DATA_ACK);
+	uint8_t rx = sim_avr.twdr;
+	event(TW_ST_DATA_NACK);
+	return (rx == crc) ? TWI_HOST_OK : TWI_HOST_PEC;
+}
+
+
+/***********************************************************
+ *
+ * START, addr+W, data bytes, PEC when enabled, STOP
+ *
+ ***********************************************************/
+uint8_t TwiHost::write(const uint8_t* data, uint8_t len, bool pec) {
+	
+	if (!acked()) {
+		return TWI_HOST_NACK;
+	}
+	uint8_t crc = twiHostCrc8(0, (uint8_t)(addr_ << 1));
+	event(TW_SR_SLA_ACK);
+	
+	for (uint8_t i = 0; i < len; i++) {
+		sim_avr.twdr = data[i];
+		crc = twiHostCrc8(crc, data[i]);
+		event(TW_SR_DATA_ACK);
+	}
+	if (pec) {
+		sim_avr.twdr = crc;
+		event(TW_SR_DATA_ACK);
+	}
+	event(TW_SR_STOP);
+	return TWI_HOST_OK;
+}
+
+
+/***********************************************************
+ *
+ * START, addr+R, LSB, MSB, PEC when enabled, NACK + STOP
+ * PEC covers this transaction only
+ *
+ ***********************************************************/
+uint8_t TwiHost::read(uint16_t* value, bool pec) {
+	
+	if (!acked()) {
+		return TWI_HOST_NACK;
+	}
+	uint8_t crc = twiHostCrc8(0, (uint8_t)((addr_ << 1) | TW_READ));
+	event(TW_ST_SLA_ACK);
+	uint8_t lo = sim_avr.twdr;
+	crc = twiHostCrc8(crc, lo);
+	
+	event(TW_ST_DATA_ACK);
+	uint8_t hi = sim_avr.twdr;
+	crc = twiHostCrc8(crc, hi);
+	*value = (uint16_t)(lo | (hi << 8));
+	
+	if (!pec) {
+		event(TW_ST_DATA_NACK);
+		return TWI_HOST_OK;
+	}
+	
+	event(TW_ST_DATA_ACK);
+	uint8_t rx = sim_avr.twdr;
+	event(TW_ST_DATA_NACK);
+	return (rx == crc) ? TWI_HOST_OK : TWI_HOST_PEC;
+}
+
+
+uint8_t TwiHost::addressOnly(bool read) {
+	if (!acked()) {
+		return TWI_HOST_NACK;
+	}
+	event(read ? TW_ST_SLA_ACK : TW_SR_SLA_ACK);
+	return TWI_HOST_OK;
+}
@@ -0,0 +1,49 @@
+/*
+ * twi_host.h
+ *
+ * Created: 10/19/2026 8:14:34 AM
+ *
+ * SMBus host on the far side of the firmware's I2C target
+ * mode. Each bus event is handed to ISR(TWI_vect) as the
+ * TWSR status the part would report, bytes go through
+ * TWDR. Bus timing is not modelled.
+ */ 
+
+
+#ifndef TWI_HOST_H_
+#define TWI_HOST_H_
+
+#include <cstdint>
+
+// host read results
+#define TWI_HOST_OK			0
+#define TWI_HOST_NACK		1		// address not acknowledged
+#define TWI_HOST_PEC		2		// PEC byte mismatch
+
+
+class TwiHost {
+public:
+	explicit TwiHost(uint8_t addr) : addr_(addr) {}
+	
+	// SMBus Read Word, optionally with PEC
+	uint8_t readWord(uint8_t cmd, uint16_t* value, bool pec = false);
+	
+	// write transaction ended by STOP, PEC appended when set
+	uint8_t write(const uint8_t* data, uint8_t len, bool pec = false);
+	
+	// read transaction with no command phase, word at the
+	// target's current command
+	uint8_t read(uint16_t* value, bool pec = false);
+	
+	// address for read or write and then go silent, no
+	// STOP or NACK ever follows (stuck or reset host)
+	uint8_t addressOnly(bool read);
+	
+private:
+	bool acked() const;
+	void event(uint8_t status);
+	
+	uint8_t addr_;
+};
+
+#endif /* TWI_HOST_H_ */
@@ -0,0 +1,95 @@
+/*
+ * vcd_writer.cpp
+ *
+ * Created: 10/19/2026 7:49:05 AM
+ */ 
+
+#include "vcd_writer.h"
+
+#include <cerrno>
+#include <cstring>
+
+static const char vcd_id[VCD_SIGNALS] = { '!', '"', '#', '$' };
+static const char* vcd_name[VCD_SIGNALS] = { "scl", "sda", "twint", "twsto" };
+
+
+VcdWriter::~VcdWriter() {
+	close();
+}
+
+
+/***********************************************************
+ *
+ * Create dump file, changes outside [from_ns, to_ns) are
+ * tracked but not written
+ *
+ ***********************************************************/
+bool VcdWriter::open(const std::string& path, uint64_t from_ns, uint64_t to_ns, std::string& error) {
+	close();
+	file_ = std::fopen(path.c_str(), "w");
+	if (file_ == nullptr) {
+		error = path + ": " + std::strerror(errno);
+		return false;
+	}
+	from_ns_ = from_ns;
+	to_ns_ = to_ns;
+	header();
+	return true;
+}
+
+
+bool VcdWriter::close() {
+	if (file_ == nullptr) {
+		return true;
+	}
+	bool ok = std::fclose(file_) == 0;
+	file_ = nullptr;
+	return ok;
+}
+
+
+void VcdWriter::header() {
+	std::fprintf(file_,
+		"$version max17263 host TWI model $end\n"
+		"$timescale 1ns $end\n"
+		"$scope module twi $end\n");
+	for (int i = 0; i < VCD_SIGNALS; i++) {
+		std::fprintf(file_, "$var wire 1 %c %s $end\n", vcd_id[i], vcd_name[i]);
+	}
+	std::fprintf(file_, "$upscope $end\n$enddefinitions $end\n");
+}
+
+
+/***********************************************************
+ *
+ * Record a signal level, times must not go backwards.
+ * Initial values are dumped at the start of the window.
+ *
+ ***********************************************************/
+void VcdWriter::change(uint64_t t_ns, VcdSignal signal, bool value) {
+	
+	if (value_[signal] == value) {
+		return;
+	}
+	value_[signal] = value;
+	
+	if ((file_ == nullptr) || (t_ns < from_ns_) || (t_ns >= to_ns_)) {
+		return;
+	}
+	if (!started_) {
+		std::fprintf(file_, "#%llu\n$dumpvars\n", (unsigned long long)from_ns_);
+		for (int i = 0; i < VCD_SIGNALS; i++) {
+			bool v = (i == signal) ? !value : value_[i];
+			std::fprintf(file_, "%d%c\n", v ? 1 : 0, vcd_id[i]);
+		}
+		std::fprintf(file_, "$end\n");
+		started_ = true;
+		last_ns_ = from_ns_;
+	}
+	if (t_ns != last_ns_) {
+		std::fprintf(file_, "#%llu\n", (unsigned long long)t_ns);
+		last_ns_ = t_ns;
+	}
+	std::fprintf(file_, "%d%c\n", value ? 1 : 0, vcd_id[signal]);
+	changes_++;
+}
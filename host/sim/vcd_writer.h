@@ -0,0 +1,50 @@
+/*
+ * vcd_writer.h
+ *
+ * Created: 10/19/2026 7:49:05 AM
+ *
+ * Value change dump of the simulated TWI lines for
+ * waveform viewers (GTKWave, PulseView, sigrok). One bit
+ * signals, 1ns timescale, optional capture window.
+ */ 
+
+
+#ifndef VCD_WRITER_H_
+#define VCD_WRITER_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+enum VcdSignal {
+	VCD_SCL,
+	VCD_SDA,
+	VCD_TWINT,
+	VCD_TWSTO,
+	VCD_SIGNALS
+};
+
+
+class VcdWriter {
+public:
+	~VcdWriter();
+	
+	bool open(const std::string& path, uint64_t from_ns, uint64_t to_ns, std::string& error);
+	bool close();
+	
+	void change(uint64_t t_ns, VcdSignal signal, bool value);
+	uint64_t changes() const { return changes_; }
+	
+private:
+	void header();
+	
+	FILE* file_ = nullptr;
+	uint64_t from_ns_ = 0;
+	uint64_t to_ns_ = UINT64_MAX;
+	uint64_t last_ns_ = 0;
+	uint64_t changes_ = 0;
+	bool started_ = false;
+	bool value_[VCD_SIGNALS] = { true, true, false, false };	// bus idle high
+};
+
+#endif /* VCD_WRITER_H_ */
@@ -0,0 +1,242 @@
+/*
+ * analytics.cpp
+ *
+ * Created: 10/19/2026 7:32:16 AM
+ */ 
+
+#include "analytics.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ANALYTICS_SSE2
+#endif
+
+
+bool analyticsSimd() {
+#ifdef ANALYTICS_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+void ColumnSummary::merge(const ColumnSummary& other) {
+	min = (other.min < min) ? other.min : min;
+	max = (other.max > max) ? other.max : max;
+	sum += other.sum;
+	count += other.count;
+}
+
+
+ColumnSummary summarizeScalar(const uint16_t* data, size_t len) {
+	ColumnSummary s;
+	for (size_t i = 0; i < len; i++) {
+		uint16_t v = data[i];
+		s.min = (v < s.min) ? v : s.min;
+		s.max = (v > s.max) ? v : s.max;
+		s.sum += v;
+	}
+	s.count = len;
+	return s;
+}
+
+
+/***********************************************************
+ *
+ * Min, max and sum of a column
+ * SSE2 has only signed 16 bit min/max, values are biased
+ * by 0x8000 so unsigned order maps onto signed order.
+ * Sums widen to 32 bit lanes and spill to 64 bit before
+ * a lane can overflow.
+ *
+ * @param data : raw register values
+ * @param len  : number of samples
+ *
+ ***********************************************************/
+ColumnSummary summarize(const uint16_t* data, size_t len) {
+#ifdef ANALYTICS_SSE2
+	
+	ColumnSummary s;
+	const __m128i bias = _mm_set1_epi16((short)0x8000);
+	const __m128i zero = _mm_setzero_si128();
+	__m128i vmin = _mm_set1_epi16(0x7FFF);
+	__m128i vmax = _mm_set1_epi16((short)0x8000);
+	size_t i = 0;
+	
+	while (i + 8 <= len) {
+		
+		// 2 x 65535 per 32 bit lane per step, spill well before 2^32
+		size_t block = len - i;
+		if (block > (size_t)8 * 16384) {
+			block = (size_t)8 * 16384;
+		}
+		block &= ~(size_t)7;
+		
+		__m128i acc = _mm_setzero_si128();
+		for (size_t end = i + block; i < end; i += 8) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+			__m128i b = _mm_xor_si128(v, bias);
+			vmin = _mm_min_epi16(vmin, b);
+			vmax = _mm_max_epi16(vmax, b);
+			acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+			acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(v, zero));
+		}
+		uint32_t lanes[4];
+		_mm_storeu_si128((__m128i*)lanes, acc);
+		s.sum += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	}
+	
+	int16_t mins[8];
+	int16_t maxs[8];
+	_mm_storeu_si128((__m128i*)mins, vmin);
+	_mm_storeu_si128((__m128i*)maxs, vmax);
+	if (i > 0) {
+		for (int l = 0; l < 8; l++) {
+			uint16_t lo = (uint16_t)mins[l] ^ 0x8000;
+			uint16_t hi = (uint16_t)maxs[l] ^ 0x8000;
+			s.min = (lo < s.min) ? lo : s.min;
+			s.max = (hi > s.max) ? hi : s.max;
+		}
+	}
+	s.count = i;
+	
+	s.merge(summarizeScalar(data + i, len - i));
+	return s;
+	
+#else
+	return summarizeScalar(data, len);
+#endif
+}
+
+
+/***********************************************************
+ *
+ * Accumulate fixed width histogram
+ * bin = (v - lo) / width, values below lo go to bin 0,
+ * above the range to the last bin. Division is done by
+ * 32 bit reciprocal (exact for 16 bit operands) and
+ * counts are spread over four tables so neighbouring
+ * equal samples don't serialize on one counter.
+ *
+ * @param lo    : first bin lower bound
+ * @param width : bin width in raw counts
+ * @param bins  : nbins counters, added to
+ *
+ ***********************************************************/
+void histogram(const uint16_t* data, size_t len, uint16_t lo, uint16_t width,
+			   uint64_t* bins, size_t nbins) {
+	
+	if ((nbins == 0) || (width == 0)) {
+		return;
+	}
+	
+	const uint64_t recip = ((1ULL << 32) + width - 1) / width;
+	const uint32_t last = (uint32_t)nbins - 1;
+	uint32_t* part = new uint32_t[4 * nbins]();
+	
+	size_t i = 0;
+	while (i < len) {
+		
+		// flush before a 32 bit sub-counter could wrap
+		size_t end = (len - i > 0x7FFFFFFF) ? i + 0x7FFFFFFF : len;
+		
+		for (; i + 4 <= end; i += 4) {
+			for (int k = 0; k < 4; k++) {
+				uint16_t v = data[i + k];
+				uint32_t d = (v > lo) ? (uint32_t)(v - lo) : 0;
+				uint32_t b = (uint32_t)((d * recip) >> 32);
+				part[k * nbins + ((b > last) ? last : b)]++;
+			}
+		}
+		for (; i < end; i++) {
+			uint16_t v = data[i];
+			uint32_t d = (v > lo) ? (uint32_t)(v - lo) : 0;
+			uint32_t b = (uint32_t)((d * recip) >> 32);
+			part[(b > last) ? last : b]++;
+		}
+		
+		for (size_t b = 0; b < nbins; b++) {
+			bins[b] += (uint64_t)part[b] + part[nbins + b] + part[2 * nbins + b] + part[3 * nbins + b];
+		}
+		std::memset(part, 0, 4 * nbins * sizeof(uint32_t));
+	}
+	delete[] part;
+}
+
+
+void convertScalar(const uint16_t* data, size_t len, float lsb, float* out) {
+	for (size_t i = 0; i < len; i++) {
+		out[i] = (float)data[i] * lsb;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Raw register values to engineering units
+ *
+ * @param lsb : units per count, see registerUnit()
+ * @param out : len floats
+ *
+ ***********************************************************/
+void convert(const uint16_t* data, size_t len, float lsb, float* out) {
+#ifdef ANALYTICS_SSE2
+	
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps(lsb);
+	size_t i = 0;
+	
+	for (; i + 8 <= len; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+		__m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero));
+		__m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero));
+		_mm_storeu_ps(out + i, _mm_mul_ps(lo, scale));
+		_mm_storeu_ps(out + i + 4, _mm_mul_ps(hi, scale));
+	}
+	convertScalar(data + i, len - i, lsb, out + i);
+	
+#else
+	convertScalar(data, len, lsb, out);
+#endif
+}
+
+
+/***********************************************************
+ *
+ * Register LSB by column name (UG6595 table 1)
+ * Capacity scales with sense resistor the same way as
+ * max_setCellCap(), 5.0uVh / rsense
+ *
+ * @param column : schema column name
+ * @param rsense : sense resistor in milliohms
+ *
+ ***********************************************************/
+RegisterUnit registerUnit(const std::string& column, uint8_t rsense) {
+	
+	if ((column == "rep_cap") || (column == "full_cap_rep") || (column == "full_cap_nom") ||
+		(column == "design_cap")) {
+		return { (0.005 / rsense) * 1000, "mAh" };
+	}
+	if ((column == "ichg_term") || (column == "current") || (column == "avg_current")) {
+		return { (0.0015625 / rsense) * 1000, "mA" };
+	}
+	if ((column == "vcell") || (column == "avg_vcell")) {
+		return { 0.078125, "mV" };
+	}
+	if (column == "temp") {
+		return { 1.0 / 256.0, "C" };
+	}
+	if (column == "rep_soc") {
+		return { 1.0 / 256.0, "%" };
+	}
+	if (column == "tte") {
+		return { 5.625 / 60.0, "min" };
+	}
+	if (column == "cycles") {
+		return { 0.01, "cycles" };
+	}
+	return { 1.0, "" };
+}
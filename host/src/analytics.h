@@ -0,0 +1,49 @@
+/*
+ * analytics.h
+ *
+ * Created: 10/19/2026 7:32:16 AM
+ *
+ * Kernels over raw uint16 register columns (RepCap, RepSOC,
+ * FullCapNom, Cycles ...). SSE2 when the compiler targets
+ * it, scalar otherwise. The *Scalar versions are always
+ * built and give identical results.
+ */ 
+
+
+#ifndef ANALYTICS_H_
+#define ANALYTICS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct ColumnSummary {
+	uint16_t min = UINT16_MAX;
+	uint16_t max = 0;
+	uint64_t sum = 0;
+	uint64_t count = 0;
+	
+	void merge(const ColumnSummary& other);
+	double mean() const { return count ? (double)sum / (double)count : 0.0; }
+};
+
+// Engineering units for a register column
+struct RegisterUnit {
+	double lsb;						// units per raw count
+	const char* unit;
+};
+
+bool analyticsSimd();
+
+ColumnSummary summarize(const uint16_t* data, size_t len);
+ColumnSummary summarizeScalar(const uint16_t* data, size_t len);
+
+void histogram(const uint16_t* data, size_t len, uint16_t lo, uint16_t width,
+			   uint64_t* bins, size_t nbins);
+
+void convert(const uint16_t* data, size_t len, float lsb, float* out);
+void convertScalar(const uint16_t* data, size_t len, float lsb, float* out);
+
+RegisterUnit registerUnit(const std::string& column, uint8_t rsense);
+
+#endif /* ANALYTICS_H_ */
@@ -0,0 +1,63 @@
+/*
+ * column_log.cpp
+ *
+ * Created: 10/19/2026 7:31:00 AM
+ */ 
+
+#include "column_log.h"
+
+
+/***********************************************************
+ *
+ * Column layout for a message type
+ *
+ ***********************************************************/
+std::vector<ColumnSpec> recordColumns(const Schema& schema) {
+	std::vector<ColumnSpec> columns = { {"timestamp_ms", 8}, {"device_ms", 4} };
+	for (const Column& c : schema.columns) {
+		columns.push_back({ c.name, c.width, c.is_signed });
+	}
+	return columns;
+}
+
+
+/***********************************************************
+ *
+ * Append record to its type's column file
+ *
+ ***********************************************************/
+bool ColumnLog::write(const Record& record, std::string& error) {
+	
+	const Schema& schema = *record.schema;
+	auto it = writers_.find(schema.code);
+	
+	if (it == writers_.end()) {
+		auto writer = std::make_unique<ColumnWriter>();
+		std::string path = dir_ + "/" + schema.name + ".mcol";
+		if (!writer->open(path, schema.name, recordColumns(schema), chunk_rows_, error)) {
+			return false;
+		}
+		it = writers_.emplace(schema.code, std::move(writer)).first;
+	}
+	
+	uint64_t row[2 + 32];
+	row[0] = (uint64_t)record.timestamp_ms;
+	row[1] = record.device_ms;
+	for (size_t c = 0; c < record.values.size(); c++) {
+		row[2 + c] = columnEncode(it->second->column(2 + c), record.values[c]);
+	}
+	if (!it->second->append(row)) {
+		error = dir_ + "/" + schema.name + ".mcol: write failed";
+		return false;
+	}
+	return true;
+}
+
+
+bool ColumnLog::flush() {
+	bool ok = true;
+	for (auto& w : writers_) {
+		ok = w.second->flush() && ok;
+	}
+	return ok;
+}
@@ -0,0 +1,42 @@
+/*
+ * column_log.h
+ *
+ * Created: 10/19/2026 7:31:00 AM
+ */ 
+
+
+#ifndef COLUMN_LOG_H_
+#define COLUMN_LOG_H_
+
+#include "column_store.h"
+#include "telemetry.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+/***********************************************************
+ *
+ * Decoded records into <dir>/<schema name>.mcol
+ * Columns are timestamp_ms (8), device_ms (4) then the
+ * schema columns at their wire width, signed columns
+ * stored biased (columnEncode())
+ *
+ ***********************************************************/
+class ColumnLog {
+public:
+	explicit ColumnLog(const std::string& dir, uint32_t chunk_rows = COLUMN_CHUNK_ROWS)
+		: dir_(dir), chunk_rows_(chunk_rows) {}
+	
+	bool write(const Record& record, std::string& error);
+	bool flush();
+	
+private:
+	std::string dir_;
+	uint32_t chunk_rows_;
+	std::map<uint16_t, std::unique_ptr<ColumnWriter>> writers_;
+};
+
+std::vector<ColumnSpec> recordColumns(const Schema& schema);
+
+#endif /* COLUMN_LOG_H_ */
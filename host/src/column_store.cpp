@@ -0,0 +1,418 @@
+/*
+ * column_store.cpp
+ *
+ * Created: 10/19/2026 7:31:00 AM
+ */ 
+
+#include "column_store.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// column blocks are mapped and read in place
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "column files are little endian");
+
+
+size_t columnHeaderSize(size_t columns) {
+	return 16 + COLUMN_SCHEMA_LEN + (columns * 32);
+}
+
+size_t columnChunkHeaderSize(size_t columns) {
+	return 8 + (columns * 16);
+}
+
+size_t columnBlockSize(uint32_t rows, uint8_t width) {
+	return ((size_t)rows * width + 7) & ~(size_t)7;
+}
+
+
+/***********************************************************
+ *
+ * Stored form of a value. Signed columns are biased by
+ * half their range (0x8000 for 2 bytes) so unsigned order
+ * of stored values is signed order of values, values out
+ * of range saturate.
+ *
+ ***********************************************************/
+uint64_t columnEncode(const ColumnSpec& column, int64_t value) {
+	if (!column.is_signed) {
+		return (uint64_t)value;
+	}
+	if (column.width == 8) {
+		return (uint64_t)value ^ (1ULL << 63);
+	}
+	int64_t half = 1LL << (8 * column.width - 1);
+	value = (value < -half) ? -half : value;
+	value = (value > half - 1) ? half - 1 : value;
+	return (uint64_t)(value + half);
+}
+
+
+int64_t columnDecode(const ColumnSpec& column, uint64_t stored) {
+	if (!column.is_signed) {
+		return (int64_t)stored;
+	}
+	if (column.width == 8) {
+		return (int64_t)(stored ^ (1ULL << 63));
+	}
+	return (int64_t)stored - (1LL << (8 * column.width - 1));
+}
+
+
+static uint64_t load(const uint8_t* p, uint8_t width) {
+	uint64_t v = 0;
+	std::memcpy(&v, p, width);
+	return v;
+}
+
+static void store(std::vector<uint8_t>& out, uint64_t v, uint8_t width) {
+	for (uint8_t b = 0; b < width; b++) {
+		out.push_back((uint8_t)(v >> (8 * b)));
+	}
+}
+
+static bool writeAll(int fd, const uint8_t* data, size_t len) {
+	while (len > 0) {
+		ssize_t n = ::write(fd, data, len);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		data += n;
+		len -= (size_t)n;
+	}
+	return true;
+}
+
+
+/***********************************************************
+ *
+ * Parse file header and walk chunks
+ *
+ * @param valid_end : end of last complete chunk
+ *
+ * @returns : false when header is missing or corrupt
+ *
+ ***********************************************************/
+bool columnParse(const uint8_t* data, size_t size, std::string& schema,
+				 std::vector<ColumnSpec>& columns, std::vector<ChunkInfo>& chunks,
+				 size_t& valid_end, std::string& error) {
+	
+	columns.clear();
+	chunks.clear();
+	
+	if ((size < 16) || (std::memcmp(data, COLUMN_FILE_MAGIC, 8) != 0)) {
+		error = "not a column file";
+		return false;
+	}
+	uint16_t version = (uint16_t)load(data + 8, 2);
+	uint16_t ncols = (uint16_t)load(data + 10, 2);
+	if (version != COLUMN_FILE_VERSION) {
+		error = "unsupported version " + std::to_string(version);
+		return false;
+	}
+	size_t header = columnHeaderSize(ncols);
+	if (size < header) {
+		error = "truncated header";
+		return false;
+	}
+	
+	schema.assign((const char*)data + 16, strnlen((const char*)data + 16, COLUMN_SCHEMA_LEN));
+	const uint8_t* p = data + 16 + COLUMN_SCHEMA_LEN;
+	for (uint16_t c = 0; c < ncols; c++, p += 32) {
+		ColumnSpec spec;
+		spec.name.assign((const char*)p, strnlen((const char*)p, COLUMN_NAME_LEN));
+		spec.width = p[COLUMN_NAME_LEN];
+		spec.is_signed = (p[COLUMN_NAME_LEN + 1] & COLUMN_FLAG_SIGNED) != 0;
+		if ((spec.width != 1) && (spec.width != 2) && (spec.width != 4) && (spec.width != 8)) {
+			error = "bad width for column " + spec.name;
+			return false;
+		}
+		columns.push_back(spec);
+	}
+	
+	size_t pos = header;
+	size_t chunk_header = columnChunkHeaderSize(ncols);
+	while (pos + chunk_header <= size) {
+		if (load(data + pos, 4) != COLUMN_CHUNK_MAGIC) {
+			break;
+		}
+		ChunkInfo chunk;
+		chunk.offset = pos;
+		chunk.rows = (uint32_t)load(data + pos + 4, 4);
+		size_t next = pos + chunk_header;
+		for (uint16_t c = 0; c < ncols; c++) {
+			chunk.min.push_back(load(data + pos + 8 + c * 16, 8));
+			chunk.max.push_back(load(data + pos + 16 + c * 16, 8));
+			chunk.data.push_back(next);
+			next += columnBlockSize(chunk.rows, columns[c].width);
+		}
+		if (next > size) {
+			break;								// torn write
+		}
+		chunks.push_back(std::move(chunk));
+		pos = next;
+	}
+	valid_end = pos;
+	return true;
+}
+
+
+ColumnWriter::~ColumnWriter() {
+	close();
+}
+
+
+/***********************************************************
+ *
+ * Create file or reopen for append
+ * Existing files must have the same columns, a torn
+ * last chunk is truncated away
+ *
+ * @param path       : file path
+ * @param schema     : message type name
+ * @param columns    : column names, widths and signedness
+ * @param chunk_rows : rows buffered per chunk
+ * @param error      : reason on failure
+ *
+ ***********************************************************/
+bool ColumnWriter::open(const std::string& path, const std::string& schema,
+						const std::vector<ColumnSpec>& columns, uint32_t chunk_rows, std::string& error) {
+	
+	close();
+	fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd_ < 0) {
+		error = path + ": " + std::strerror(errno);
+		return false;
+	}
+	columns_ = columns;
+	chunk_rows_ = (chunk_rows == 0) ? COLUMN_CHUNK_ROWS : chunk_rows;
+	pending_.assign(columns_.size(), {});
+	
+	struct stat st;
+	fstat(fd_, &st);
+	
+	if (st.st_size == 0) {
+		std::vector<uint8_t> header(COLUMN_FILE_MAGIC, COLUMN_FILE_MAGIC + 8);
+		store(header, COLUMN_FILE_VERSION, 2);
+		store(header, columns_.size(), 2);
+		store(header, chunk_rows_, 4);
+		header.resize(header.size() + COLUMN_SCHEMA_LEN, 0);
+		std::strncpy((char*)header.data() + 16, schema.c_str(), COLUMN_SCHEMA_LEN - 1);
+		for (const ColumnSpec& c : columns_) {
+			size_t at = header.size();
+			header.resize(at + 32, 0);
+			std::strncpy((char*)header.data() + at, c.name.c_str(), COLUMN_NAME_LEN - 1);
+			header[at + COLUMN_NAME_LEN] = c.width;
+			header[at + COLUMN_NAME_LEN + 1] = c.is_signed ? COLUMN_FLAG_SIGNED : 0;
+		}
+		if (!writeAll(fd_, header.data(), header.size())) {
+			error = path + ": " + std::strerror(errno);
+			close();
+			return false;
+		}
+		return true;
+	}
+	
+	// existing file, check layout and find append point
+	void* map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd_, 0);
+	if (map == MAP_FAILED) {
+		error = path + ": " + std::strerror(errno);
+		close();
+		return false;
+	}
+	std::string file_schema;
+	std::vector<ColumnSpec> file_columns;
+	std::vector<ChunkInfo> chunks;
+	size_t end = 0;
+	bool ok = columnParse((const uint8_t*)map, (size_t)st.st_size, file_schema, file_columns, chunks, end, error);
+	munmap(map, (size_t)st.st_size);
+	
+	if (ok && (file_columns.size() != columns_.size())) {
+		ok = false;
+	}
+	for (size_t c = 0; ok && (c < columns_.size()); c++) {
+		ok = (file_columns[c].name == columns_[c].name) && (file_columns[c].width == columns_[c].width) &&
+			 (file_columns[c].is_signed == columns_[c].is_signed);
+	}
+	if (!ok) {
+		if (error.empty()) {
+			error = path + ": columns do not match " + schema;
+		}
+		close();
+		return false;
+	}
+	
+	if ((end != (size_t)st.st_size) && (ftruncate(fd_, (off_t)end) != 0)) {
+		error = path + ": " + std::strerror(errno);
+		close();
+		return false;
+	}
+	lseek(fd_, (off_t)end, SEEK_SET);
+	return true;
+}
+
+
+/***********************************************************
+ *
+ * Add one row, chunk written once chunk_rows reached
+ *
+ * @param values : one stored value per column
+ *
+ ***********************************************************/
+bool ColumnWriter::append(const uint64_t* values) {
+	for (size_t c = 0; c < columns_.size(); c++) {
+		pending_[c].push_back(values[c]);
+	}
+	if (pending_[0].size() >= chunk_rows_) {
+		return writeChunk();
+	}
+	return true;
+}
+
+
+/***********************************************************
+ *
+ * Write buffered rows as a (short) chunk
+ * Makes them visible to readers, call sparingly since
+ * every chunk carries its own index entry
+ *
+ ***********************************************************/
+bool ColumnWriter::flush() {
+	if (columns_.empty() || pending_[0].empty()) {
+		return true;
+	}
+	return writeChunk();
+}
+
+
+bool ColumnWriter::writeChunk() {
+	
+	uint32_t rows = (uint32_t)pending_[0].size();
+	std::vector<uint8_t> out;
+	store(out, COLUMN_CHUNK_MAGIC, 4);
+	store(out, rows, 4);
+	
+	for (size_t c = 0; c < columns_.size(); c++) {
+		uint64_t lo = UINT64_MAX;
+		uint64_t hi = 0;
+		for (uint64_t v : pending_[c]) {
+			lo = (v < lo) ? v : lo;
+			hi = (v > hi) ? v : hi;
+		}
+		store(out, lo, 8);
+		store(out, hi, 8);
+	}
+	for (size_t c = 0; c < columns_.size(); c++) {
+		size_t at = out.size();
+		for (uint64_t v : pending_[c]) {
+			store(out, v, columns_[c].width);
+		}
+		out.resize(at + columnBlockSize(rows, columns_[c].width), 0);
+		pending_[c].clear();
+	}
+	return writeAll(fd_, out.data(), out.size());
+}
+
+
+void ColumnWriter::close() {
+	if (fd_ >= 0) {
+		flush();
+		::close(fd_);
+		fd_ = -1;
+	}
+}
+
+
+ColumnFile::~ColumnFile() {
+	close();
+}
+
+
+/***********************************************************
+ *
+ * Map file and build chunk index
+ * Only the headers are touched, column data is paged in
+ * on demand by queries
+ *
+ ***********************************************************/
+bool ColumnFile::open(const std::string& path, std::string& error) {
+	
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		error = path + ": " + std::strerror(errno);
+		return false;
+	}
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+		error = path + ": empty";
+		::close(fd);
+		return false;
+	}
+	void* map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (map == MAP_FAILED) {
+		error = path + ": " + std::strerror(errno);
+		return false;
+	}
+	map_ = (const uint8_t*)map;
+	size_ = (size_t)st.st_size;
+	
+	size_t end;
+	if (!columnParse(map_, size_, schema_, columns_, chunks_, end, error)) {
+		error = path + ": " + error;
+		close();
+		return false;
+	}
+	rows_ = 0;
+	for (const ChunkInfo& c : chunks_) {
+		rows_ += c.rows;
+	}
+	return true;
+}
+
+
+void ColumnFile::close() {
+	if (map_ != nullptr) {
+		munmap((void*)map_, size_);
+		map_ = nullptr;
+		size_ = 0;
+	}
+	columns_.clear();
+	chunks_.clear();
+	rows_ = 0;
+}
+
+
+int ColumnFile::findColumn(const std::string& name) const {
+	for (size_t c = 0; c < columns_.size(); c++) {
+		if (columns_[c].name == name) {
+			return (int)c;
+		}
+	}
+	return -1;
+}
+
+
+/***********************************************************
+ *
+ * Raw column block of a chunk, rows * width bytes,
+ * 8 byte aligned in the mapping
+ *
+ ***********************************************************/
+const uint8_t* ColumnFile::columnData(size_t chunk, size_t column) const {
+	return map_ + chunks_[chunk].data[column];
+}
+
+
+uint64_t ColumnFile::value(size_t chunk, size_t column, uint32_t row) const {
+	uint8_t width = columns_[column].width;
+	return load(columnData(chunk, column) + (size_t)row * width, width);
+}
@@ -0,0 +1,204 @@
+/*
+ * column_store.h
+ *
+ * Created: 10/19/2026 7:31:00 AM
+ *
+ * Append-only columnar telemetry file, one per message type
+ *
+ * File header (little endian, 8 byte aligned)
+ *   magic "MAXCOL01" | version u16 | columns u16 | chunk rows u32
+ *   schema name [32]
+ *   per column: name [24] | width u8 | flags u8 | pad [6]
+ *
+ * Chunks follow back to back
+ *   magic "CHNK" | rows u32 | per column: min u64, max u64
+ *   per column: rows * width bytes, padded to 8
+ *
+ * Signed columns (COLUMN_FLAG_SIGNED) are stored biased by
+ * half their range, see columnEncode(), so min/max and
+ * predicates compare stored values as unsigned.
+ *
+ * A chunk is only visible once completely written, a torn
+ * tail from a crash is ignored by readers and cut off
+ * when the file is opened for append.
+ */ 
+
+
+#ifndef COLUMN_STORE_H_
+#define COLUMN_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define COLUMN_FILE_MAGIC		"MAXCOL01"
+#define COLUMN_FILE_VERSION		1
+#define COLUMN_CHUNK_MAGIC		0x4B4E4843UL	// "CHNK"
+#define COLUMN_CHUNK_ROWS		4096
+#define COLUMN_NAME_LEN			24
+#define COLUMN_SCHEMA_LEN		32
+
+#define COLUMN_FLAG_SIGNED		0x01
+
+struct ColumnSpec {
+	std::string name;
+	uint8_t width;					// 1, 2, 4 or 8 bytes
+	bool is_signed = false;			// stored biased, see columnEncode()
+};
+
+
+/***********************************************************
+ *
+ * Streaming writer, rows buffered until a chunk fills
+ *
+ ***********************************************************/
+class ColumnWriter {
+public:
+	ColumnWriter() = default;
+	~ColumnWriter();
+	ColumnWriter(const ColumnWriter&) = delete;
+	ColumnWriter& operator=(const ColumnWriter&) = delete;
+	
+	bool open(const std::string& path, const std::string& schema,
+			  const std::vector<ColumnSpec>& columns, uint32_t chunk_rows, std::string& error);
+	bool append(const uint64_t* values);
+	bool flush();
+	void close();
+	size_t columns() const { return columns_.size(); }
+	const ColumnSpec& column(size_t c) const { return columns_[c]; }
+	
+private:
+	bool writeChunk();
+	
+	int fd_ = -1;
+	std::vector<ColumnSpec> columns_;
+	uint32_t chunk_rows_ = COLUMN_CHUNK_ROWS;
+	std::vector<std::vector<uint64_t>> pending_;		// per column
+};
+
+
+// chunk index entry, built when a file is opened
+struct ChunkInfo {
+	size_t offset;					// chunk header offset in file
+	uint32_t rows;
+	std::vector<uint64_t> min;
+	std::vector<uint64_t> max;
+	std::vector<size_t> data;		// column block offsets in file
+};
+
+// inclusive range on one column
+struct Predicate {
+	size_t column;
+	uint64_t lo;
+	uint64_t hi;
+};
+
+struct QueryStats {
+	size_t chunks = 0;
+	size_t chunks_scanned = 0;
+	uint64_t rows_scanned = 0;
+	uint64_t rows_matched = 0;
+};
+
+
+/***********************************************************
+ *
+ * Read-only mmap view of a column file
+ *
+ ***********************************************************/
+class ColumnFile {
+public:
+	ColumnFile() = default;
+	~ColumnFile();
+	ColumnFile(const ColumnFile&) = delete;
+	ColumnFile& operator=(const ColumnFile&) = delete;
+	
+	bool open(const std::string& path, std::string& error);
+	void close();
+	
+	const std::string& schema() const { return schema_; }
+	const std::vector<ColumnSpec>& columns() const { return columns_; }
+	int findColumn(const std::string& name) const;
+	const std::vector<ChunkInfo>& chunks() const { return chunks_; }
+	uint64_t rows() const { return rows_; }
+	
+	const uint8_t* columnData(size_t chunk, size_t column) const;
+	uint64_t value(size_t chunk, size_t column, uint32_t row) const;
+	
+	template <typename F>
+	QueryStats query(const std::vector<Predicate>& where, F match) const;
+	
+private:
+	const uint8_t* map_ = nullptr;
+	size_t size_ = 0;
+	std::string schema_;
+	std::vector<ColumnSpec> columns_;
+	std::vector<ChunkInfo> chunks_;
+	uint64_t rows_ = 0;
+};
+
+// value <-> stored form, order preserving for signed columns
+uint64_t columnEncode(const ColumnSpec& column, int64_t value);
+int64_t columnDecode(const ColumnSpec& column, uint64_t stored);
+
+// header / chunk layout, shared by reader and writer
+size_t columnHeaderSize(size_t columns);
+size_t columnChunkHeaderSize(size_t columns);
+size_t columnBlockSize(uint32_t rows, uint8_t width);
+bool columnParse(const uint8_t* data, size_t size, std::string& schema,
+				 std::vector<ColumnSpec>& columns, std::vector<ChunkInfo>& chunks,
+				 size_t& valid_end, std::string& error);
+
+
+/***********************************************************
+ *
+ * Visit rows matching all predicates
+ * Chunks whose min/max index cannot satisfy a predicate
+ * are skipped without touching their data
+ *
+ * @param where : predicates, ANDed
+ * @param match : called as match(chunk, row) per hit
+ *
+ ***********************************************************/
+template <typename F>
+QueryStats ColumnFile::query(const std::vector<Predicate>& where, F match) const {
+	
+	QueryStats stats;
+	stats.chunks = chunks_.size();
+	
+	for (size_t c = 0; c < chunks_.size(); c++) {
+		const ChunkInfo& chunk = chunks_[c];
+		
+		bool skip = false;
+		for (const Predicate& p : where) {
+			if ((chunk.max[p.column] < p.lo) || (chunk.min[p.column] > p.hi)) {
+				skip = true;
+				break;
+			}
+		}
+		if (skip) {
+			continue;
+		}
+		
+		stats.chunks_scanned++;
+		stats.rows_scanned += chunk.rows;
+		for (uint32_t r = 0; r < chunk.rows; r++) {
+			bool hit = true;
+			for (const Predicate& p : where) {
+				uint64_t v = value(c, p.column, r);
+				if ((v < p.lo) || (v > p.hi)) {
+					hit = false;
+					break;
+				}
+			}
+			if (hit) {
+				stats.rows_matched++;
+				match(c, r);
+			}
+		}
+	}
+	return stats;
+}
+
+#endif /* COLUMN_STORE_H_ */
@@ -0,0 +1,37 @@
+/*
+ * crc8.cpp
+ *
+ * Created: 10/19/2026 7:29:21 AM
+ */ 
+
+#include "crc8.h"
+
+
+/***********************************************************
+ *
+ * Update SMBus PEC with one byte
+ *
+ * @param crc  : running crc, 0 at start
+ * @param data : next byte
+ *
+ ***********************************************************/
+uint8_t crc8(uint8_t crc, uint8_t data) {
+	crc ^= data;
+	for (int b = 0; b < 8; b++) {
+		crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+	}
+	return crc;
+}
+
+
+/***********************************************************
+ *
+ * Update SMBus PEC with a buffer
+ *
+ ***********************************************************/
+uint8_t crc8(uint8_t crc, const uint8_t* data, size_t len) {
+	for (size_t i = 0; i < len; i++) {
+		crc = crc8(crc, data[i]);
+	}
+	return crc;
+}
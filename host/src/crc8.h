@@ -0,0 +1,18 @@
+/*
+ * crc8.h
+ *
+ * Created: 10/19/2026 7:29:21 AM
+ */ 
+
+
+#ifndef CRC8_H_
+#define CRC8_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// SMBus PEC, x^8 + x^2 + x + 1, same as firmware i2c_crc8()
+uint8_t crc8(uint8_t crc, uint8_t data);
+uint8_t crc8(uint8_t crc, const uint8_t* data, size_t len);
+
+#endif /* CRC8_H_ */
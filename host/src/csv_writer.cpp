@@ -0,0 +1,57 @@
+/*
+ * csv_writer.cpp
+ *
+ * Created: 10/19/2026 7:29:21 AM
+ */ 
+
+#include "csv_writer.h"
+
+#include <sys/stat.h>
+
+
+/***********************************************************
+ *
+ * Append record to its type's CSV
+ *
+ * @returns : false when the file cannot be opened
+ *
+ ***********************************************************/
+bool CsvWriter::write(const Record& record) {
+	
+	const Schema& schema = *record.schema;
+	auto it = files_.find(schema.code);
+	
+	if (it == files_.end()) {
+		std::string path = dir_ + "/" + schema.name + ".csv";
+		struct stat st;
+		bool exists = (stat(path.c_str(), &st) == 0) && (st.st_size > 0);
+		
+		auto file = std::make_unique<std::ofstream>(path, std::ios::app);
+		if (!*file) {
+			return false;
+		}
+		if (!exists) {
+			*file << "timestamp_ms,device_ms";
+			for (const Column& c : schema.columns) {
+				*file << "," << c.name;
+			}
+			*file << "\n";
+		}
+		it = files_.emplace(schema.code, std::move(file)).first;
+	}
+	
+	std::ofstream& out = *it->second;
+	out << record.timestamp_ms << "," << record.device_ms;
+	for (int64_t v : record.values) {
+		out << "," << v;
+	}
+	out << "\n";
+	return (bool)out;
+}
+
+
+void CsvWriter::flush() {
+	for (auto& f : files_) {
+		f.second->flush();
+	}
+}
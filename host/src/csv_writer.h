@@ -0,0 +1,37 @@
+/*
+ * csv_writer.h
+ *
+ * Created: 10/19/2026 7:29:21 AM
+ */ 
+
+
+#ifndef CSV_WRITER_H_
+#define CSV_WRITER_H_
+
+#include "telemetry.h"
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+
+/***********************************************************
+ *
+ * One CSV file per message type in an output directory
+ * <dir>/<schema name>.csv, header row on creation,
+ * appends to existing files
+ *
+ ***********************************************************/
+class CsvWriter {
+public:
+	explicit CsvWriter(const std::string& dir) : dir_(dir) {}
+	
+	bool write(const Record& record);
+	void flush();
+	
+private:
+	std::string dir_;
+	std::map<uint16_t, std::unique_ptr<std::ofstream>> files_;
+};
+
+#endif /* CSV_WRITER_H_ */
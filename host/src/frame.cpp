@@ -0,0 +1,188 @@
+/*
+ * frame.cpp
+ *
+ * Created: 10/19/2026 7:29:21 AM
+ */ 
+
+#include "frame.h"
+#include "crc8.h"
+
+#include <chrono>
+#include <cstring>
+
+
+/***********************************************************
+ *
+ * Feed received bytes, completed frames appended to out
+ * Frames failing PEC are dropped and parsing resumes at
+ * the next sync pattern
+ *
+ * @param data : received bytes
+ * @param len  : number of bytes
+ * @param out  : completed frames
+ *
+ ***********************************************************/
+void FrameParser::push(const uint8_t* data, size_t len, std::vector<Frame>& out) {
+	
+	for (size_t i = 0; i < len; i++) {
+		uint8_t c = data[i];
+		
+		switch (state_) {
+			
+			case State::Sync0:
+				if (c == FRAME_SYNC_0) {
+					state_ = State::Sync1;
+				}
+				else {
+					skipped_++;
+				}
+				break;
+			
+			case State::Sync1:
+				if (c == FRAME_SYNC_1) {
+					state_ = State::Header;
+					pos_ = 0;
+				}
+				else if (c != FRAME_SYNC_0) {
+					skipped_ += 2;
+					state_ = State::Sync0;
+				}
+				else {
+					skipped_++;
+				}
+				break;
+			
+			case State::Header:
+				header_[pos_++] = c;
+				if (pos_ == sizeof(header_)) {
+					frame_.device_ms = (uint32_t)header_[0] | ((uint32_t)header_[1] << 8) |
+									   ((uint32_t)header_[2] << 16) | ((uint32_t)header_[3] << 24);
+					frame_.data.clear();
+					pos_ = 0;
+					if (header_[4] > FRAME_MAX_DATA) {
+						pec_errors_++;				// corrupt length
+						state_ = State::Sync0;
+					}
+					else {
+						state_ = (header_[4] == 0) ? State::Pec : State::Data;
+					}
+				}
+				break;
+			
+			case State::Data:
+				frame_.data.push_back(c);
+				if (frame_.data.size() == header_[4]) {
+					state_ = State::Pec;
+				}
+				break;
+			
+			case State::Pec: {
+				uint8_t crc = crc8(0, header_, sizeof(header_));
+				crc = crc8(crc, frame_.data.data(), frame_.data.size());
+				if (crc == c) {
+					out.push_back(frame_);
+					frames_++;
+				}
+				else {
+					pec_errors_++;
+				}
+				state_ = State::Sync0;
+				break;
+			}
+		}
+	}
+}
+
+
+/***********************************************************
+ *
+ * Convert receiver millis() to wall clock milliseconds
+ *
+ ***********************************************************/
+int64_t DeviceClock::toHost(uint32_t device_ms) {
+	if (!started_) {
+		started_ = true;
+		last_ = device_ms;
+	}
+	elapsed_ += (uint32_t)(device_ms - last_);
+	last_ = device_ms;
+	return epoch_ms_ + elapsed_;
+}
+
+
+/***********************************************************
+ *
+ * Serialize frame in receiver wire format
+ *
+ ***********************************************************/
+std::vector<uint8_t> encodeFrame(const Frame& frame) {
+	std::vector<uint8_t> out;
+	out.reserve(FRAME_HEADER_LEN + frame.data.size() + 1);
+	out.push_back(FRAME_SYNC_0);
+	out.push_back(FRAME_SYNC_1);
+	for (int i = 0; i < 4; i++) {
+		out.push_back((uint8_t)(frame.device_ms >> (8 * i)));
+	}
+	out.push_back((uint8_t)frame.data.size());
+	out.insert(out.end(), frame.data.begin(), frame.data.end());
+	out.push_back(crc8(0, out.data() + 2, out.size() - 2));
+	return out;
+}
+
+
+/***********************************************************
+ *
+ * Capture file header, magic + epoch (LSB first)
+ *
+ ***********************************************************/
+std::vector<uint8_t> encodeCaptureHeader(int64_t epoch_ms) {
+	std::vector<uint8_t> out(CAPTURE_MAGIC, CAPTURE_MAGIC + 8);
+	for (int i = 0; i < 8; i++) {
+		out.push_back((uint8_t)((uint64_t)epoch_ms >> (8 * i)));
+	}
+	return out;
+}
+
+
+/***********************************************************
+ *
+ * Check for capture file header
+ *
+ * @returns : true and epoch_ms set when header present
+ *
+ ***********************************************************/
+bool decodeCaptureHeader(const uint8_t* data, size_t len, int64_t& epoch_ms) {
+	if ((len < CAPTURE_HEADER_LEN) || (std::memcmp(data, CAPTURE_MAGIC, 8) != 0)) {
+		return false;
+	}
+	uint64_t v = 0;
+	for (int i = 7; i >= 0; i--) {
+		v = (v << 8) | data[8 + i];
+	}
+	epoch_ms = (int64_t)v;
+	return true;
+}
+
+
+/***********************************************************
+ *
+ * Firmware parse code, first word of payload
+ *
+ ***********************************************************/
+uint16_t frameCode(const Frame& frame) {
+	if (frame.data.size() < 2) {
+		return 0;
+	}
+	return (uint16_t)(frame.data[0] | (frame.data[1] << 8));
+}
+
+
+/***********************************************************
+ *
+ * Milliseconds since unix epoch
+ *
+ ***********************************************************/
+int64_t wallClockMs() {
+	using namespace std::chrono;
+	return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,93 @@
+/*
+ * frame.h
+ *
+ * Created: 10/19/2026 7:29:21 AM
+ */ 
+
+
+#ifndef FRAME_H_
+#define FRAME_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// i2c_debug binary output (BINARY_OUTPUT true)
+// 0x7E 0xA5 | millis (4, LSB first) | len | data | PEC
+#define FRAME_SYNC_0		0x7E
+#define FRAME_SYNC_1		0xA5
+#define FRAME_HEADER_LEN	7		// sync + millis + len
+#define FRAME_MAX_DATA		32		// receiver Wire buffer
+
+// Capture file, magic + first frame host time, then frames
+#define CAPTURE_MAGIC		"MAXCAP01"
+#define CAPTURE_HEADER_LEN	16
+
+// One debug frame as received from the firmware
+struct Frame {
+	uint32_t device_ms = 0;			// receiver millis() at reception
+	std::vector<uint8_t> data;		// firmware payload, parse code first
+};
+
+
+/***********************************************************
+ *
+ * Streaming parser for the receiver's binary output
+ * Bytes can arrive in any split, text and line noise
+ * between frames is skipped and counted
+ *
+ ***********************************************************/
+class FrameParser {
+public:
+	void push(const uint8_t* data, size_t len, std::vector<Frame>& out);
+	
+	uint64_t frames() const { return frames_; }
+	uint64_t pecErrors() const { return pec_errors_; }
+	uint64_t skipped() const { return skipped_; }
+	
+private:
+	enum class State { Sync0, Sync1, Header, Data, Pec };
+	
+	State state_ = State::Sync0;
+	uint8_t header_[5] = {};
+	size_t pos_ = 0;
+	Frame frame_;
+	uint64_t frames_ = 0;
+	uint64_t pec_errors_ = 0;
+	uint64_t skipped_ = 0;
+};
+
+
+/***********************************************************
+ *
+ * Maps receiver millis() onto wall clock
+ * First frame is pinned to epoch_ms, later frames are
+ * offset by device time (unwrapped past 49 days)
+ *
+ ***********************************************************/
+class DeviceClock {
+public:
+	explicit DeviceClock(int64_t epoch_ms = 0) : epoch_ms_(epoch_ms) {}
+	
+	int64_t toHost(uint32_t device_ms);
+	void setEpoch(int64_t epoch_ms) { epoch_ms_ = epoch_ms; }
+	int64_t epoch() const { return epoch_ms_; }
+	bool started() const { return started_; }
+	
+private:
+	int64_t epoch_ms_;
+	bool started_ = false;
+	uint32_t last_ = 0;
+	int64_t elapsed_ = 0;
+};
+
+// wire format helpers, shared by capture writer and replayer
+std::vector<uint8_t> encodeFrame(const Frame& frame);
+std::vector<uint8_t> encodeCaptureHeader(int64_t epoch_ms);
+bool decodeCaptureHeader(const uint8_t* data, size_t len, int64_t& epoch_ms);
+
+uint16_t frameCode(const Frame& frame);
+int64_t wallClockMs();
+
+#endif /* FRAME_H_ */
@@ -0,0 +1,117 @@
+/*
+ * serial_port.cpp
+ *
+ * Created: 10/19/2026 7:29:21 AM
+ */ 
+
+#include "serial_port.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+
+/***********************************************************
+ *
+ * termios speed constant for baud rate
+ *
+ * @returns : B0 when unsupported
+ *
+ ***********************************************************/
+static speed_t baudConstant(uint32_t baud) {
+	switch (baud) {
+		case 9600:		return B9600;
+		case 19200:		return B19200;
+		case 38400:		return B38400;
+		case 57600:		return B57600;
+		case 115200:	return B115200;
+		case 230400:	return B230400;
+		case 460800:	return B460800;
+		case 500000:	return B500000;
+		case 921600:	return B921600;
+		case 1000000:	return B1000000;
+		default:		return B0;
+	}
+}
+
+
+SerialPort::~SerialPort() {
+	close();
+}
+
+
+/***********************************************************
+ *
+ * Open and configure port, raw mode 8N1
+ *
+ * @param path  : device, e.g. /dev/ttyACM0
+ * @param baud  : receiver DEBUG_BAUD
+ * @param error : reason on failure
+ *
+ ***********************************************************/
+bool SerialPort::open(const std::string& path, uint32_t baud, std::string& error) {
+	
+	speed_t speed = baudConstant(baud);
+	if (speed == B0) {
+		error = "unsupported baud rate " + std::to_string(baud);
+		return false;
+	}
+	
+	fd_ = ::open(path.c_str(), O_RDONLY | O_NOCTTY);
+	if (fd_ < 0) {
+		error = path + ": " + std::strerror(errno);
+		return false;
+	}
+	
+	struct termios tio;
+	if (tcgetattr(fd_, &tio) != 0) {
+		error = path + ": " + std::strerror(errno);
+		close();
+		return false;
+	}
+	cfmakeraw(&tio);
+	tio.c_cflag |= CLOCAL | CREAD;
+	tio.c_cc[VMIN] = 0;
+	tio.c_cc[VTIME] = 0;
+	cfsetispeed(&tio, speed);
+	cfsetospeed(&tio, speed);
+	if (tcsetattr(fd_, TCSANOW, &tio) != 0) {
+		error = path + ": " + std::strerror(errno);
+		close();
+		return false;
+	}
+	tcflush(fd_, TCIFLUSH);
+	return true;
+}
+
+
+void SerialPort::close() {
+	if (fd_ >= 0) {
+		::close(fd_);
+		fd_ = -1;
+	}
+}
+
+
+/***********************************************************
+ *
+ * Read whatever is available, waiting up to timeout_ms
+ *
+ * @returns : bytes read, 0 on timeout, -1 on error
+ *
+ ***********************************************************/
+long SerialPort::read(uint8_t* data, size_t len, int timeout_ms) {
+	struct pollfd pfd = { fd_, POLLIN, 0 };
+	int r = poll(&pfd, 1, timeout_ms);
+	if (r <= 0) {
+		return (r == 0 || errno == EINTR) ? 0 : -1;
+	}
+	ssize_t n = ::read(fd_, data, len);
+	if (n < 0) {
+		return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+	}
+	return (long)n;
+}
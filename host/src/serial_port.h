@@ -0,0 +1,36 @@
+/*
+ * serial_port.h
+ *
+ * Created: 10/19/2026 7:29:21 AM
+ */ 
+
+
+#ifndef SERIAL_PORT_H_
+#define SERIAL_PORT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/***********************************************************
+ *
+ * Raw 8N1 termios port for the debug receiver
+ *
+ ***********************************************************/
+class SerialPort {
+public:
+	SerialPort() = default;
+	~SerialPort();
+	SerialPort(const SerialPort&) = delete;
+	SerialPort& operator=(const SerialPort&) = delete;
+	
+	bool open(const std::string& path, uint32_t baud, std::string& error);
+	void close();
+	long read(uint8_t* data, size_t len, int timeout_ms);
+	bool isOpen() const { return fd_ >= 0; }
+	
+private:
+	int fd_ = -1;
+};
+
+#endif /* SERIAL_PORT_H_ */
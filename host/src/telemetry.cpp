@@ -0,0 +1,153 @@
+/*
+ * telemetry.cpp
+ *
+ * Created: 10/19/2026 7:29:21 AM
+ */ 
+
+#include "telemetry.h"
+
+#include <cstdio>
+
+
+/***********************************************************
+ *
+ * Message layouts, must follow the firmware debug
+ * functions (max_debugDataStruct(), pwr_debugStats() ...)
+ *
+ ***********************************************************/
+const std::vector<Schema>& schemas() {
+	static const std::vector<Schema> table = {
+		{ DEBUG_STARTUP_CODE, "startup", {} },
+		{ DEBUG_DONE_STARTUP_CODE, "startup_done", {} },
+		{ DEBUG_POR_CODE, "por", {} },
+		{ DEBUG_EEPROM_INIT_CODE, "eeprom_init", {} },
+		{ DEBUG_STRUCT_CODE, "struct", {
+			{"design_cap", 2}, {"ichg_term", 2}, {"vempty", 2}, {"model_cfg", 2},
+			{"rep_cap", 2}, {"rep_soc", 2}, {"tte", 2}, {"rcomp0", 2},
+			{"tempco", 2}, {"full_cap_rep", 2}, {"cycles", 2}, {"full_cap_nom", 2}
+		}},
+		{ DEBUG_EEPROM_CODE, "eeprom", {
+			{"rcomp0_addr", 2}, {"rcomp0", 2}, {"tempco_addr", 2}, {"tempco", 2},
+			{"full_cap_rep_addr", 2}, {"full_cap_rep", 2}, {"cycles_addr", 2}, {"cycles", 2},
+			{"full_cap_nom_addr", 2}, {"full_cap_nom", 2}
+		}},
+		{ DEBUG_FUEL_GAUGE_CODE, "fuel_gauge", {
+			{"rep_cap", 2}, {"rep_soc", 2}, {"tte", 2}
+		}},
+		{ DEBUG_SNAPSHOT_CODE, "snapshot", {
+			{"stamp_ms", 4}, {"span_us", 2}, {"rep_cap", 2}, {"rep_soc", 2},
+			{"temp", 2, true}, {"current", 2, true}, {"avg_current", 2, true}, {"full_cap_rep", 2},
+			{"tte", 2}, {"cycles", 2}, {"avg_vcell", 2}, {"vcell", 2}, {"ttf", 2}
+		}},
+		{ DEBUG_POWER_CODE, "power", {
+			{"twi_enables", 2}, {"twi_disables", 2}, {"enable_cycles", 2},
+			{"disable_cycles", 2}, {"enable_max", 2}, {"disable_max", 2}
+		}},
+		{ DEBUG_CLOCK_BENCH_CODE, "clock_bench", {
+			{"clock_div", 2}, {"time_us", 4}, {"energy_est_nj", 4}
+		}},
+		{ DEBUG_I2C_STATS_CODE, "i2c_stats", {
+			{"transmit", 2}, {"receive", 2}, {"bytes", 4}, {"sla_w_nack", 2},
+			{"data_nack", 2}, {"sla_r_nack", 2}, {"arb_lost", 2}, {"bus_error", 2},
+			{"timeouts", 2}, {"retries", 2}, {"pec_errors", 2}
+		}},
+		{ DEBUG_I2C_LATENCY_CODE, "i2c_latency", {
+			{"type", 2}, {"lt64us", 2}, {"lt128us", 2}, {"lt256us", 2}, {"lt512us", 2},
+			{"lt1ms", 2}, {"lt2ms", 2}, {"lt4ms", 2}, {"ge4ms", 2}
+		}},
+		{ RECEIVER_STATUS_CODE, "receiver_status", {
+			{"dropped", 2}, {"truncated", 2}
+		}},
+	};
+	return table;
+}
+
+
+/***********************************************************
+ *
+ * Look up schema by parse code or name
+ *
+ * @returns : schema, nullptr when unknown
+ *
+ ***********************************************************/
+const Schema* findSchema(uint16_t code) {
+	for (const Schema& s : schemas()) {
+		if (s.code == code) {
+			return &s;
+		}
+	}
+	return nullptr;
+}
+
+const Schema* findSchema(const std::string& name) {
+	for (const Schema& s : schemas()) {
+		if (name == s.name) {
+			return &s;
+		}
+	}
+	return nullptr;
+}
+
+
+/***********************************************************
+ *
+ * Decode firmware payload into a record
+ * Short frames (older firmware) leave missing columns 0,
+ * extra trailing bytes are ignored. Signed columns are
+ * sign extended from their wire width.
+ *
+ * @param frame        : received frame
+ * @param timestamp_ms : wall clock for record
+ * @param record       : decoded output
+ *
+ * @returns : false for unknown parse code
+ *
+ ***********************************************************/
+bool decodeFrame(const Frame& frame, int64_t timestamp_ms, Record& record) {
+	
+	const Schema* schema = findSchema(frameCode(frame));
+	if (schema == nullptr) {
+		return false;
+	}
+	
+	record.schema = schema;
+	record.timestamp_ms = timestamp_ms;
+	record.device_ms = frame.device_ms;
+	record.values.assign(schema->columns.size(), 0);
+	
+	size_t pos = 2;
+	for (size_t c = 0; c < schema->columns.size(); c++) {
+		uint8_t width = schema->columns[c].width;
+		if (pos + width > frame.data.size()) {
+			break;
+		}
+		uint32_t v = 0;
+		for (int b = width - 1; b >= 0; b--) {
+			v = (v << 8) | frame.data[pos + b];
+		}
+		if (schema->columns[c].is_signed) {
+			record.values[c] = (width == 2) ? (int16_t)v : (int32_t)v;
+		}
+		else {
+			record.values[c] = v;
+		}
+		pos += width;
+	}
+	return true;
+}
+
+
+/***********************************************************
+ *
+ * One line, name=value pairs for console output
+ *
+ ***********************************************************/
+std::string formatRecord(const Record& record) {
+	std::string line = std::to_string(record.timestamp_ms) + " " + record.schema->name;
+	for (size_t c = 0; c < record.values.size(); c++) {
+		char buf[48];
+		std::snprintf(buf, sizeof(buf), " %s=%lld", record.schema->columns[c].name, (long long)record.values[c]);
+		line += buf;
+	}
+	return line;
+}
@@ -0,0 +1,61 @@
+/*
+ * telemetry.h
+ *
+ * Created: 10/19/2026 7:29:21 AM
+ */ 
+
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "frame.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Firmware debug parse codes (max17263.h, power_mgmt.h, ...)
+#define DEBUG_STARTUP_CODE			0xAAAA
+#define DEBUG_DONE_STARTUP_CODE		0xBBBB
+#define DEBUG_POR_CODE				0xCCCC
+#define DEBUG_STRUCT_CODE			0xDDDD
+#define DEBUG_EEPROM_CODE			0xEEEE
+#define DEBUG_EEPROM_INIT_CODE		0xAABB
+#define DEBUG_FUEL_GAUGE_CODE		0xCCDD
+#define DEBUG_SNAPSHOT_CODE			0xADAD
+#define DEBUG_POWER_CODE			0xDDEE
+#define DEBUG_CLOCK_BENCH_CODE		0xEEFF
+#define DEBUG_I2C_STATS_CODE		0xABAB
+#define DEBUG_I2C_LATENCY_CODE		0xACAC
+#define RECEIVER_STATUS_CODE		0xFEFE
+
+// One column of a record, fixed width on the wire
+struct Column {
+	const char* name;
+	uint8_t width;					// bytes, 2 or 4
+	bool is_signed = false;			// two's complement on the wire
+};
+
+// Layout of one firmware message
+struct Schema {
+	uint16_t code;
+	const char* name;
+	std::vector<Column> columns;
+};
+
+// Decoded message, values in schema column order,
+// signed columns sign extended
+struct Record {
+	const Schema* schema = nullptr;
+	int64_t timestamp_ms = 0;		// wall clock (or capture relative)
+	uint32_t device_ms = 0;			// receiver millis()
+	std::vector<int64_t> values;
+};
+
+const std::vector<Schema>& schemas();
+const Schema* findSchema(uint16_t code);
+const Schema* findSchema(const std::string& name);
+bool decodeFrame(const Frame& frame, int64_t timestamp_ms, Record& record);
+std::string formatRecord(const Record& record);
+
+#endif /* TELEMETRY_H_ */
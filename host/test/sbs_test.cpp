@@ -0,0 +1,203 @@
+/*
+ * sbs_test.cpp
+ *
+ * Created: 10/19/2026 8:16:39 AM
+ *
+ * Smart Battery Data emulation: every sbs_commands[]
+ * conversion against hand computed values, then the map
+ * served to an SMBus host through the simulated target
+ * with live gauge registers behind it, Voltage against
+ * the model's cell voltage.
+ * Exit status 1 when any check fails.
+ */ 
+
+#include "pack.h"
+#include "twi_host.h"
+
+extern "C" {
+#include "max17263.h"
+#include "sbs.h"
+#include "timebase.h"
+}
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+	if (!(cond)) { \
+		failures++; \
+		std::printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+		std::printf(__VA_ARGS__); \
+		std::printf("\n"); \
+	} \
+} while (0)
+
+#define CHECK_CMD(regs, cmd, expect) \
+	CHECK((regs)[cmd] == (uint16_t)(expect), "%s = 0x%04X, expected 0x%04X", #cmd, (regs)[cmd], (uint16_t)(expect))
+
+
+static Sbs_snapshot_t snapshot(uint8_t pec, uint8_t rsense) {
+	Sbs_snapshot_t snap = {};
+	snap.pec = pec;
+	snap.rsense = rsense;
+	snap.raw[SBS_SRC_REPCAP] = 1200;			// 600mAh @ 10mOhm
+	snap.raw[SBS_SRC_REPSOC] = 50 * 256;
+	snap.raw[SBS_SRC_TTE] = 640;				// 60 min
+	snap.raw[SBS_SRC_FULLCAPREP] = 2300;		// 1150mAh
+	snap.raw[SBS_SRC_CYCLES] = 250;				// 2.5 cycles
+	snap.raw[SBS_SRC_DESIGNCAP] = 2400;			// 1200mAh
+	snap.raw[SBS_SRC_TEMP] = 25 * 256;
+	snap.raw[SBS_SRC_VCELL] = 47360;			// 3.7V
+	snap.raw[SBS_SRC_CURRENT] = (uint16_t)-3200;	// -500mA
+	snap.raw[SBS_SRC_AVGCURRENT] = 1600;		// +250mA
+	return snap;
+}
+
+
+/***********************************************************
+ *
+ * Command words from a fixed snapshot
+ *
+ ***********************************************************/
+static void testConversions() {
+	
+	uint16_t regs[SBS_COMMANDS];
+	Sbs_snapshot_t snap = snapshot(0, 10);
+	sbs_update(&snap, regs);
+	
+	CHECK_CMD(regs, SBS_REMAINING_CAPACITY, 600);
+	CHECK_CMD(regs, SBS_FULL_CHARGE_CAPACITY, 1150);
+	CHECK_CMD(regs, SBS_DESIGN_CAPACITY, 1200);
+	CHECK_CMD(regs, SBS_RELATIVE_STATE_OF_CHARGE, 50);
+	CHECK_CMD(regs, SBS_ABSOLUTE_STATE_OF_CHARGE, 50);
+	CHECK_CMD(regs, SBS_RUN_TIME_TO_EMPTY, 60);
+	CHECK_CMD(regs, SBS_AVERAGE_TIME_TO_EMPTY, 60);
+	CHECK_CMD(regs, SBS_AVERAGE_TIME_TO_FULL, SBS_UNKNOWN);
+	CHECK_CMD(regs, SBS_CYCLE_COUNT, 2);
+	CHECK_CMD(regs, SBS_BATTERY_STATUS, SBS_STATUS_INITIALIZED | SBS_STATUS_DISCHARGING);
+	CHECK_CMD(regs, SBS_SPECIFICATION_INFO, SBS_SPEC_INFO_1_1);
+	CHECK_CMD(regs, SBS_TEMPERATURE, 2982);				// 298.15K
+	CHECK_CMD(regs, SBS_VOLTAGE, 3700);
+	CHECK_CMD(regs, SBS_CURRENT, -500);
+	CHECK_CMD(regs, SBS_AVERAGE_CURRENT, 250);
+	CHECK_CMD(regs, SBS_MAX_ERROR, 1);
+	CHECK_CMD(regs, SBS_BATTERY_MODE, 0);
+	CHECK_CMD(regs, 0x05, SBS_UNKNOWN);					// not in the table
+	
+	// PEC advertised in SpecificationInfo
+	snap.pec = 1;
+	sbs_update(&snap, regs);
+	CHECK_CMD(regs, SBS_SPECIFICATION_INFO, SBS_SPEC_INFO_1_1_PEC);
+	
+	// full, charging, below 0C
+	snap.raw[SBS_SRC_REPSOC] = 101 * 256;
+	snap.raw[SBS_SRC_REPCAP] = 2500;
+	snap.raw[SBS_SRC_TTE] = 0xFFFF;
+	snap.raw[SBS_SRC_TEMP] = (uint16_t)(-10 * 256);
+	sbs_update(&snap, regs);
+	CHECK_CMD(regs, SBS_RELATIVE_STATE_OF_CHARGE, 100);
+	CHECK_CMD(regs, SBS_ABSOLUTE_STATE_OF_CHARGE, 100);
+	CHECK_CMD(regs, SBS_RUN_TIME_TO_EMPTY, SBS_UNKNOWN);
+	CHECK_CMD(regs, SBS_BATTERY_STATUS, SBS_STATUS_INITIALIZED | SBS_STATUS_FULLY_CHARGED);
+	CHECK_CMD(regs, SBS_TEMPERATURE, 2632);				// 263.15K
+	
+	// empty
+	snap.raw[SBS_SRC_REPSOC] = 0;
+	snap.raw[SBS_SRC_TTE] = 0;
+	sbs_update(&snap, regs);
+	CHECK_CMD(regs, SBS_BATTERY_STATUS,
+		SBS_STATUS_INITIALIZED | SBS_STATUS_FULLY_DISCHARGED | SBS_STATUS_DISCHARGING);
+	
+	// other sense resistor, unknown sense resistor
+	snap = snapshot(0, 5);
+	sbs_update(&snap, regs);
+	CHECK_CMD(regs, SBS_REMAINING_CAPACITY, 1200);
+	CHECK_CMD(regs, SBS_CURRENT, -1000);
+	snap.rsense = 0;
+	sbs_update(&snap, regs);
+	CHECK_CMD(regs, SBS_REMAINING_CAPACITY, SBS_UNKNOWN);
+	CHECK_CMD(regs, SBS_CURRENT, 0);
+	CHECK_CMD(regs, SBS_ABSOLUTE_STATE_OF_CHARGE, 50);
+}
+
+
+/***********************************************************
+ *
+ * max_sbsUpdate() on a pack part way through discharge,
+ * host reads through ISR(TWI_vect) match the live gauge
+ * registers, not the data struct copies
+ *
+ ***********************************************************/
+static void testTarget(bool pec) {
+	
+	PackConfig config;
+	config.debug = false;
+	Pack pack(0, config);
+	Max17263Model& gauge = pack.gauge();
+	pack.boot();
+	
+	// run until CycleCount and FullChargeCapacity have
+	// moved past the last save, with the cell discharging
+	uint8_t rsense = config.gauge.rsense;
+	auto stale = [&]() {
+		return ((gauge.reg(Cycles_REG_ADDR) / 100) != (max17263.Cycles / 100)) &&
+			(sbs_capacity_mAh(gauge.reg(FullCapRep_REG_ADDR), rsense) != sbs_capacity_mAh(max17263.FullCapRep, rsense));
+	};
+	for (int i = 0; (i < 100000) && !(stale() && ((int16_t)gauge.reg(Current_REG_ADDR) < 0)); i++) {
+		pack.wake();
+	}
+	CHECK(stale(), "no unsaved Cycles/FullCapRep to check against");
+	
+	tb_start();
+	if (pec) {
+		i2c_target_setPEC(true);
+	}
+	max_sbsUpdate();
+	i2c_target_init(I2C_TARGET_ADDR, max_target_regs, MAX_TARGET_REGS);
+	
+	const struct {
+		uint8_t cmd;
+		uint16_t expect;
+		const char* name;
+	} cmds[] = {
+		{ SBS_REMAINING_CAPACITY, sbs_capacity_mAh(gauge.reg(RepCap_REG_ADDR), rsense), "RemainingCapacity" },
+		{ SBS_FULL_CHARGE_CAPACITY, sbs_capacity_mAh(gauge.reg(FullCapRep_REG_ADDR), rsense), "FullChargeCapacity" },
+		{ SBS_RELATIVE_STATE_OF_CHARGE, sbs_percent(gauge.reg(RepSOC_REG_ADDR)), "RelativeStateOfCharge" },
+		{ SBS_RUN_TIME_TO_EMPTY, sbs_minutes(gauge.reg(TTE_REG_ADDR)), "RunTimeToEmpty" },
+		{ SBS_CYCLE_COUNT, (uint16_t)(gauge.reg(Cycles_REG_ADDR) / 100), "CycleCount" },
+		{ SBS_TEMPERATURE, sbs_temperature(gauge.reg(Temp_REG_ADDR)), "Temperature" },
+		{ SBS_CURRENT, sbs_current_mA(gauge.reg(Current_REG_ADDR), rsense), "Current" },
+		{ SBS_AVERAGE_CURRENT, sbs_current_mA(gauge.reg(AvgCurrent_REG_ADDR), rsense), "AverageCurrent" },
+		{ SBS_DESIGN_CAPACITY, (uint16_t)config.gauge.capacity_mAh, "DesignCapacity" },
+		{ SBS_SPECIFICATION_INFO, (uint16_t)(pec ? SBS_SPEC_INFO_1_1_PEC : SBS_SPEC_INFO_1_1), "SpecificationInfo" },
+	};
+	
+	TwiHost host(I2C_TARGET_ADDR);
+	for (const auto& c : cmds) {
+		uint16_t value = 0;
+		uint8_t err = host.readWord(c.cmd, &value, pec);
+		CHECK(err == TWI_HOST_OK, "%s pec %d: host read returned %u", c.name, pec, err);
+		CHECK(value == c.expect, "%s pec %d = 0x%04X, expected 0x%04X", c.name, pec, value, c.expect);
+	}
+	CHECK((int16_t)gauge.reg(Current_REG_ADDR) < 0, "pack not discharging, Current sign unchecked");
+	
+	// Voltage against the model's cell voltage, not a register
+	// read through the same address map the firmware uses
+	uint16_t mV = 0;
+	long expect = std::lround(gauge.cellVoltage() * 1000.0);
+	uint8_t err = host.readWord(SBS_VOLTAGE, &mV, pec);
+	CHECK(err == TWI_HOST_OK, "Voltage pec %d: host read returned %u", pec, err);
+	CHECK(std::labs((long)mV - expect) <= 1, "Voltage pec %d = %u mV, cell at %ld mV", pec, mV, expect);
+}
+
+
+int main() {
+	testConversions();
+	testTarget(false);
+	testTarget(true);
+	std::printf("%s\n", failures ? "FAIL" : "PASS");
+	return failures ? 1 : 0;
+}
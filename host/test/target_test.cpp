@@ -0,0 +1,163 @@
+/*
+ * target_test.cpp
+ *
+ * Created: 10/19/2026 8:14:34 AM
+ *
+ * I2C target mode run through ISR(TWI_vect) in the
+ * simulator: host word reads of the register file with
+ * and without PEC, a command write ended by STOP before
+ * a separate read, and a host that addresses the module
+ * and never finishes while the driver needs the gauge.
+ * Exit status 1 when any check fails.
+ */ 
+
+#include "pack.h"
+#include "twi_host.h"
+
+extern "C" {
+#include "max17263.h"
+#include "i2c_stats.h"
+#include "timebase.h"
+}
+
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+	if (!(cond)) { \
+		failures++; \
+		std::printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+		std::printf(__VA_ARGS__); \
+		std::printf("\n"); \
+	} \
+} while (0)
+
+
+/***********************************************************
+ *
+ * Host reads return the cached data struct, gauge bus
+ * untouched
+ *
+ ***********************************************************/
+static void testRead(TwiHost& host, bool pec) {
+	
+	const struct {
+		uint8_t reg;
+		uint16_t expect;
+	} regs[] = {
+		{ RepCap_REG_ADDR,		max17263.RepCap },
+		{ RepSOC_REG_ADDR,		max17263.RepSOC },
+		{ TTE_REG_ADDR,			max17263.TTE },
+		{ FullCapRep_REG_ADDR,	max17263.FullCapRep },
+		{ DesignCap_REG_ADDR,	max17263.DesignCap.value },
+	};
+	
+	i2c_target_setPEC(pec);
+	uint64_t gauge_bytes = SimContext::current().bus.stats.bytes;
+	
+	for (const auto& r : regs) {
+		uint16_t value = 0;
+		uint8_t err = host.readWord(r.reg, &value, pec);
+		CHECK(err == TWI_HOST_OK, "read 0x%02X pec %d returned %u", r.reg, pec, err);
+		CHECK(value == r.expect, "read 0x%02X pec %d = 0x%04X, expected 0x%04X", r.reg, pec, value, r.expect);
+	}
+	
+	uint16_t value = 0;
+	CHECK(host.readWord(MAX_TARGET_REGS, &value, pec) == TWI_HOST_OK, "read past register file failed");
+	CHECK(value == 0xFFFF, "read past register file = 0x%04X", value);
+	CHECK(SimContext::current().bus.stats.bytes == gauge_bytes, "host read reached the gauge bus");
+	
+	i2c_target_setPEC(false);
+}
+
+
+/***********************************************************
+ *
+ * Command written in its own transaction (Send Byte with
+ * PEC), STOP, then a separate read. The read's PEC covers
+ * only its own bytes, the earlier command write must not
+ * carry over.
+ *
+ ***********************************************************/
+static void testWriteStopRead(TwiHost& host) {
+	
+	i2c_target_setPEC(true);
+	uint8_t cmd = RepSOC_REG_ADDR;
+	uint16_t value = 0;
+	
+	CHECK(host.write(&cmd, 1, true) == TWI_HOST_OK, "command write not acknowledged");
+	uint8_t err = host.read(&value, true);
+	CHECK(err == TWI_HOST_OK, "read after write + STOP returned %u", err);
+	CHECK(value == max17263.RepSOC, "read after write + STOP = 0x%04X, expected 0x%04X", value, max17263.RepSOC);
+	
+	// combined Read Word still carries the command in its PEC
+	err = host.readWord(RepCap_REG_ADDR, &value, true);
+	CHECK(err == TWI_HOST_OK, "read word after write + STOP returned %u", err);
+	
+	i2c_target_setPEC(false);
+}
+
+
+/***********************************************************
+ *
+ * Host addresses the module then goes silent. The next
+ * gauge access times out instead of hanging, target
+ * state is dropped and both sides work afterwards.
+ *
+ ***********************************************************/
+static void testStuckHost(TwiHost& host, bool read) {
+	
+	I2c_retry_t once = { 1, 0, 0, 0 };
+	I2c_retry_t retry = { I2C_RETRY_ATTEMPTS, I2C_RETRY_BACKOFF_MS,
+						  I2C_RETRY_BACKOFF_MAX_MS, I2C_RETRY_MASK };
+	uint16_t data;
+	
+	// single attempt surfaces the timeout
+	i2c_setRetryPolicy(&once);
+	CHECK(host.addressOnly(read) == TWI_HOST_OK, "stuck host (read %d) not acknowledged", read);
+	uint8_t err = max_tryReadRegister(RepCap_REG_ADDR, &data);
+	CHECK(err == I2C_ERR_TIMEOUT, "stuck host (read %d): gauge read returned 0x%02X", read, err);
+	
+	// target re-armed, host and controller recover
+	uint16_t value = 0;
+	CHECK(host.readWord(RepCap_REG_ADDR, &value) == TWI_HOST_OK, "host read after timeout failed");
+	CHECK(max_tryReadRegister(RepCap_REG_ADDR, &data) == 0, "gauge read after timeout failed");
+	
+	// default policy retries through it
+	i2c_setRetryPolicy(&retry);
+	uint16_t retries = i2c_stats.retries;
+	CHECK(host.addressOnly(read) == TWI_HOST_OK, "stuck host (read %d) not acknowledged", read);
+	CHECK(max_tryReadRegister(RepCap_REG_ADDR, &data) == 0, "stuck host (read %d): retry did not recover", read);
+	CHECK(i2c_stats.retries == retries + 1, "stuck host (read %d): %u retries", read, i2c_stats.retries - retries);
+}
+
+
+int main() {
+	
+	PackConfig config;
+	config.debug = false;
+	Pack pack(0, config);
+	pack.boot();
+	tb_start();
+	
+	// main() with I2C_TARGET
+	max_readFuelGauge();
+	max_targetUpdate();
+	i2c_target_init(I2C_TARGET_ADDR, max_target_regs, MAX_TARGET_REGS);
+	
+	TwiHost host(I2C_TARGET_ADDR);
+	testRead(host, false);
+	testRead(host, true);
+	testWriteStopRead(host);
+	testStuckHost(host, true);
+	testStuckHost(host, false);
+	
+	// target off, address no longer answered
+	i2c_target_disable();
+	uint16_t value;
+	CHECK(host.readWord(RepCap_REG_ADDR, &value) == TWI_HOST_NACK, "disabled target answered");
+	
+	std::printf("%s\n", failures ? "FAIL" : "PASS");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * max17263_fleet.cpp
+ *
+ * Created: 10/19/2026 7:40:57 AM
+ *
+ * Run the firmware against a fleet of simulated gauges,
+ * one pack per task on a work stealing pool
+ *   max17263-fleet -n 64 -d 90 -j 8 -N 0.01 -o fleet.csv
+ *   max17263-fleet -H storage -q		gauge drain, fixed profile
+ */ 
+
+#include "pack.h"
+#include "thread_pool.h"
+
+extern "C" {
+#include "max17263.h"
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+static void usage(const char* prog) {
+	std::fprintf(stderr,
+		"usage: %s [-n PACKS] [-d DAYS] [-j THREADS] [-w WAKE_S] [-b FSCL] [-r ATTEMPTS]\n"
+		"          [-N BUSY] [-H PROFILE] [-M] [-q] [-s SEED] [-S] [-o CSV]\n"
+		"  -n  packs, default 16\n"
+		"  -d  simulated days per pack, default 30\n"
+		"  -j  worker threads, default hardware concurrency\n"
+		"  -w  seconds between gauge wakes, default 56\n"
+		"  -b  SCL in Hz, default 100000\n"
+		"  -r  I2C attempts per transfer, default 4\n"
+		"  -N  chance a gauge write leaves it busy (NACK), default 0\n"
+		"  -H  hibernate profile storage, idle or active, default auto\n"
+		"      (max_hibSchedule() picks from AvgCurrent)\n"
+		"  -M  load the custom model (sim_cell_model) instead of EZ config\n"
+		"  -q  no debug frames in the wake loop\n"
+		"  -s  base seed, pack n uses SEED + n\n"
+		"  -S  also run 1, 2, 4 .. THREADS workers and report speedup\n"
+		"  -o  per pack results as CSV\n", prog);
+}
+
+
+static std::vector<PackResult> runFleet(const PackConfig& base, uint32_t packs, unsigned threads,
+	double& seconds, uint64_t& steals) {
+	
+	std::vector<PackResult> results(packs);
+	auto t0 = std::chrono::steady_clock::now();
+	{
+		ThreadPool pool(threads);
+		for (uint32_t i = 0; i < packs; i++) {
+			pool.submit([&base, &results, i] {
+				PackConfig config = base;
+				config.seed = base.seed + i;
+				Pack pack(i, config);
+				results[i] = pack.run();
+			});
+		}
+		pool.wait();
+		steals = pool.steals();
+	}
+	seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+	return results;
+}
+
+
+static bool writeCsv(const std::string& path, const std::vector<PackResult>& results) {
+	FILE* f = std::fopen(path.c_str(), "w");
+	if (f == nullptr) {
+		return false;
+	}
+	std::fprintf(f, "pack,true_mAh,gauge_mAh,learned_mAh,cycles,wakes,gauge_pors,i2c_transactions,"
+		"i2c_retries,i2c_failures,debug_frames,ee_bytes,ee_max_wear,active_s,sleep_s,energy_J,"
+		"gauge_uAh,gauge_hib_s\n");
+	for (const PackResult& r : results) {
+		std::fprintf(f, "%u,%.1f,%.1f,%.1f,%.2f,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%u,%.3f,%.0f,%.3f,%.1f,%.0f\n",
+			r.id, r.true_mAh, r.gauge_mAh, r.learned_mAh, r.cycles,
+			(unsigned long long)r.wakes, (unsigned long long)r.gauge_pors,
+			(unsigned long long)r.i2c_transactions, (unsigned long long)r.i2c_retries,
+			(unsigned long long)r.i2c_failures, (unsigned long long)r.debug_frames,
+			(unsigned long long)r.ee.bytes_programmed, r.ee_max_wear,
+			r.energy.active_us * 1e-6, r.energy.sleep_us * 1e-6, r.energy.energy_uJ * 1e-6,
+			r.gauge_uAh, r.gauge_hib_s);
+	}
+	return std::fclose(f) == 0;
+}
+
+
+static void summary(const std::vector<PackResult>& results, double days) {
+	double err = 0, err_max = 0, energy = 0, active = 0, gauge_uAh = 0, hib_s = 0, boot_ms = 0;
+	uint64_t model_loads = 0;
+	uint64_t snapshots = 0, snapshot_errors = 0;
+	uint64_t txn = 0, retries = 0, failures = 0, ee = 0;
+	uint32_t wear = 0;
+	for (const PackResult& r : results) {
+		double e = 100.0 * (r.gauge_mAh - r.true_mAh) / r.true_mAh;
+		err += std::abs(e);
+		err_max = std::max(err_max, std::abs(e));
+		energy += r.energy.energy_uJ * 1e-6;
+		active += r.energy.active_us * 1e-6;
+		txn += r.i2c_transactions;
+		retries += r.i2c_retries;
+		failures += r.i2c_failures;
+		ee += r.ee.bytes_programmed;
+		wear = std::max(wear, r.ee_max_wear);
+		gauge_uAh += r.gauge_uAh;
+		hib_s += r.gauge_hib_s;
+		boot_ms += r.boot_us * 1e-3;
+		model_loads += r.model_loads;
+		snapshots += r.snapshots;
+		snapshot_errors += r.snapshot_errors;
+	}
+	double n = (double)results.size();
+	std::printf("capacity error   %.2f%% mean, %.2f%% max\n", err / n, err_max);
+	std::printf("MCU energy       %.3f J per pack, %.1f uW average, %.1f s active\n",
+		energy / n, energy / n / (days * 86400.0) * 1e6, active / n);
+	std::printf("boot             %.1f ms mean, %llu custom model loads\n",
+		boot_ms / n, (unsigned long long)model_loads);
+	std::printf("gauge supply     %.1f uAh per pack, %.2f uA average, %.1f%% hibernating\n",
+		gauge_uAh / n, gauge_uAh / n / (days * 24.0), 100.0 * hib_s / n / (days * 86400.0));
+	std::printf("i2c              %llu transactions, %llu retries, %llu failures\n",
+		(unsigned long long)txn, (unsigned long long)retries, (unsigned long long)failures);
+	std::printf("eeprom           %llu bytes programmed, worst cell %u writes\n",
+		(unsigned long long)ee, wear);
+	std::printf("snapshots        %llu checked, %llu with VCell off the cell voltage\n",
+		(unsigned long long)snapshots, (unsigned long long)snapshot_errors);
+}
+
+
+int main(int argc, char** argv) {
+	
+	PackConfig base;
+	uint32_t packs = 16;
+	unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	bool scaling = false;
+	std::string csv;
+	
+	int opt;
+	while ((opt = getopt(argc, argv, "n:d:j:w:b:r:N:H:Mqs:So:h")) != -1) {
+		switch (opt) {
+			case 'n': packs = (uint32_t)std::strtoul(optarg, nullptr, 10); break;
+			case 'd': base.days = std::strtod(optarg, nullptr); break;
+			case 'j': threads = (unsigned)std::strtoul(optarg, nullptr, 10); break;
+			case 'w': base.wake_s = (uint32_t)std::strtoul(optarg, nullptr, 10); break;
+			case 'b': base.fscl = (uint32_t)std::strtoul(optarg, nullptr, 10); break;
+			case 'r': base.retry.attempts = (uint8_t)std::strtoul(optarg, nullptr, 10); break;
+			case 'N': base.gauge.busy_nack = std::strtod(optarg, nullptr); break;
+			case 'H': {
+				std::string p = optarg;
+				base.hib_profile = (p == "storage") ? MAX_HIB_STORAGE :
+								   (p == "idle") ? MAX_HIB_IDLE :
+								   (p == "active") ? MAX_HIB_ACTIVE :
+								   (p == "auto") ? -1 : -2;
+				break;
+			}
+			case 'M': base.custom_model = true; break;
+			case 'q': base.debug = false; break;
+			case 's': base.seed = (uint32_t)std::strtoul(optarg, nullptr, 10); break;
+			case 'S': scaling = true; break;
+			case 'o': csv = optarg; break;
+			default: usage(argv[0]); return (opt == 'h') ? 0 : 2;
+		}
+	}
+	if ((optind != argc) || (packs == 0) || (threads == 0) || (base.wake_s == 0) ||
+		(base.days <= 0) || (base.fscl == 0) || (base.hib_profile < -1)) {
+		usage(argv[0]);
+		return 2;
+	}
+	
+	double seconds;
+	uint64_t steals;
+	std::vector<PackResult> results = runFleet(base, packs, threads, seconds, steals);
+	
+	double pack_days = packs * base.days;
+	std::printf("%u packs x %.1f days on %u threads: %.2f s wall, %.0f pack-days/s, %llu steals\n\n",
+		packs, base.days, threads, seconds, pack_days / seconds, (unsigned long long)steals);
+	summary(results, base.days);
+	
+	if (scaling) {
+		std::printf("\n%8s %10s %8s %10s\n", "threads", "wall s", "speedup", "efficiency");
+		double single = 0;
+		for (unsigned t = 1; t <= threads; t *= 2) {
+			double s;
+			uint64_t st;
+			runFleet(base, packs, t, s, st);
+			single = (t == 1) ? s : single;
+			std::printf("%8u %10.2f %8.2f %9.0f%%\n", t, s, single / s, 100.0 * single / s / t);
+		}
+	}
+	
+	if (!csv.empty() && !writeCsv(csv, results)) {
+		std::fprintf(stderr, "cannot write %s\n", csv.c_str());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * max17263_log.cpp
+ *
+ * Created: 10/19/2026 7:29:21 AM
+ *
+ * Decode i2c_debug binary output (BINARY_OUTPUT true) from
+ * the serial port or a recorded file and log it as CSV
+ * and/or column files, one file per message type.
+ */ 
+
+#include "column_log.h"
+#include "csv_writer.h"
+#include "frame.h"
+#include "serial_port.h"
+#include "telemetry.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+static volatile std::sig_atomic_t running = 1;
+
+static void onSignal(int) {
+	running = 0;
+}
+
+
+static void usage(const char* prog) {
+	std::fprintf(stderr,
+		"usage: %s (-d DEVICE [-b BAUD] | -f FILE) [-o DIR] [-l DIR] [-c CAPTURE] [-v]\n"
+		"  -d DEVICE   receiver serial port, e.g. /dev/ttyACM0\n"
+		"  -b BAUD     serial rate, default 115200 (DEBUG_BAUD)\n"
+		"  -f FILE     decode recorded capture or raw dump, - for stdin\n"
+		"  -o DIR      write <DIR>/<message>.csv\n"
+		"  -l DIR      append <DIR>/<message>.mcol column files\n"
+		"  -c CAPTURE  save received frames for later replay with -f\n"
+		"  -v          print decoded records\n", prog);
+}
+
+
+int main(int argc, char** argv) {
+	
+	std::string device;
+	std::string input;
+	std::string outdir;
+	std::string logdir;
+	std::string capture_path;
+	uint32_t baud = 115200;
+	bool verbose = false;
+	
+	int opt;
+	while ((opt = getopt(argc, argv, "d:b:f:o:l:c:vh")) != -1) {
+		switch (opt) {
+			case 'd': device = optarg; break;
+			case 'b': baud = (uint32_t)std::strtoul(optarg, nullptr, 10); break;
+			case 'f': input = optarg; break;
+			case 'o': outdir = optarg; break;
+			case 'l': logdir = optarg; break;
+			case 'c': capture_path = optarg; break;
+			case 'v': verbose = true; break;
+			default: usage(argv[0]); return (opt == 'h') ? 0 : 2;
+		}
+	}
+	if (device.empty() == input.empty()) {
+		usage(argv[0]);
+		return 2;
+	}
+	
+	// byte source
+	SerialPort port;
+	std::istream* in = nullptr;
+	std::ifstream file;
+	if (!device.empty()) {
+		std::string error;
+		if (!port.open(device, baud, error)) {
+			std::fprintf(stderr, "%s\n", error.c_str());
+			return 1;
+		}
+	}
+	else if (input == "-") {
+		in = &std::cin;
+	}
+	else {
+		file.open(input, std::ios::binary);
+		if (!file) {
+			std::fprintf(stderr, "%s: cannot open\n", input.c_str());
+			return 1;
+		}
+		in = &file;
+	}
+	
+	std::unique_ptr<CsvWriter> csv;
+	if (!outdir.empty()) {
+		csv = std::make_unique<CsvWriter>(outdir);
+	}
+	std::unique_ptr<ColumnLog> columns;
+	if (!logdir.empty()) {
+		columns = std::make_unique<ColumnLog>(logdir);
+	}
+	std::ofstream capture;
+	if (!capture_path.empty()) {
+		capture.open(capture_path, std::ios::binary | std::ios::trunc);
+		if (!capture) {
+			std::fprintf(stderr, "%s: cannot create\n", capture_path.c_str());
+			return 1;
+		}
+	}
+	
+	std::signal(SIGINT, onSignal);
+	std::signal(SIGTERM, onSignal);
+	
+	FrameParser parser;
+	DeviceClock clock;
+	std::vector<Frame> frames;
+	std::map<std::string, uint64_t> counts;
+	uint64_t unknown = 0;
+	bool first_chunk = true;
+	uint8_t buf[4096];
+	
+	while (running) {
+		
+		long n;
+		size_t skip = 0;
+		if (in != nullptr) {
+			in->read((char*)buf, sizeof(buf));
+			n = (long)in->gcount();
+			if (n <= 0) {
+				break;
+			}
+		}
+		else {
+			n = port.read(buf, sizeof(buf), 200);
+			if (n < 0) {
+				std::perror("read");
+				break;
+			}
+		}
+		
+		// recorded capture pins timestamps to original wall clock,
+		// raw dumps stay relative to first frame
+		if (first_chunk && (in != nullptr)) {
+			int64_t epoch;
+			if (decodeCaptureHeader(buf, (size_t)n, epoch)) {
+				clock.setEpoch(epoch);
+				skip = CAPTURE_HEADER_LEN;
+			}
+		}
+		first_chunk = first_chunk && (n == 0);
+		
+		frames.clear();
+		parser.push(buf + skip, (size_t)n - skip, frames);
+		
+		for (const Frame& frame : frames) {
+			
+			if (!clock.started() && (in == nullptr)) {
+				clock.setEpoch(wallClockMs());
+			}
+			int64_t ts = clock.toHost(frame.device_ms);
+			
+			if (capture.is_open()) {
+				if (capture.tellp() == 0) {
+					std::vector<uint8_t> header = encodeCaptureHeader(ts);
+					capture.write((const char*)header.data(), header.size());
+				}
+				std::vector<uint8_t> raw = encodeFrame(frame);
+				capture.write((const char*)raw.data(), raw.size());
+			}
+			
+			Record record;
+			if (!decodeFrame(frame, ts, record)) {
+				unknown++;
+				continue;
+			}
+			counts[record.schema->name]++;
+			if (csv && !csv->write(record)) {
+				std::fprintf(stderr, "%s: cannot write %s.csv\n", outdir.c_str(), record.schema->name);
+				return 1;
+			}
+			std::string error;
+			if (columns && !columns->write(record, error)) {
+				std::fprintf(stderr, "%s\n", error.c_str());
+				return 1;
+			}
+			if (verbose) {
+				std::printf("%s\n", formatRecord(record).c_str());
+			}
+		}
+		if (verbose && !frames.empty()) {
+			std::fflush(stdout);
+		}
+	}
+	
+	if (csv) {
+		csv->flush();
+	}
+	if (columns) {
+		columns->flush();
+	}
+	
+	std::fprintf(stderr, "frames %llu, pec errors %llu, skipped bytes %llu, unknown %llu\n",
+		(unsigned long long)parser.frames(), (unsigned long long)parser.pecErrors(),
+		(unsigned long long)parser.skipped(), (unsigned long long)unknown);
+	for (const auto& c : counts) {
+		std::fprintf(stderr, "  %-16s %llu\n", c.first.c_str(), (unsigned long long)c.second);
+	}
+	return 0;
+}
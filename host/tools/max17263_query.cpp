@@ -0,0 +1,149 @@
+/*
+ * max17263_query.cpp
+ *
+ * Created: 10/19/2026 7:31:00 AM
+ *
+ * Range query over a column file written by max17263-log -l
+ * e.g. samples with RepSOC below 10% (1/256 % per LSB):
+ *   max17263-query fuel_gauge.mcol -w rep_soc::2559
+ * or discharge above 1A on a 10 mOhm sense resistor
+ * (1.5625 uV per LSB, signed):
+ *   max17263-query snapshot.mcol -w current::-6400
+ */ 
+
+#include "column_store.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+
+static void usage(const char* prog) {
+	std::fprintf(stderr,
+		"usage: %s FILE [-w COLUMN:LO:HI]... [-c COLUMN,...] [-s]\n"
+		"  -w  keep rows with LO <= COLUMN <= HI (raw units, signed where the\n"
+		"      register is), empty bound is open\n"
+		"  -c  output columns, default all\n"
+		"  -s  print index statistics only\n", prog);
+}
+
+
+/***********************************************************
+ *
+ * Parse COLUMN:LO:HI against file columns
+ *
+ ***********************************************************/
+static bool parsePredicate(const ColumnFile& file, const std::string& arg, Predicate& p) {
+	size_t a = arg.find(':');
+	size_t b = (a == std::string::npos) ? a : arg.find(':', a + 1);
+	if (b == std::string::npos) {
+		return false;
+	}
+	int column = file.findColumn(arg.substr(0, a));
+	if (column < 0) {
+		return false;
+	}
+	const ColumnSpec& spec = file.columns()[column];
+	std::string lo = arg.substr(a + 1, b - a - 1);
+	std::string hi = arg.substr(b + 1);
+	p.column = (size_t)column;
+	if (spec.is_signed) {
+		p.lo = lo.empty() ? 0 : columnEncode(spec, std::strtoll(lo.c_str(), nullptr, 0));
+		p.hi = hi.empty() ? UINT64_MAX : columnEncode(spec, std::strtoll(hi.c_str(), nullptr, 0));
+	}
+	else {
+		p.lo = lo.empty() ? 0 : std::strtoull(lo.c_str(), nullptr, 0);
+		p.hi = hi.empty() ? UINT64_MAX : std::strtoull(hi.c_str(), nullptr, 0);
+	}
+	return true;
+}
+
+
+int main(int argc, char** argv) {
+	
+	std::vector<std::string> where_args;
+	std::string select_arg;
+	bool stats_only = false;
+	
+	int opt;
+	while ((opt = getopt(argc, argv, "w:c:sh")) != -1) {
+		switch (opt) {
+			case 'w': where_args.push_back(optarg); break;
+			case 'c': select_arg = optarg; break;
+			case 's': stats_only = true; break;
+			default: usage(argv[0]); return (opt == 'h') ? 0 : 2;
+		}
+	}
+	if (optind != argc - 1) {
+		usage(argv[0]);
+		return 2;
+	}
+	
+	ColumnFile file;
+	std::string error;
+	if (!file.open(argv[optind], error)) {
+		std::fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+	
+	std::vector<Predicate> where;
+	for (const std::string& arg : where_args) {
+		Predicate p;
+		if (!parsePredicate(file, arg, p)) {
+			std::fprintf(stderr, "bad predicate '%s'\n", arg.c_str());
+			return 2;
+		}
+		where.push_back(p);
+	}
+	
+	std::vector<size_t> select;
+	if (select_arg.empty()) {
+		for (size_t c = 0; c < file.columns().size(); c++) {
+			select.push_back(c);
+		}
+	}
+	else {
+		std::stringstream ss(select_arg);
+		std::string name;
+		while (std::getline(ss, name, ',')) {
+			int c = file.findColumn(name);
+			if (c < 0) {
+				std::fprintf(stderr, "no column '%s' in %s\n", name.c_str(), file.schema().c_str());
+				return 2;
+			}
+			select.push_back((size_t)c);
+		}
+	}
+	
+	if (!stats_only) {
+		for (size_t i = 0; i < select.size(); i++) {
+			std::printf("%s%s", (i == 0) ? "" : ",", file.columns()[select[i]].name.c_str());
+		}
+		std::printf("\n");
+	}
+	
+	QueryStats stats = file.query(where, [&](size_t chunk, uint32_t row) {
+		if (stats_only) {
+			return;
+		}
+		for (size_t i = 0; i < select.size(); i++) {
+			const ColumnSpec& spec = file.columns()[select[i]];
+			uint64_t v = file.value(chunk, select[i], row);
+			if (spec.is_signed) {
+				std::printf("%s%lld", (i == 0) ? "" : ",", (long long)columnDecode(spec, v));
+			}
+			else {
+				std::printf("%s%llu", (i == 0) ? "" : ",", (unsigned long long)v);
+			}
+		}
+		std::printf("\n");
+	});
+	
+	std::fprintf(stderr, "%s: %llu rows, %zu/%zu chunks scanned, %llu rows scanned, %llu matched\n",
+		file.schema().c_str(), (unsigned long long)file.rows(), stats.chunks_scanned, stats.chunks,
+		(unsigned long long)stats.rows_scanned, (unsigned long long)stats.rows_matched);
+	return 0;
+}
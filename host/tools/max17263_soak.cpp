@@ -0,0 +1,390 @@
+/*
+ * max17263_soak.cpp
+ *
+ * Created: 10/19/2026 7:44:19 AM
+ *
+ * Accelerated soak of learned parameter persistence.
+ * Drives simulated packs through thousands of charge
+ * cycles with random MCU resets and gauge PORs, checking
+ * after every fault that the driver restores what it
+ * saved, and at the end that the learned capacity
+ * survived and EEPROM wear stayed bounded.
+ *   max17263-soak -c 2000 -n 8 -R 0.0005 -P 0.0005
+ * Exit status 1 when any pack fails a check.
+ */ 
+
+#include "pack.h"
+#include "thread_pool.h"
+
+extern "C" {
+#include "eeprom_queue.h"
+#include "max17263.h"
+#include "timebase.h"
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define SOAK_CYCLES_SAVE_PERIOD	64			// Cycles.B6 toggle, 1% LSB
+#define SOAK_EE_ENDURANCE		100000		// ATmega32U4 EEPROM write/erase cycles
+#define SOAK_MAX_FAILURES		4			// reported per pack
+#define SOAK_RESTORE_TOL		0.05		// FullCapNom drift between saves
+#define SOAK_TEAR_CHANCE		0.25		// -T, chance a save is torn
+
+
+struct SoakConfig {
+	PackConfig pack;
+	double cycles = 2000;				// cell cycles per pack
+	double mcu_reset = 0.0005;			// chance per wake
+	double gauge_por = 0.0005;			// chance per wake
+	bool torn = false;					// allow resets part way through the EEPROM flush
+	double cap_tol = 0.02;				// learned capacity vs true, fraction
+};
+
+struct SoakResult {
+	PackResult pack;
+	uint64_t mcu_resets = 0;
+	uint64_t gauge_pors = 0;
+	uint64_t torn = 0;
+	uint64_t checks = 0;
+	double cycles_lost = 0;				// gauge Cycles rolled back by restores
+	double cycles_lost_max = 0;
+	uint32_t wear_bound = 0;
+	std::vector<std::string> failures;
+};
+
+
+static void fail(SoakResult& r, const char* fmt, double a, double b, double days) {
+	if (r.failures.size() < SOAK_MAX_FAILURES) {
+		char text[160];
+		std::snprintf(text, sizeof(text), fmt, a, b);
+		char line[200];
+		std::snprintf(line, sizeof(line), "day %.1f: %s", days, text);
+		r.failures.push_back(line);
+	}
+	else if (r.failures.size() == SOAK_MAX_FAILURES) {
+		r.failures.push_back("...");
+	}
+}
+
+
+// gauge registers just before a fault
+struct Learned {
+	uint16_t cycles;
+	uint16_t full_cap_nom;
+};
+
+
+static Learned learned(Max17263Model& gauge) {
+	return { gauge.reg(Cycles_REG_ADDR), gauge.reg(FullCapNom_REG_ADDR) };
+}
+
+
+static uint16_t eeWord(SimContext& ctx, uint16_t addr) {
+	return (uint16_t)(ctx.eeRead(addr) | (ctx.eeRead(addr + 1) << 8));
+}
+
+
+/***********************************************************
+ *
+ * Gauge holds what EEPROM holds once the driver has run
+ * max_loadConfig(), the learned capacity came back and the
+ * restore only lost Cycles accumulated since the last
+ * Cycles.B6 save
+ *
+ ***********************************************************/
+static void checkRestore(Pack& pack, SoakResult& r, const Learned& before, bool torn) {
+	
+	SimContext& ctx = pack.context();
+	Max17263Model& gauge = pack.gauge();
+	double days = ctx.now() / 86400e6;
+	r.checks++;
+	
+	const struct {
+		uint8_t reg;
+		uint16_t ee;
+		const char* name;
+	} saved[] = {
+		{ RCOMP0_REG_ADDR, EEPROM_RCOMP0_ADDR, "RCOMP0" },
+		{ TempCo_REG_ADDR, EEPROM_TempCo_ADDR, "TempCo" },
+		{ Cycles_REG_ADDR, EEPROM_Cycles_ADDR, "Cycles" },
+		{ FullCapNom_REG_ADDR, EEPROM_FullCapNom_ADDR, "FullCapNom" },
+	};
+	for (const auto& l : saved) {
+		if (gauge.reg(l.reg) != eeWord(ctx, l.ee)) {
+			char fmt[96];
+			std::snprintf(fmt, sizeof(fmt), "%s not restored, gauge %%.0f eeprom %%.0f", l.name);
+			fail(r, fmt, gauge.reg(l.reg), eeWord(ctx, l.ee), days);
+		}
+	}
+	
+	// capacity learned before the fault came back
+	double cap_err = std::fabs((double)gauge.reg(FullCapNom_REG_ADDR) - before.full_cap_nom) / before.full_cap_nom;
+	if (cap_err > SOAK_RESTORE_TOL) {
+		fail(r, "FullCapNom restored %.2f%% off (limit %.2f%%)", 100 * cap_err, 100 * SOAK_RESTORE_TOL, days);
+	}
+	
+	// register counts 1% and rolls over at 655.35 cycles
+	double lost = (int16_t)(uint16_t)(before.cycles - gauge.reg(Cycles_REG_ADDR));
+	r.cycles_lost += std::max(0.0, lost);
+	r.cycles_lost_max = std::max(r.cycles_lost_max, lost);
+	if (!torn && (lost > SOAK_CYCLES_SAVE_PERIOD + 1)) {
+		fail(r, "Cycles rolled back %.0f%% (save period %.0f%%)", lost, SOAK_CYCLES_SAVE_PERIOD, days);
+	}
+}
+
+
+/***********************************************************
+ *
+ * EEPROM as left by firmware from before the layout
+ * version byte (layout 1), check word and learned
+ * parameters only
+ *
+ ***********************************************************/
+static std::vector<uint8_t> seedLayout1(Pack& pack, const SoakConfig& config) {
+	
+	Max17263Model& gauge = pack.gauge();
+	uint16_t cap = MAX_DESIGNCAP((uint16_t)config.pack.gauge.capacity_mAh, config.pack.gauge.rsense);
+	uint16_t words[] = {
+		EEPROM_CHECK_VAL, gauge.reg(RCOMP0_REG_ADDR), gauge.reg(TempCo_REG_ADDR), cap, 0, cap
+	};
+	
+	std::vector<uint8_t>& ee = pack.context().eeprom();
+	for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+		ee[2 * i] = (uint8_t)(words[i] & 0x00FF);
+		ee[2 * i + 1] = (uint8_t)(words[i] >> 8);
+	}
+	return std::vector<uint8_t>(ee.begin(), ee.begin() + 2 * (sizeof(words) / sizeof(words[0])));
+}
+
+
+/***********************************************************
+ *
+ * First boot on a layout 1 image upgraded it in place,
+ * learned parameters kept and loaded, only the version
+ * byte programmed
+ *
+ ***********************************************************/
+static void checkMigration(Pack& pack, SoakResult& r, const std::vector<uint8_t>& image) {
+	
+	SimContext& ctx = pack.context();
+	r.checks++;
+	
+	for (size_t i = 0; i < image.size(); i++) {
+		if (ctx.eeRead((uint16_t)i) != image[i]) {
+			fail(r, "layout 1 byte 0x%02.0f rewritten to 0x%02.0f", (double)i, ctx.eeRead((uint16_t)i), 0);
+		}
+	}
+	if (ctx.eeRead(EEPROM_Version_ADDR) != EEPROM_LAYOUT_VERSION) {
+		fail(r, "layout version %.0f after upgrade, expected %.0f", ctx.eeRead(EEPROM_Version_ADDR),
+			EEPROM_LAYOUT_VERSION, 0);
+	}
+	if (ctx.ee_stats.bytes_programmed != 1) {
+		fail(r, "layout upgrade programmed %.0f bytes, expected %.0f", (double)ctx.ee_stats.bytes_programmed, 1, 0);
+	}
+	if (pack.gauge().reg(FullCapNom_REG_ADDR) != eeWord(ctx, EEPROM_FullCapNom_ADDR)) {
+		fail(r, "FullCapNom not restored after upgrade, gauge %.0f eeprom %.0f",
+			pack.gauge().reg(FullCapNom_REG_ADDR), eeWord(ctx, EEPROM_FullCapNom_ADDR), 0);
+	}
+}
+
+
+static SoakResult soak(uint32_t id, const SoakConfig& config) {
+	
+	SoakResult r;
+	Pack pack(id, config.pack);
+	SimContext& ctx = pack.context();
+	Max17263Model& gauge = pack.gauge();
+	std::mt19937 rng(config.pack.seed ^ 0x5A5A5A5AU);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	
+	// odd packs start on a firmware update from layout 1
+	if (id & 1) {
+		std::vector<uint8_t> image = seedLayout1(pack, config);
+		pack.boot();
+		checkMigration(pack, r, image);
+	}
+	else {
+		pack.boot();
+	}
+	
+	while (gauge.cycles() < config.cycles) {
+		
+		if (unit(rng) < config.gauge_por) {
+			Learned before = learned(gauge);
+			gauge.por();
+			r.gauge_pors++;
+			pack.wake();						// POR handler -> max_loadConfig()
+			checkRestore(pack, r, before, false);
+			continue;
+		}
+		
+		// with -T a save in flight is torn part way through, the
+		// reset unwinds out of the driver from the EEPROM flush
+		Learned before = learned(gauge);
+		bool torn = false;
+		if (config.torn && (unit(rng) < SOAK_TEAR_CHANCE)) {
+			std::uniform_int_distribution<size_t> part(1, 9);
+			ctx.eeTearAfter(part(rng));
+		}
+		try {
+			pack.wake(false);
+		}
+		catch (const SimReset&) {
+			torn = true;
+			r.torn++;
+		}
+		ctx.eeTearDisarm();
+		
+		// other resets land after bat_process(), before the flush.
+		// A save queued this wake is already part written by
+		// EE_READY then, so the reset tears it as well
+		if (torn || (unit(rng) < config.mcu_reset)) {
+			if (!torn && ee_busy()) {
+				torn = true;
+				r.torn++;
+			}
+			pack.mcuReset();
+			r.mcu_resets++;
+			checkRestore(pack, r, before, torn);
+		}
+		else {
+			pack.flushEeprom();
+		}
+	}
+	
+	// snapshot VCell is the cell voltage, not another register
+	Max17263_snapshot_t snap;
+	tb_start();
+	uint8_t err = max_readSnapshot(&snap);
+	tb_stop();
+	
+	r.pack = pack.result();
+	double days = ctx.now() / 86400e6;
+	
+	if (err != 0) {
+		fail(r, "snapshot read failed, error %.0f after %.0f wakes", err, (double)r.pack.wakes, days);
+	}
+	else if (std::fabs(snap.VCell * 78.125e-6 - gauge.cellVoltage()) > 0.005) {
+		fail(r, "snapshot VCell %.3fV, cell at %.3fV", snap.VCell * 78.125e-6, gauge.cellVoltage(), days);
+	}
+	
+	// learned capacity followed the fading cell, in the gauge and in EEPROM
+	double gauge_err = std::fabs(r.pack.gauge_mAh - r.pack.true_mAh) / r.pack.true_mAh;
+	double ee_err = std::fabs(r.pack.learned_mAh - r.pack.true_mAh) / r.pack.true_mAh;
+	if (gauge_err > config.cap_tol) {
+		fail(r, "gauge capacity off %.2f%% (limit %.2f%%)", 100 * gauge_err, 100 * config.cap_tol, days);
+	}
+	if (ee_err > config.cap_tol) {
+		fail(r, "saved capacity off %.2f%% (limit %.2f%%)", 100 * ee_err, 100 * config.cap_tol, days);
+	}
+	
+	// one write per byte per save, saves at most once per Cycles.B6
+	// toggle plus what restores roll back, first boot writes 0xBEEF
+	double counted = gauge.cycles() * 100.0 + r.cycles_lost;
+	r.wear_bound = (uint32_t)std::ceil(counted / SOAK_CYCLES_SAVE_PERIOD) + 2;
+	if (r.pack.ee_max_wear > r.wear_bound) {
+		fail(r, "EEPROM wear %.0f writes over bound %.0f", r.pack.ee_max_wear, r.wear_bound, days);
+	}
+	return r;
+}
+
+
+static void usage(const char* prog) {
+	std::fprintf(stderr,
+		"usage: %s [-c CYCLES] [-n PACKS] [-j THREADS] [-R P] [-P P] [-T] [-t TOL] [-w WAKE_S] [-s SEED]\n"
+		"  -c  cell cycles per pack, default 2000\n"
+		"  -n  packs, default 4\n"
+		"  -j  worker threads, default hardware concurrency\n"
+		"  -R  MCU reset chance per wake, default 0.0005\n"
+		"  -P  gauge POR chance per wake, default 0.0005\n"
+		"  -T  resets may tear the EEPROM flush part way\n"
+		"  -t  capacity tolerance in percent, default 2\n"
+		"  -w  seconds between gauge wakes, default 56\n"
+		"  -s  base seed, pack n uses SEED + n\n", prog);
+}
+
+
+int main(int argc, char** argv) {
+	
+	SoakConfig config;
+	uint32_t packs = 4;
+	unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	
+	// compressed usage, short rests and 1C charge
+	config.pack.debug = false;
+	config.pack.gauge.rest_h_max = 0.5;
+	config.pack.gauge.charge_C = 1.0;
+	config.pack.gauge.discharge_mA_min = 600;
+	config.pack.gauge.discharge_mA_max = 1200;
+	
+	int opt;
+	while ((opt = getopt(argc, argv, "c:n:j:R:P:Tt:w:s:h")) != -1) {
+		switch (opt) {
+			case 'c': config.cycles = std::strtod(optarg, nullptr); break;
+			case 'n': packs = (uint32_t)std::strtoul(optarg, nullptr, 10); break;
+			case 'j': threads = (unsigned)std::strtoul(optarg, nullptr, 10); break;
+			case 'R': config.mcu_reset = std::strtod(optarg, nullptr); break;
+			case 'P': config.gauge_por = std::strtod(optarg, nullptr); break;
+			case 'T': config.torn = true; break;
+			case 't': config.cap_tol = std::strtod(optarg, nullptr) / 100.0; break;
+			case 'w': config.pack.wake_s = (uint32_t)std::strtoul(optarg, nullptr, 10); break;
+			case 's': config.pack.seed = (uint32_t)std::strtoul(optarg, nullptr, 10); break;
+			default: usage(argv[0]); return (opt == 'h') ? 0 : 2;
+		}
+	}
+	if ((optind != argc) || (packs == 0) || (threads == 0) || (config.pack.wake_s == 0) ||
+		(config.cycles <= 0)) {
+		usage(argv[0]);
+		return 2;
+	}
+	
+	std::vector<SoakResult> results(packs);
+	auto t0 = std::chrono::steady_clock::now();
+	{
+		ThreadPool pool(threads);
+		for (uint32_t i = 0; i < packs; i++) {
+			pool.submit([&config, &results, i] {
+				SoakConfig c = config;
+				c.pack.seed = config.pack.seed + i;
+				results[i] = soak(i, c);
+			});
+		}
+		pool.wait();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+	
+	std::printf("%5s %8s %8s %6s %6s %5s %8s %8s %9s %9s %7s %6s  %s\n", "pack", "cycles", "days",
+		"resets", "pors", "torn", "checks", "lost %", "true mAh", "saved mAh", "wear", "bound", "result");
+	
+	bool pass = true;
+	double days_total = 0, wear_rate = 0;
+	for (const SoakResult& r : results) {
+		double days = (r.pack.energy.active_us + r.pack.energy.idle_us + r.pack.energy.sleep_us) / 86400e6;
+		days_total += days;
+		wear_rate = std::max(wear_rate, r.pack.ee_max_wear / r.pack.cycles);
+		std::printf("%5u %8.0f %8.1f %6llu %6llu %5llu %8llu %8.0f %9.1f %9.1f %7u %6u  %s\n",
+			r.pack.id, r.pack.cycles, days, (unsigned long long)r.mcu_resets,
+			(unsigned long long)r.gauge_pors, (unsigned long long)r.torn, (unsigned long long)r.checks,
+			r.cycles_lost, r.pack.true_mAh, r.pack.learned_mAh, r.pack.ee_max_wear, r.wear_bound,
+			r.failures.empty() ? "pass" : "FAIL");
+		for (const std::string& f : r.failures) {
+			std::printf("        %s\n", f.c_str());
+		}
+		pass = pass && r.failures.empty();
+	}
+	
+	std::printf("\n%.1f pack-years in %.2f s, worst EEPROM cell %.2f writes/cycle, "
+		"endurance reached after ~%.0f cycles\n", days_total / 365.0, seconds, wear_rate,
+		(wear_rate > 0) ? SOAK_EE_ENDURANCE / wear_rate : 0.0);
+	std::printf("%s\n", pass ? "PASS" : "FAIL");
+	return pass ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/*
+ * max17263_stats.cpp
+ *
+ * Created: 10/19/2026 7:32:16 AM
+ *
+ * Column statistics over a column file written by
+ * max17263-log -l, in engineering units
+ *   max17263-stats fuel_gauge.mcol -r 10 -H rep_soc:0:2560:10
+ */ 
+
+#include "analytics.h"
+#include "column_store.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+
+static void usage(const char* prog) {
+	std::fprintf(stderr,
+		"usage: %s FILE [-r RSENSE] [-H COLUMN:LO:WIDTH:BINS]... [-b]\n"
+		"  -r  sense resistor in milliohms, default 10\n"
+		"  -H  histogram of raw values, e.g. rep_soc:0:2560:10 for 10%% bins,\n"
+		"      LO is signed for signed registers (current:-12800:1280:20)\n"
+		"  -b  time SIMD against scalar kernels\n", prog);
+}
+
+
+struct HistogramArg {
+	size_t column;
+	uint16_t lo;					// stored form
+	uint16_t width;
+	size_t bins;
+};
+
+
+// stored 16 bit value of raw 0, signed columns are biased
+static double storedZero(const ColumnSpec& spec) {
+	return spec.is_signed ? 32768.0 : 0.0;
+}
+
+
+static bool parseHistogram(const ColumnFile& file, const std::string& arg, HistogramArg& h) {
+	size_t a = arg.find(':');
+	if (a == std::string::npos) {
+		return false;
+	}
+	int column = file.findColumn(arg.substr(0, a));
+	if ((column < 0) || (file.columns()[column].width != 2)) {
+		return false;
+	}
+	const ColumnSpec& spec = file.columns()[column];
+	int lo;
+	unsigned width, bins;
+	if (std::sscanf(arg.c_str() + a + 1, "%d:%u:%u", &lo, &width, &bins) != 3) {
+		return false;
+	}
+	int lo_min = spec.is_signed ? INT16_MIN : 0;
+	int lo_max = spec.is_signed ? INT16_MAX : UINT16_MAX;
+	if ((lo < lo_min) || (lo > lo_max) || (width == 0) || (width > UINT16_MAX) || (bins == 0)) {
+		return false;
+	}
+	h = { (size_t)column, (uint16_t)columnEncode(spec, lo), (uint16_t)width, bins };
+	return true;
+}
+
+
+static ColumnSummary summarizeColumn(const ColumnFile& file, size_t column, bool simd) {
+	ColumnSummary s;
+	for (size_t c = 0; c < file.chunks().size(); c++) {
+		const uint16_t* data = (const uint16_t*)file.columnData(c, column);
+		uint32_t rows = file.chunks()[c].rows;
+		s.merge(simd ? summarize(data, rows) : summarizeScalar(data, rows));
+	}
+	return s;
+}
+
+
+/***********************************************************
+ *
+ * Least squares slope of FullCapNom over Cycles,
+ * capacity fade in mAh per 100 cycles
+ *
+ ***********************************************************/
+static bool capacityFade(const ColumnFile& file, uint8_t rsense, double& fade) {
+	int cap = file.findColumn("full_cap_nom");
+	int cyc = file.findColumn("cycles");
+	if ((cap < 0) || (cyc < 0) || (file.rows() < 2)) {
+		return false;
+	}
+	RegisterUnit cap_unit = registerUnit("full_cap_nom", rsense);
+	RegisterUnit cyc_unit = registerUnit("cycles", rsense);
+	std::vector<float> x, y;
+	double sx = 0, sy = 0, sxx = 0, sxy = 0;
+	uint64_t n = 0;
+	
+	for (size_t c = 0; c < file.chunks().size(); c++) {
+		uint32_t rows = file.chunks()[c].rows;
+		x.resize(rows);
+		y.resize(rows);
+		convert((const uint16_t*)file.columnData(c, (size_t)cyc), rows, (float)cyc_unit.lsb, x.data());
+		convert((const uint16_t*)file.columnData(c, (size_t)cap), rows, (float)cap_unit.lsb, y.data());
+		for (uint32_t r = 0; r < rows; r++) {
+			sx += x[r];
+			sy += y[r];
+			sxx += (double)x[r] * x[r];
+			sxy += (double)x[r] * y[r];
+		}
+		n += rows;
+	}
+	double den = (double)n * sxx - sx * sx;
+	if (den <= 0) {
+		return false;
+	}
+	fade = -100.0 * ((double)n * sxy - sx * sy) / den;
+	return true;
+}
+
+
+int main(int argc, char** argv) {
+	
+	uint8_t rsense = 10;
+	std::vector<std::string> hist_args;
+	bool bench = false;
+	
+	int opt;
+	while ((opt = getopt(argc, argv, "r:H:bh")) != -1) {
+		switch (opt) {
+			case 'r': rsense = (uint8_t)std::strtoul(optarg, nullptr, 10); break;
+			case 'H': hist_args.push_back(optarg); break;
+			case 'b': bench = true; break;
+			default: usage(argv[0]); return (opt == 'h') ? 0 : 2;
+		}
+	}
+	if ((optind != argc - 1) || (rsense == 0)) {
+		usage(argv[0]);
+		return 2;
+	}
+	
+	ColumnFile file;
+	std::string error;
+	if (!file.open(argv[optind], error)) {
+		std::fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+	
+	std::printf("%s: %llu rows, %zu chunks, rsense %u mOhm%s\n\n", file.schema().c_str(),
+		(unsigned long long)file.rows(), file.chunks().size(), rsense, analyticsSimd() ? ", SSE2" : "");
+	std::printf("%-16s %12s %12s %12s  %s\n", "column", "min", "max", "mean", "unit");
+	
+	for (size_t col = 0; col < file.columns().size(); col++) {
+		if (file.columns()[col].width != 2) {
+			continue;
+		}
+		ColumnSummary s = summarizeColumn(file, col, true);
+		if (s.count == 0) {
+			continue;
+		}
+		RegisterUnit u = registerUnit(file.columns()[col].name, rsense);
+		double zero = storedZero(file.columns()[col]);
+		std::printf("%-16s %12.3f %12.3f %12.3f  %s\n", file.columns()[col].name.c_str(),
+			(s.min - zero) * u.lsb, (s.max - zero) * u.lsb, (s.mean() - zero) * u.lsb, u.unit);
+	}
+	
+	double fade;
+	if (capacityFade(file, rsense, fade)) {
+		std::printf("\ncapacity fade    %12.3f mAh / 100 cycles\n", fade);
+	}
+	
+	for (const std::string& arg : hist_args) {
+		HistogramArg h;
+		if (!parseHistogram(file, arg, h)) {
+			std::fprintf(stderr, "bad histogram '%s'\n", arg.c_str());
+			return 2;
+		}
+		std::vector<uint64_t> bins(h.bins, 0);
+		for (size_t c = 0; c < file.chunks().size(); c++) {
+			histogram((const uint16_t*)file.columnData(c, h.column), file.chunks()[c].rows,
+				h.lo, h.width, bins.data(), bins.size());
+		}
+		RegisterUnit u = registerUnit(file.columns()[h.column].name, rsense);
+		double zero = storedZero(file.columns()[h.column]);
+		std::printf("\n%s histogram\n", file.columns()[h.column].name.c_str());
+		for (size_t b = 0; b < bins.size(); b++) {
+			double lo = (h.lo - zero + (double)b * h.width) * u.lsb;
+			std::printf("  %s%10.2f %-6s %12llu\n", (b == bins.size() - 1) ? ">=" : "  ", lo, u.unit,
+				(unsigned long long)bins[b]);
+		}
+	}
+	
+	if (bench) {
+		using clock = std::chrono::steady_clock;
+		const int reps = 20;
+		double t[2];
+		uint64_t bytes = 0;
+		for (int simd = 0; simd < 2; simd++) {
+			auto start = clock::now();
+			uint64_t sink = 0;
+			for (int r = 0; r < reps; r++) {
+				for (size_t col = 0; col < file.columns().size(); col++) {
+					if (file.columns()[col].width == 2) {
+						sink += summarizeColumn(file, col, simd).sum;
+						bytes += (simd == 0) ? file.rows() * 2 : 0;
+					}
+				}
+			}
+			t[simd] = std::chrono::duration<double>(clock::now() - start).count();
+			if (sink == 1) {
+				std::printf(" ");
+			}
+		}
+		std::printf("\nsummarize  scalar %8.1f MB/s, simd %8.1f MB/s\n",
+			bytes / t[0] / 1e6, bytes / t[1] / 1e6);
+	}
+	return 0;
+}
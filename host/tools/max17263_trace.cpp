@@ -0,0 +1,294 @@
+/*
+ * max17263_trace.cpp
+ *
+ * Created: 10/19/2026 7:46:39 AM
+ *
+ * Record, replay and list I2C transaction traces of the
+ * driver running in the simulator
+ *   max17263-trace record -o boot.trc -d 1
+ *   max17263-trace replay boot.trc -b 20
+ *   max17263-trace dump boot.trc -a 0x36
+ *   max17263-trace replay boot.trc -V boot.vcd -W 0:0.5
+ */ 
+
+#include "pack.h"
+#include "i2c_trace.h"
+
+extern "C" {
+#include "max17263.h"
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+
+static void usage(const char* prog) {
+	std::fprintf(stderr,
+		"usage: %s record -o FILE [-d DAYS] [-N BUSY] [-T US] [-s SEED] [-q] [-V VCD [-W FROM:TO]]\n"
+		"       %s replay FILE [-b RUNS] [-V VCD [-W FROM:TO]]\n"
+		"       %s dump FILE [-a ADDR]\n"
+		"  record  run one simulated pack against the gauge model and save its bus traffic\n"
+		"  replay  run the driver with the trace standing in for the gauge, fails on divergence\n"
+		"  dump    list transactions\n"
+		"  -d  simulated days, default 1\n"
+		"  -N  chance a gauge write leaves it busy (NACK), default 0\n"
+		"  -T  gauge holds SCL low for US after each ACK, default 0\n"
+		"  -q  no debug frames in the wake loop\n"
+		"  -b  replay RUNS times and report timing\n"
+		"  -a  only transactions to ADDR\n"
+		"  -V  write SCL/SDA/TWINT/TWSTO waveform as VCD\n"
+		"  -W  VCD window in seconds of virtual time, default 0:1\n", prog, prog, prog);
+}
+
+
+// VCD capture requested on the command line
+struct WaveArg {
+	std::string path;
+	double from_s = 0;
+	double to_s = 1;
+};
+
+
+static bool parseWindow(const char* arg, WaveArg& wave) {
+	return (std::sscanf(arg, "%lf:%lf", &wave.from_s, &wave.to_s) == 2) &&
+		(wave.from_s >= 0) && (wave.to_s > wave.from_s);
+}
+
+
+static bool openWave(const WaveArg& wave, VcdWriter& vcd) {
+	std::string error;
+	if (!vcd.open(wave.path, (uint64_t)(wave.from_s * 1e9), (uint64_t)(wave.to_s * 1e9), error)) {
+		std::fprintf(stderr, "%s\n", error.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+static PackConfig packConfig(const TraceHeader& h) {
+	PackConfig config;
+	config.wake_s = h.wake_s;
+	config.fscl = h.fscl;
+	config.retry = h.retry;
+	config.gauge.rsense = h.rsense;
+	config.gauge.capacity_mAh = h.capacity_mAh;
+	config.debug = h.debug;
+	config.gauge.stretch_us = h.stretch_us;
+	return config;
+}
+
+
+static int record(int argc, char** argv) {
+	
+	std::string path;
+	double days = 1;
+	PackConfig config;
+	WaveArg wave;
+	
+	int opt;
+	while ((opt = getopt(argc, argv, "o:d:N:T:s:qV:W:")) != -1) {
+		switch (opt) {
+			case 'o': path = optarg; break;
+			case 'd': days = std::strtod(optarg, nullptr); break;
+			case 'N': config.gauge.busy_nack = std::strtod(optarg, nullptr); break;
+			case 'T': config.gauge.stretch_us = (uint32_t)std::strtoul(optarg, nullptr, 10); break;
+			case 's': config.seed = (uint32_t)std::strtoul(optarg, nullptr, 10); break;
+			case 'q': config.debug = false; break;
+			case 'V': wave.path = optarg; break;
+			case 'W': if (!parseWindow(optarg, wave)) return 2; break;
+			default: return 2;
+		}
+	}
+	if (path.empty() || (days <= 0)) {
+		return 2;
+	}
+	VcdWriter vcd;
+	if (!wave.path.empty() && !openWave(wave, vcd)) {
+		return 1;
+	}
+	
+	Trace trace;
+	trace.header.wake_s = config.wake_s;
+	trace.header.fscl = config.fscl;
+	trace.header.retry = config.retry;
+	trace.header.rsense = config.gauge.rsense;
+	trace.header.capacity_mAh = (uint16_t)config.gauge.capacity_mAh;
+	trace.header.debug = config.debug;
+	trace.header.wakes = (uint32_t)(days * 86400.0 / config.wake_s);
+	trace.header.stretch_us = config.gauge.stretch_us;
+	
+	TraceRecorder recorder(trace);
+	Pack pack(0, config);
+	pack.record(&recorder);
+	pack.waveform(wave.path.empty() ? nullptr : &vcd);
+	pack.boot();
+	for (uint32_t w = 0; w < trace.header.wakes; w++) {
+		pack.wake();
+	}
+	TraceRecorder::detach();
+	
+	std::string error;
+	if (!trace.save(path, error)) {
+		std::fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+	std::printf("%s: %zu transactions, %u wakes\n", path.c_str(), trace.records.size(), trace.header.wakes);
+	if (!wave.path.empty()) {
+		std::printf("%s: %llu changes\n", wave.path.c_str(), (unsigned long long)vcd.changes());
+	}
+	return vcd.close() ? 0 : 1;
+}
+
+
+/***********************************************************
+ *
+ * Boot and wake as recorded with the trace as the only
+ * devices on the bus
+ *
+ ***********************************************************/
+static bool replayOnce(const Trace& trace, VcdWriter* vcd, std::string& why, size_t& position) {
+	Pack pack(0, packConfig(trace.header));
+	TraceReplay replay(trace);
+	replay.attach(pack.context().bus);
+	replay.setStretch(MAX17263_I2C_ADDR, trace.header.stretch_us);
+	pack.waveform(vcd);
+	pack.boot();
+	for (uint32_t w = 0; (w < trace.header.wakes) && !replay.diverged(); w++) {
+		pack.wake();
+	}
+	position = replay.position();
+	if (replay.diverged()) {
+		why = replay.divergence();
+		return false;
+	}
+	if (!replay.finished()) {
+		why = "driver stopped at transaction " + std::to_string(position);
+		return false;
+	}
+	return true;
+}
+
+
+static int replay(int argc, char** argv) {
+	
+	unsigned runs = 1;
+	WaveArg wave;
+	int opt;
+	while ((opt = getopt(argc, argv, "b:V:W:")) != -1) {
+		switch (opt) {
+			case 'b': runs = (unsigned)std::strtoul(optarg, nullptr, 10); break;
+			case 'V': wave.path = optarg; break;
+			case 'W': if (!parseWindow(optarg, wave)) return 2; break;
+			default: return 2;
+		}
+	}
+	if ((optind != argc - 1) || (runs == 0)) {
+		return 2;
+	}
+	
+	Trace trace;
+	std::string error;
+	if (!trace.load(argv[optind], error)) {
+		std::fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+	
+	// waveform from the first run only, timing runs stay clean
+	VcdWriter vcd;
+	if (!wave.path.empty() && !openWave(wave, vcd)) {
+		return 1;
+	}
+	
+	std::vector<double> times;
+	for (unsigned i = 0; i < runs; i++) {
+		size_t position;
+		auto t0 = std::chrono::steady_clock::now();
+		bool ok = replayOnce(trace, ((i == 0) && !wave.path.empty()) ? &vcd : nullptr, error, position);
+		times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+		if (!ok) {
+			std::printf("diverged, %s\n", error.c_str());
+			if (position < trace.records.size()) {
+				std::printf("  recorded: %s\n", traceFormat(trace.records[position]).c_str());
+			}
+			return 1;
+		}
+	}
+	
+	std::sort(times.begin(), times.end());
+	double median = times[times.size() / 2];
+	std::printf("replayed %zu transactions over %u wakes, matched\n", trace.records.size(), trace.header.wakes);
+	if (runs > 1) {
+		std::printf("%u runs: min %.3f ms, median %.3f ms, max %.3f ms, %.0f transactions/s\n", runs,
+			times.front() * 1e3, median * 1e3, times.back() * 1e3, trace.records.size() / median);
+	}
+	if (!wave.path.empty()) {
+		std::printf("%s: %llu changes\n", wave.path.c_str(), (unsigned long long)vcd.changes());
+	}
+	return vcd.close() ? 0 : 1;
+}
+
+
+static int dump(int argc, char** argv) {
+	
+	int addr = -1;
+	int opt;
+	while ((opt = getopt(argc, argv, "a:")) != -1) {
+		switch (opt) {
+			case 'a': addr = (int)std::strtol(optarg, nullptr, 0); break;
+			default: return 2;
+		}
+	}
+	if (optind != argc - 1) {
+		return 2;
+	}
+	
+	Trace trace;
+	std::string error;
+	if (!trace.load(argv[optind], error)) {
+		std::fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+	const TraceHeader& h = trace.header;
+	std::printf("# wake %us, scl %u Hz, retry %u/%u/%ums mask 0x%02X, rsense %u, %u mAh, debug %s, "
+		"%u wakes, stretch %uus\n", h.wake_s, h.fscl, h.retry.attempts, h.retry.backoff_ms,
+		h.retry.backoff_max_ms, h.retry.mask, h.rsense, h.capacity_mAh, h.debug ? "on" : "off",
+		h.wakes, h.stretch_us);
+	for (const TraceRecord& r : trace.records) {
+		if ((addr < 0) || (r.addr == addr)) {
+			std::printf("%s\n", traceFormat(r).c_str());
+		}
+	}
+	return 0;
+}
+
+
+int main(int argc, char** argv) {
+	
+	if (argc < 2) {
+		usage(argv[0]);
+		return 2;
+	}
+	
+	// subcommand options start after the subcommand
+	int rc = 2;
+	optind = 1;
+	if (std::strcmp(argv[1], "record") == 0) {
+		rc = record(argc - 1, argv + 1);
+	}
+	else if (std::strcmp(argv[1], "replay") == 0) {
+		rc = replay(argc - 1, argv + 1);
+	}
+	else if (std::strcmp(argv[1], "dump") == 0) {
+		rc = dump(argc - 1, argv + 1);
+	}
+	if (rc == 2) {
+		usage(argv[0]);
+	}
+	return rc;
+}
@@ -0,0 +1,279 @@
+// Debug stream parser, see debug_parser.h
+// Every read is checked against the frame length and every
+// label lookup against its table, any byte sequence is safe.
+
+#include "debug_parser.h"
+
+#define COUNT(a)  (sizeof(a) / sizeof((a)[0]))
+
+struct cursor_t {
+  const uint8_t* data;
+  uint8_t len;
+  uint8_t pos;
+};
+
+static const char* const struct_label[] = {
+  "DesignCap : ", "IchgTerm  : ", "Vempty\t  : ", "ModelCFG  : ",
+  "RepCap\t  : ", "RepSOC\t  : ", "TTE\t  : ", "RCOMP0\t  : ",
+  "TempCo\t  : ", "FullCapRep: ", "Cycles\t  : ", "FullCapNom: "
+};
+static const char* const eeprom_label[] = {
+  "RCOMP0\t  ", "TempCo\t  ", "FullCapRep", "Cycles\t  ",
+  "FullCapNom"
+};
+static const char* const gauge_label[] = {
+  "RepCap\t  : ", "RepSOC\t  : ", "TTE\t  : "
+};
+// max_debugSnapshot() order, registers 0x05 0x06 0x08 0x0A
+// 0x0B 0x10 0x11 0x17 0x19 0x09 0x20 (VCell is 0x09, 0x1A
+// is MaxMinTemp and not sent)
+static const char* const snapshot_label[] = {
+  "RepCap\t  : ", "RepSOC\t  : ", "Temp\t  : ", "Current\t  : ",
+  "AvgCurrent: ", "FullCapRep: ", "TTE\t  : ", "Cycles\t  : ",
+  "AvgVCell  : ", "VCell\t  : ", "TTF\t  : "
+};
+// Temp, Current and AvgCurrent are two's complement
+static const uint8_t snapshot_format[] = {
+  FIELD_HEX, FIELD_HEX, FIELD_SIGNED, FIELD_SIGNED,
+  FIELD_SIGNED, FIELD_HEX, FIELD_HEX, FIELD_HEX,
+  FIELD_HEX, FIELD_HEX, FIELD_HEX
+};
+static const char* const power_label[] = {
+  "TWI On\t  : ", "TWI Off\t  : ", "On Cyc\t  : ", "Off Cyc\t  : ",
+  "On Max\t  : ", "Off Max\t  : "
+};
+static const char* const i2c_stats_label[] = {
+  "Transmit  : ", "Receive\t  : ", "Bytes\t  : ", "SLA+W NACK: ",
+  "Data NACK : ", "SLA+R NACK: ", "Arb Lost  : ", "Bus Error : ",
+  "Timeouts  : ", "Retries\t  : ", "PEC Error : "
+};
+static const char* const latency_label[] = {
+  "<64us\t  : ", "<128us\t  : ", "<256us\t  : ", "<512us\t  : ",
+  "<1ms\t  : ", "<2ms\t  : ", "<4ms\t  : ", ">=4ms\t  : "
+};
+
+#define I2C_STATS_BYTES_FIELD   2   // only 32 bit field in I2C_STATS
+#define CLOCK_DIV_MAX           8   // clock_div_256
+#define CLOCK_BENCH_INVALID     0xFFFFFFFFUL  // Timer1 overflow lost, run rejected
+
+
+static uint8_t remaining(const cursor_t* c) {
+  return c->len - c->pos;
+}
+
+// Little endian word, false (and cursor at end) when fewer
+// than 2 bytes remain
+static bool read16(cursor_t* c, uint16_t* value) {
+  if (remaining(c) < 2) {
+    c->pos = c->len;
+    return false;
+  }
+  *value = c->data[c->pos] | (c->data[c->pos + 1] << 8);
+  c->pos += 2;
+  return true;
+}
+
+static bool read32(cursor_t* c, uint32_t* value) {
+  uint16_t lo = 0;
+  uint16_t hi = 0;
+  if (remaining(c) < 4) {
+    c->pos = c->len;
+    return false;
+  }
+  read16(c, &lo);
+  read16(c, &hi);
+  *value = lo | ((uint32_t)hi << 16);
+  return true;
+}
+
+// Rest of the frame as one word per label
+static uint8_t parse_words(cursor_t* c, const char* const* labels, uint8_t count,
+                           uint8_t format, const debug_output_t* out) {
+  uint16_t value;
+  for (uint8_t i = 0; remaining(c) > 0; i++) {
+    if (i >= count) {
+      c->pos = c->len;
+      return PARSE_EXCESS;
+    }
+    if (!read16(c, &value)) {
+      return PARSE_SHORT;
+    }
+    out->field(labels[i], value, format, "");
+  }
+  return PARSE_OK;
+}
+
+// Address/data word pairs
+static uint8_t parse_eeprom(cursor_t* c, const debug_output_t* out) {
+  uint16_t addr, value;
+  for (uint8_t i = 0; remaining(c) > 0; i++) {
+    if (i >= COUNT(eeprom_label)) {
+      c->pos = c->len;
+      return PARSE_EXCESS;
+    }
+    if (!read16(c, &addr) || !read16(c, &value)) {
+      return PARSE_SHORT;
+    }
+    out->field(eeprom_label[i], ((uint32_t)addr << 16) | value, FIELD_EEPROM, "");
+  }
+  return PARSE_OK;
+}
+
+// Stamp and span header, then one word per register
+static uint8_t parse_snapshot(cursor_t* c, const debug_output_t* out) {
+  uint32_t stamp;
+  uint16_t span, value;
+  if (!read32(c, &stamp) || !read16(c, &span)) {
+    return PARSE_SHORT;
+  }
+  out->field("Stamp\t  : ", stamp, FIELD_DEC, " ms");
+  out->field("Span\t  : ", span, FIELD_DEC, " us");
+  for (uint8_t i = 0; remaining(c) > 0; i++) {
+    if (i >= COUNT(snapshot_label)) {
+      c->pos = c->len;
+      return PARSE_EXCESS;
+    }
+    if (!read16(c, &value)) {
+      return PARSE_SHORT;
+    }
+    out->field(snapshot_label[i], value, snapshot_format[i], "");
+  }
+  return PARSE_OK;
+}
+
+static uint8_t parse_clock(cursor_t* c, const debug_output_t* out) {
+  uint16_t div;
+  uint32_t us, nJ;
+  if (!read16(c, &div) || !read32(c, &us) || !read32(c, &nJ)) {
+    return PARSE_SHORT;
+  }
+  if (div > CLOCK_DIV_MAX) {
+    return PARSE_RANGE;
+  }
+  out->field("F_CPU\t  : ", 8000000UL >> div, FIELD_DEC, " Hz");
+  if (us == CLOCK_BENCH_INVALID) {
+    out->heading("Timer1 overflow lost, run rejected");
+    return PARSE_OK;
+  }
+  out->field("Time\t  : ", us, FIELD_DEC, " us");
+  out->field("Energy est: ", nJ, FIELD_DEC, " nJ (table, not measured)");
+  return PARSE_OK;
+}
+
+static uint8_t parse_i2c_stats(cursor_t* c, const debug_output_t* out) {
+  for (uint8_t i = 0; remaining(c) > 0; i++) {
+    uint32_t value;
+    uint16_t word;
+    if (i >= COUNT(i2c_stats_label)) {
+      c->pos = c->len;
+      return PARSE_EXCESS;
+    }
+    if (i == I2C_STATS_BYTES_FIELD) {
+      if (!read32(c, &value)) {
+        return PARSE_SHORT;
+      }
+    }
+    else {
+      if (!read16(c, &word)) {
+        return PARSE_SHORT;
+      }
+      value = word;
+    }
+    out->field(i2c_stats_label[i], value, FIELD_DEC, "");
+  }
+  return PARSE_OK;
+}
+
+static uint8_t parse_latency(cursor_t* c, const debug_output_t* out) {
+  uint16_t type;
+  if (!read16(c, &type)) {
+    return PARSE_SHORT;
+  }
+  out->heading(type ? "\tI2C RECEIVE LATENCY\n" : "\tI2C TRANSMIT LATENCY\n");
+  return parse_words(c, latency_label, COUNT(latency_label), FIELD_DEC, out);
+}
+
+
+// Decode one frame, codes with a payload own the rest of
+// the frame, bare codes (startup, POR) may follow each other
+uint8_t debug_parse(const uint8_t* data, uint8_t len, const debug_output_t* out) {
+  cursor_t c = { data, len, 0 };
+  uint8_t flags = PARSE_OK;
+  uint16_t code;
+
+  while (remaining(&c) > 0) {
+
+    if (!read16(&c, &code)) {
+      flags |= PARSE_SHORT;
+      break;
+    }
+
+    switch (code) {
+
+      case MAX17263_STARTUP:
+        out->heading("Startup Sequence...");
+        break;
+
+      case MAX17263_STARTUP_DONE:
+        out->heading("Startup Sequence Complete");
+        break;
+
+      case MAX17263_POR:
+        out->heading("Power On Reset (POR) Detected...");
+        break;
+
+      case MAX17263_STRUCT:
+        out->heading("\tMAX17263 DATA STRUCT\n");
+        flags |= parse_words(&c, struct_label, COUNT(struct_label), FIELD_HEX_BIN, out);
+        break;
+
+      case MAX17263_EEPROM:
+        out->heading("\tEEPROM SAVED PARAMETERS\n");
+        flags |= parse_eeprom(&c, out);
+        break;
+
+      case MAX17263_EEPROM_INIT:
+        out->heading("No EEPROM Config Data...");
+        out->heading("Loading Config Data...");
+        out->heading("Starting Addr = [0x0002]");
+        break;
+
+      case MAX17263_FUEL_GAUGE:
+        out->heading("\tFUEL GAUGE READINGS\n");
+        flags |= parse_words(&c, gauge_label, COUNT(gauge_label), FIELD_HEX, out);
+        break;
+
+      case MAX17263_SNAPSHOT:
+        out->heading("\tTELEMETRY SNAPSHOT\n");
+        flags |= parse_snapshot(&c, out);
+        break;
+
+      case MAX17263_POWER:
+        out->heading("\tPOWER GATING\n");
+        flags |= parse_words(&c, power_label, COUNT(power_label), FIELD_DEC, out);
+        break;
+
+      case MAX17263_CLOCK_BENCH:
+        out->heading("\tCLOCK BENCHMARK\n");
+        flags |= parse_clock(&c, out);
+        break;
+
+      case MAX17263_I2C_STATS:
+        out->heading("\tI2C TRANSPORT\n");
+        flags |= parse_i2c_stats(&c, out);
+        break;
+
+      case MAX17263_I2C_LATENCY:
+        flags |= parse_latency(&c, out);
+        break;
+
+      default:
+        out->unknown(code);
+        flags |= PARSE_UNKNOWN;
+        break;
+    }
+
+    out->end();
+  }
+  return flags;
+}
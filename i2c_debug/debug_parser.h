@@ -0,0 +1,47 @@
+// Debug stream parser for frames sent by MDO_Battery_Module
+// to DEBUG_ADDR. No Arduino dependencies so the same source
+// builds on the host for fuzzing (host/fuzz).
+
+#ifndef DEBUG_PARSER_H_
+#define DEBUG_PARSER_H_
+
+#include <stdint.h>
+
+#define MAX17263_STARTUP        0xAAAA
+#define MAX17263_STARTUP_DONE   0xBBBB
+#define MAX17263_POR            0xCCCC
+#define MAX17263_STRUCT         0xDDDD
+#define MAX17263_EEPROM         0xEEEE
+#define MAX17263_EEPROM_INIT    0xAABB
+#define MAX17263_FUEL_GAUGE     0xCCDD
+#define MAX17263_SNAPSHOT       0xADAD
+#define MAX17263_POWER          0xDDEE
+#define MAX17263_CLOCK_BENCH    0xEEFF
+#define MAX17263_I2C_STATS      0xABAB
+#define MAX17263_I2C_LATENCY    0xACAC
+
+// Field value formats
+#define FIELD_HEX               0
+#define FIELD_HEX_BIN           1
+#define FIELD_DEC               2
+#define FIELD_EEPROM            3   // eeprom address << 16 | data
+#define FIELD_SIGNED            4   // int16_t in the low word
+
+// debug_parse() result flags, 0 for a well formed frame
+#define PARSE_OK                0x00
+#define PARSE_SHORT             0x01  // odd byte or section cut short
+#define PARSE_EXCESS            0x02  // more words than the section has fields
+#define PARSE_UNKNOWN           0x04  // unrecognised code
+#define PARSE_RANGE             0x08  // field value out of range
+
+// Decoded output, labels are static strings
+struct debug_output_t {
+  void (*heading)(const char* text);
+  void (*field)(const char* label, uint32_t value, uint8_t format, const char* unit);
+  void (*unknown)(uint16_t code);
+  void (*end)();                      // after each code
+};
+
+uint8_t debug_parse(const uint8_t* data, uint8_t len, const debug_output_t* out);
+
+#endif
@@ -1,23 +1,60 @@
 #include <Wire.h>
 
-#define MAX17263_STARTUP        0xAAAA
-#define MAX17263_STARTUP_DONE   0xBBBB
-#define MAX17263_POR            0xCCCC
-#define MAX17263_STRUCT         0xDDDD
-#define MAX17263_EEPROM         0xEEEE
-#define MAX17263_EEPROM_INIT	  0xAABB
-#define MAX17263_FUEL_GAUGE 	  0xCCDD
+#include "debug_parser.h"
+
+#define RECEIVER_STATUS         0xFEFE  // binary mode only, overflow counters
+
+// Serial rate, 9600 cannot keep up with telemetry bursts
+#define DEBUG_BAUD              115200
+
+// Forward frames undecoded for the host logger (host/)
+// 0x7E 0xA5 | millis (4, LSB first) | len | data | PEC
+// PEC is SMBus CRC-8 over millis, len and data
+#define BINARY_OUTPUT           false
+#define SYNC_0                  0x7E
+#define SYNC_1                  0xA5
+
+// Frame ring, filled in the Wire receive ISR and decoded
+// from loop(). Frames are bounded by the Wire buffer.
+#define FRAME_SIZE              32
+#define FRAME_COUNT             8
+
+struct frame_t {
+  uint32_t ms;
+  uint8_t len;
+  uint8_t data[FRAME_SIZE];
+};
+
+volatile frame_t frames[FRAME_COUNT];
+volatile uint8_t frame_head = 0;        // written by ISR only
+volatile uint8_t frame_tail = 0;        // written by loop() only
+volatile uint16_t frames_dropped = 0;   // ring full
+volatile uint16_t frames_truncated = 0; // longer than FRAME_SIZE
+uint16_t dropped_reported = 0;
+uint16_t truncated_reported = 0;
+
+// Serial printers for debug_parse()
+void print_heading(const char* text);
+void print_field(const char* label, uint32_t value, uint8_t format, const char* unit);
+void print_unknown(uint16_t code);
+void print_end();
+
+const debug_output_t serial_output = {
+  print_heading, print_field, print_unknown, print_end
+};
 
 
 
 void setup() {
   
-  Serial.begin(9600);
+  Serial.begin(DEBUG_BAUD);
   while (!Serial)
      delay(10);
-  Serial.println("------------------------------------");
-  Serial.println("\tMAX17263 I2C Debug");
-  Serial.println("------------------------------------\n");
+  if (!BINARY_OUTPUT) {
+    Serial.println("------------------------------------");
+    Serial.println("\tMAX17263 I2C Debug");
+    Serial.println("------------------------------------\n");
+  }
 
 
   Wire.begin(0x69);
@@ -26,111 +63,194 @@ void setup() {
 
 
 void loop() {
-  delay(100);
+  
+  while (frame_tail != frame_head) {
+    volatile frame_t* frame = &frames[frame_tail];
+    if (BINARY_OUTPUT) {
+      send_frame(frame->ms, frame->data, frame->len);
+    }
+    else {
+      decode_frame(frame->data, frame->len);
+    }
+    frame_tail = (frame_tail + 1) % FRAME_COUNT;
+  }
+
+  report_overflow();
 }
 
 
+// Receive ISR, copy only. Printing here holds the bus
+// (clock stretching) until the UART drains.
 void i2c_event(int len) {
-  uint8_t i = 0;
-  uint16_t code;
-  uint16_t buffer;
-  const char* struct_label[] = {
-    "DesignCap : ", "IchgTerm  : ", "Vempty\t  : ", "ModelCFG  : ",
-    "RepCap\t  : ", "RepSOC\t  : ", "TTE\t  : ", "RCOMP0\t  : ",
-    "TempCo\t  : ", "FullCapRep: ", "Cycles\t  : ", "FullCapNom: "
-  };
-  const char* eeprom_label[] = {
-    "RCOMP0\t  ", "TempCo\t  ", "FullCapRep", "Cycles\t  ", 
-    "FullCapNom"
-  };
-  const char* gauge_label[] = {
-    "RepCap\t  : ", "RepSOC\t  : ", "TTE\t  : "
-  };
-
-  Serial.println("Received " + String(len) + " bytes:\n");
+  uint8_t next = (frame_head + 1) % FRAME_COUNT;
   
-  while(Wire.available()) {
-    
-    code = Wire.read();
-    code |= (Wire.read() << 8);
-
-    //Serial.print("\tCode: ");
-    //Serial.println(code, HEX);
-    
-    switch(code) {
-
-      case MAX17263_STARTUP:
-        Serial.println("Startup Sequence...");
-        break;
-      
-      case MAX17263_STARTUP_DONE:
-        Serial.println("Startup Sequence Complete");
-        break;
-
-      case MAX17263_POR:
-        Serial.println("Power On Reset (POR) Detected...");
-        break;
-
-      case MAX17263_STRUCT:
-        Serial.println("\tMAX17263 DATA STRUCT\n");
-        while(Wire.available()) {
-          buffer = Wire.read();
-          buffer |= (Wire.read() << 8);
-          Serial.print(struct_label[i]);
-          Serial.print("\t");
-          Serial.print(buffer, HEX);
-          Serial.print("\t");
-          Serial.println(buffer, BIN);
-          i++;
-        }
-        break;
-
-      case MAX17263_EEPROM:
-        Serial.println("\tEEPROM SAVED PARAMETERS\n");
-        while(Wire.available()) {
-        
-          
-          // eeprom address sent first
-          Serial.print(eeprom_label[i]);
-          buffer = Wire.read();
-          buffer |= (Wire.read() << 8);
-          Serial.print(" [");
-          Serial.print(buffer, HEX);
-          Serial.print("]");
-
-          // eeprom data sent second
-          buffer = Wire.read();
-          buffer |= (Wire.read() << 8);
-          Serial.print("\t");
-          Serial.println(buffer, HEX);
-
-          i++;
-        }
-        break;
-
-      case MAX17263_EEPROM_INIT:
-        Serial.println("No EEPROM Config Data...");
-        Serial.println("Loading Config Data...");
-        Serial.println("Starting Addr = [0x0002]");
-        break;
-
-      case MAX17263_FUEL_GAUGE:
-        Serial.println("\tFUEL GAUGE READINGS\n");
-        while(Wire.available()) {
-          buffer = Wire.read();
-          buffer |= (Wire.read() << 8);
-          Serial.print(gauge_label[i]);
-          Serial.print("\t");
-          Serial.println(buffer, HEX);
-          i++;
-        }
-        break;
-
-      default:
-        Serial.print(code, HEX);
-        break;
+  if (next == frame_tail) {
+    frames_dropped++;
+    while (Wire.available()) {
+      Wire.read();
     }
+    return;
+  }
+
+  volatile frame_t* frame = &frames[frame_head];
+  uint8_t n = 0;
+  frame->ms = millis();
+  while (Wire.available()) {
+    int c = Wire.read();
+    if (n < FRAME_SIZE) {
+      frame->data[n++] = (uint8_t)c;
+    }
+  }
+  if (len > FRAME_SIZE) {
+    frames_truncated++;
+  }
+  frame->len = n;
+  frame_head = next;
+}
+
+
+// Print overflow counters when they change
+void report_overflow() {
+  uint16_t dropped;
+  uint16_t truncated;
 
+  noInterrupts();
+  dropped = frames_dropped;
+  truncated = frames_truncated;
+  interrupts();
+
+  if ((dropped != dropped_reported) || (truncated != truncated_reported)) {
+    if (BINARY_OUTPUT) {
+      uint8_t status[6] = {
+        RECEIVER_STATUS & 0xFF, RECEIVER_STATUS >> 8,
+        (uint8_t)dropped, (uint8_t)(dropped >> 8),
+        (uint8_t)truncated, (uint8_t)(truncated >> 8)
+      };
+      send_frame(millis(), status, 6);
+      dropped_reported = dropped;
+      truncated_reported = truncated;
+      return;
+    }
+    Serial.print("Frames dropped: ");
+    Serial.print(dropped);
+    Serial.print("\tTruncated: ");
+    Serial.println(truncated);
     Serial.println("\n------------------------------------\n");
+    dropped_reported = dropped;
+    truncated_reported = truncated;
+  }
+}
+
+
+// SMBus CRC-8, x^8 + x^2 + x + 1
+uint8_t crc8(uint8_t crc, uint8_t data) {
+  crc ^= data;
+  for (uint8_t b = 0; b < 8; b++) {
+    crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
   }
-}
\ No newline at end of file
+  return crc;
+}
+
+
+// Write one frame in binary framing
+void send_frame(uint32_t ms, const volatile uint8_t* data, uint8_t len) {
+  uint8_t header[5] = {
+    (uint8_t)ms, (uint8_t)(ms >> 8), (uint8_t)(ms >> 16), (uint8_t)(ms >> 24), len
+  };
+  uint8_t crc = 0;
+
+  Serial.write(SYNC_0);
+  Serial.write(SYNC_1);
+  for (uint8_t i = 0; i < 5; i++) {
+    Serial.write(header[i]);
+    crc = crc8(crc, header[i]);
+  }
+  for (uint8_t i = 0; i < len; i++) {
+    Serial.write(data[i]);
+    crc = crc8(crc, data[i]);
+  }
+  Serial.write(crc);
+}
+
+
+// Copy out of the ring before decoding, the parser takes
+// plain memory and bounds every read by len
+void decode_frame(const volatile uint8_t* data, uint8_t len) {
+  uint8_t buffer[FRAME_SIZE];
+  uint8_t flags;
+
+  if (len > FRAME_SIZE) {
+    len = FRAME_SIZE;
+  }
+  for (uint8_t i = 0; i < len; i++) {
+    buffer[i] = data[i];
+  }
+
+  Serial.println("Received " + String(len) + " bytes:\n");
+  flags = debug_parse(buffer, len, &serial_output);
+  if (flags & (PARSE_SHORT | PARSE_EXCESS | PARSE_RANGE)) {
+    Serial.print("Malformed frame: ");
+    Serial.println(flags, HEX);
+    Serial.println("\n------------------------------------\n");
+  }
+}
+
+
+void print_heading(const char* text) {
+  Serial.println(text);
+}
+
+
+void print_field(const char* label, uint32_t value, uint8_t format, const char* unit) {
+  switch (format) {
+
+    case FIELD_HEX_BIN:
+      Serial.print(label);
+      Serial.print("\t");
+      Serial.print(value, HEX);
+      Serial.print("\t");
+      Serial.println(value, BIN);
+      break;
+
+    case FIELD_EEPROM:
+      // eeprom address sent first, data second
+      Serial.print(label);
+      Serial.print(" [");
+      Serial.print(value >> 16, HEX);
+      Serial.print("]");
+      Serial.print("\t");
+      Serial.println(value & 0xFFFF, HEX);
+      break;
+
+    case FIELD_SIGNED:
+      Serial.print(label);
+      Serial.print("\t");
+      Serial.println((int16_t)value);
+      break;
+
+    case FIELD_HEX:
+      Serial.print(label);
+      Serial.print("\t");
+      Serial.println(value, HEX);
+      break;
+
+    default:
+      Serial.print(label);
+      if (unit[0] == '\0') {
+        Serial.print("\t");
+      }
+      Serial.print(value);
+      Serial.println(unit);
+      break;
+  }
+}
+
+
+void print_unknown(uint16_t code) {
+  Serial.print(code, HEX);
+}
+
+
+void print_end() {
+  Serial.println("\n------------------------------------\n");
+}